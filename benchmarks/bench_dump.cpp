@@ -0,0 +1,163 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/magic.hpp>
+
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/dump.hpp>
+
+#include <utility/memory_reader_writer.hpp>
+
+#include <chrono>
+#include <map>
+#include <string>
+
+// Dump throughput over an in-memory capture of many records, pretty and JSON, into a discarding sink
+
+struct Position {
+    int x, y, z;
+
+    REFL_BEGIN("Position", 1)
+        REFL_FIELD(x)
+        REFL_FIELD(y)
+        REFL_FIELD(z)
+    REFL_END
+};
+
+struct Event {
+    std::string name;
+    int id;
+    bool handled;
+    Position position;
+    std::string payload;
+
+    REFL_BEGIN("Event", 1)
+        REFL_FIELD(name)
+        REFL_FIELD(id)
+        REFL_FIELD(handled)
+        REFL_FIELD(position)
+        REFL_FIELD(payload)
+    REFL_END
+};
+
+class MemorySchemaProvider : public reflection::ISchemaProvider {
+public:
+    template <class C>
+    void add() {
+        auto fields = reflection::reflectFieldsStatic<C>();
+        utility::MemoryReaderWriter& schema = schemas[reflection::versionedNameOfClass<C>()];
+        serialization::InstanceSerializer<C>::serializeSchema(reflection::err, &schema,
+                reflection::versionedNameOfClass<C>(), fields);
+    }
+
+    virtual serialization::IReader* openClassSchemaOrNull(const char* className) override {
+        auto it = schemas.find(className);
+
+        if (it == schemas.end())
+            return nullptr;
+
+        opens++;
+        it->second.readPos = 0;
+        return &it->second;
+    }
+
+    virtual void closeClassSchema(serialization::IReader* reader) override {
+    }
+
+    std::map<std::string, utility::MemoryReaderWriter> schemas;
+    size_t opens = 0;
+};
+
+class NullTextSink : public reflection::ITextSink {
+public:
+    virtual bool flush(reflection::IErrorHandler* err, const char* text, size_t length) override {
+        bytes += length;
+        return true;
+    }
+
+    size_t bytes = 0;
+};
+
+static void measure(const char* name, utility::MemoryReaderWriter& capture, size_t count,
+        MemorySchemaProvider& sp, reflection::SchemaCache& cache, reflection::IDumpVisitor* visitor, NullTextSink& sink) {
+    sp.opens = 0;
+    sink.bytes = 0;
+    capture.readPos = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    reflection::Dumper dumper(visitor, &cache);
+
+    for (size_t i = 0; i < count; i++)
+        if (!dumper.dumpClass(&capture, "Event,1"))
+            return;
+
+    visitor->flush(reflection::err);
+
+    auto end = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(end - start).count();
+
+    printf("%-8s %8.2f MB/s in %8.2f MB/s out (%zu schema loads)\n", name,
+            capture.writePos / s * 1e-6, sink.bytes / s * 1e-6, sp.opens);
+}
+
+int main(int argc, char** argv) {
+    const size_t count = 200000;
+
+    MemorySchemaProvider sp;
+    sp.add<Position>();
+    sp.add<Event>();
+
+    utility::MemoryReaderWriter capture;
+
+    for (size_t i = 0; i < count; i++) {
+        Event event;
+        event.name = "input";
+        event.id = (int) i;
+        event.handled = (i % 3) == 0;
+        event.position = { (int) i, -(int) i, 42 };
+        event.payload = "key=value; other=\"quoted\"";
+
+        reflection::reflectSerialize(event, &capture);
+    }
+
+    // shared between both runs, so the second one doesn't load anything
+    reflection::SchemaCache cache(&sp);
+
+    NullTextSink sink;
+    char storage[reflection::DUMP_BUFFER_SIZE];
+    reflection::StringBuilder_t out(storage, sizeof(storage), &sink);
+
+    reflection::PrettyDumpVisitor pretty(out);
+    measure("pretty", capture, count, sp, cache, &pretty, sink);
+
+    reflection::JsonDumpVisitor json(out);
+    measure("json", capture, count, sp, cache, &json, sink);
+
+    return 0;
+}
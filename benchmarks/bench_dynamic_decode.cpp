@@ -0,0 +1,135 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/magic.hpp>
+
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/dynamic.hpp>
+#include <reflection/schema_bundle.hpp>
+
+#include <utility/memory_reader_writer.hpp>
+
+#include <chrono>
+#include <string>
+
+// Decoding throughput of DynamicDecoder against the compiled-in types, over an in-memory capture
+
+struct Position {
+    int x, y, z;
+
+    REFL_BEGIN("Position", 1)
+        REFL_FIELD(x)
+        REFL_FIELD(y)
+        REFL_FIELD(z)
+    REFL_END
+};
+
+struct Event {
+    std::string name;
+    int id;
+    bool handled;
+    Position position;
+    std::string payload;
+
+    REFL_BEGIN("Event", 1)
+        REFL_FIELD(name)
+        REFL_FIELD(id)
+        REFL_FIELD(handled)
+        REFL_FIELD(position)
+        REFL_FIELD(payload)
+    REFL_END
+};
+
+template <typename Func>
+static void measure(const char* name, utility::MemoryReaderWriter& capture, size_t count, Func func) {
+    capture.readPos = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < count; i++)
+        if (!func())
+            return;
+
+    auto end = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(end - start).count();
+
+    printf("%-8s %8.2f MB/s %8.2f M records/s\n", name, capture.writePos / s * 1e-6, count / s * 1e-6);
+}
+
+int main(int argc, char** argv) {
+    const size_t count = 500000;
+
+    utility::MemoryReaderWriter capture;
+
+    for (size_t i = 0; i < count; i++) {
+        Event event;
+        event.name = "input";
+        event.id = (int) i;
+        event.handled = (i % 3) == 0;
+        event.position = { (int) i, -(int) i, 42 };
+        event.payload = "key=value; other=\"quoted\"";
+
+        reflection::reflectSerialize(event, &capture);
+    }
+
+    reflection::reflectRegister<Position>();
+
+    // schemas come from a bundle, as they would for a tool that doesn't link the types
+    utility::MemoryReaderWriter bundleData;
+    reflection::writeSchemaBundle(&bundleData);
+
+    reflection::SchemaBundle bundle;
+    reflection::SchemaCache cache(&bundle);
+
+    if (!bundle.openMemory(bundleData.storage.buf, bundleData.writePos) || !bundle.preload(cache))
+        return -1;
+
+    Event event;
+    measure("native", capture, count, [&]() { return reflection::reflectDeserialize(event, &capture); });
+
+    reflection::DynamicDecoder decoder(&cache);
+    reflection::Arena arena;
+    reflection::DynamicValue_t value;
+
+    measure("dynamic", capture, count, [&]() {
+        arena.reset();
+        return decoder.decodeClass(&capture, "Event,1", arena, value);
+    });
+
+    // the last tree must re-encode to the last record
+    utility::MemoryReaderWriter reencoded;
+    reflection::encodeDynamicValue(&reencoded, value);
+
+    const size_t recordSize = reencoded.writePos;
+    const bool same = recordSize <= capture.writePos
+            && memcmp(reencoded.storage.buf, capture.storage.buf + capture.writePos - recordSize, recordSize) == 0;
+
+    printf("round trip: %s (id = %lld)\n", same ? "ok" : "MISMATCH",
+            (long long) value.objectValue->field(1).intValue);
+    return same ? 0 : -1;
+}
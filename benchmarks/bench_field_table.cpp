@@ -0,0 +1,160 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/magic.hpp>
+
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+
+#include <chrono>
+
+// Field access over a 5-level class hierarchy: flattened field table vs. walking the base class chain
+
+struct Level0 {
+    int a0, b0, c0, d0;
+
+    REFL_BEGIN("Level0", 1)
+        REFL_FIELD(a0)
+        REFL_FIELD(b0)
+        REFL_FIELD(c0)
+        REFL_FIELD(d0)
+    REFL_END
+};
+
+struct Level1 : Level0 {
+    int a1, b1, c1, d1;
+
+    REFL_BEGIN_EXTENDS("Level1", 1, Level0)
+        REFL_FIELD(a1)
+        REFL_FIELD(b1)
+        REFL_FIELD(c1)
+        REFL_FIELD(d1)
+    REFL_END
+};
+
+struct Level2 : Level1 {
+    int a2, b2, c2, d2;
+
+    REFL_BEGIN_EXTENDS("Level2", 1, Level1)
+        REFL_FIELD(a2)
+        REFL_FIELD(b2)
+        REFL_FIELD(c2)
+        REFL_FIELD(d2)
+    REFL_END
+};
+
+struct Level3 : Level2 {
+    int a3, b3, c3, d3;
+
+    REFL_BEGIN_EXTENDS("Level3", 1, Level2)
+        REFL_FIELD(a3)
+        REFL_FIELD(b3)
+        REFL_FIELD(c3)
+        REFL_FIELD(d3)
+    REFL_END
+};
+
+struct Level4 : Level3 {
+    int a4, b4, c4, d4;
+
+    REFL_BEGIN_EXTENDS("Level4", 1, Level3)
+        REFL_FIELD(a4)
+        REFL_FIELD(b4)
+        REFL_FIELD(c4)
+        REFL_FIELD(d4)
+    REFL_END
+};
+
+class NullWriter : public serialization::IWriter {
+public:
+    virtual bool write(reflection::IErrorHandler* err, const void* buffer, size_t count) override {
+        bytes += count;
+        return true;
+    }
+
+    size_t bytes = 0;
+};
+
+// what ReflectedFields::operator[] used to do for every access
+static void* chainWalk(const reflection::FieldSet_t* fieldSet, void* inst, size_t index) {
+    while (index >= fieldSet->numFields) {
+        index -= fieldSet->numFields;
+        inst = fieldSet->derivedPtrToBasePtr(inst);
+        fieldSet = fieldSet->baseClassFields;
+    }
+
+    return fieldSet->fields[index].fieldGetter(inst);
+}
+
+template <typename Func>
+static double measure(const char* name, size_t iterations, size_t numFields, Func func) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++)
+        func();
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+    printf("%-28s %8.2f ns/field\n", name, ns / (iterations * numFields));
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    const size_t iterations = 200000;
+
+    Level4 inst;
+    memset(&inst, 0, sizeof(inst));
+
+    auto fields = reflection::reflectFields(inst);
+    const size_t numFields = fields.count();
+    volatile intptr_t sink = 0;
+
+    measure("chain walk", iterations, numFields, [&]() {
+        for (size_t i = 0; i < numFields; i++)
+            sink += (intptr_t) chainWalk(fields.fieldSet, &inst, i);
+    });
+
+    measure("flattened table", iterations, numFields, [&]() {
+        auto fields = reflection::reflectFields(inst);
+
+        for (size_t i = 0; i < fields.count(); i++)
+            sink += (intptr_t) fields[i].ptr();
+    });
+
+    NullWriter writer;
+
+    measure("reflectSerialize", iterations, numFields, [&]() {
+        reflection::reflectSerialize(inst, &writer);
+    });
+
+    measure("reflectToString", iterations / 10, numFields, [&]() {
+        sink += reflection::reflectToString(inst).length();
+    });
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/magic.hpp>
+
+#include <reflection/basic_templates.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/numeric.hpp>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Number formatting and parsing throughput: libc vs. the kernels used by toString/setFromString
+
+template <typename T, typename Func>
+static void measure(const char* name, const std::vector<T>& values, Func func) {
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const T& value : values)
+        bytes += func(value);
+
+    auto end = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(end - start).count();
+
+    printf("%-32s %8.2f Mvalues/s %8.2f MB/s\n", name, values.size() / s * 1e-6, bytes / s * 1e-6);
+}
+
+int main(int argc, char** argv) {
+    const size_t count = 2000000;
+
+    std::mt19937_64 rng(1234);
+    std::vector<int64_t> ints(count);
+    std::vector<double> doubles(count);
+    std::vector<float> floats(count);
+
+    for (size_t i = 0; i < count; i++) {
+        // mix of magnitudes, as found in real data
+        ints[i] = (int64_t) (rng() >> (rng() % 64)) * ((i & 1) ? -1 : 1);
+        doubles[i] = std::uniform_real_distribution<double>(-1e6, 1e6)(rng);
+        floats[i] = (float) doubles[i];
+    }
+
+    char buf[64];
+
+    measure("int64 snprintf %lld", ints, [&](int64_t value) {
+        return (size_t) snprintf(buf, sizeof(buf), "%lld", (long long) value);
+    });
+
+    measure("int64 formatInteger", ints, [&](int64_t value) {
+        return reflection::formatInteger(buf, value);
+    });
+
+    measure("double snprintf %g (lossy)", doubles, [&](double value) {
+        return (size_t) snprintf(buf, sizeof(buf), "%g", value);
+    });
+
+    measure("double snprintf %.17g", doubles, [&](double value) {
+        return (size_t) snprintf(buf, sizeof(buf), "%.17g", value);
+    });
+
+    measure("double formatFloat", doubles, [&](double value) {
+        return reflection::formatFloat(buf, value);
+    });
+
+    measure("float snprintf %.9g", floats, [&](float value) {
+        return (size_t) snprintf(buf, sizeof(buf), "%.9g", (double) value);
+    });
+
+    measure("float formatFloat", floats, [&](float value) {
+        return reflection::formatFloat(buf, value);
+    });
+
+    // round-trip check on the same data
+    size_t mismatches = 0;
+
+    for (double value : doubles) {
+        buf[reflection::formatFloat(buf, value)] = 0;
+        mismatches += (strtod(buf, nullptr) != value);
+    }
+
+    for (float value : floats) {
+        buf[reflection::formatFloat(buf, value)] = 0;
+        mismatches += (strtof(buf, nullptr) != value);
+    }
+
+    printf("round-trip mismatches: %zu\n", mismatches);
+
+    // parsing, from pre-rendered text
+    std::vector<std::string> intStrings, doubleStrings;
+
+    for (size_t i = 0; i < count; i++) {
+        intStrings.emplace_back(buf, reflection::formatInteger(buf, ints[i]));
+        doubleStrings.emplace_back(buf, reflection::formatFloat(buf, doubles[i]));
+    }
+
+    volatile int64_t intSink = 0;
+    volatile double doubleSink = 0;
+
+    measure("int64 strtoll", intStrings, [&](const std::string& str) {
+        intSink = strtoll(str.c_str(), nullptr, 0);
+        return str.length();
+    });
+
+    measure("int64 parseInteger", intStrings, [&](const std::string& str) {
+        int64_t value;
+        reflection::parseInteger(str.c_str(), str.length(), value);
+        intSink = value;
+        return str.length();
+    });
+
+    measure("double strtod", doubleStrings, [&](const std::string& str) {
+        doubleSink = strtod(str.c_str(), nullptr);
+        return str.length();
+    });
+
+    measure("double parseFloat", doubleStrings, [&](const std::string& str) {
+        double value;
+        reflection::parseFloat(str.c_str(), str.length(), value);
+        doubleSink = value;
+        return str.length();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    size_t length = reflection::reflectToString(doubles).length();
+    auto end = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(end - start).count();
+
+    printf("%-32s %8.2f Mvalues/s %8.2f MB/s\n", "reflectToString(vector<double>)", count / s * 1e-6, length / s * 1e-6);
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <extras/record_query.hpp>
+
+#include <reflection/api.hpp>
+#include <reflection/magic.hpp>
+
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/schema_bundle.hpp>
+
+#include <utility/file_reader_writer.hpp>
+#include <utility/memory_reader_writer.hpp>
+
+#include <chrono>
+#include <string>
+
+// Query throughput (GB/s of record data) over an in-memory record file, by number of threads.
+// `bench_query <records> <bundle>` also writes the data set out, for trying reflector_query on it.
+
+struct Origin {
+    std::string host;
+    int port;
+
+    REFL_BEGIN("Origin", 1)
+        REFL_FIELD(host)
+        REFL_FIELD(port)
+    REFL_END
+};
+
+struct DataPacket {
+    std::string name;
+    int64_t length;
+    int priority;
+    double weight;
+    Origin origin;
+    std::string payload;
+
+    REFL_BEGIN("DataPacket", 1)
+        REFL_FIELD(name)
+        REFL_FIELD(length)
+        REFL_FIELD(priority)
+        REFL_FIELD(weight)
+        REFL_FIELD(origin)
+        REFL_FIELD(payload)
+    REFL_END
+};
+
+class NullTextSink : public reflection::ITextSink {
+public:
+    virtual bool flush(reflection::IErrorHandler* err, const char* text, size_t length) override {
+        bytes += length;
+        return true;
+    }
+
+    size_t bytes = 0;
+};
+
+static void measure(const char* name, reflection::SchemaCache& cache, const char* where, const char* select,
+        bool print, const utility::MemoryReaderWriter& records, size_t recordsOffset, unsigned numThreads) {
+    record_query::Query query;
+
+    if (!query.compile(cache, "DataPacket,1", where, select))
+        return;
+
+    NullTextSink sink;
+    record_query::QueryStats_t stats;
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!record_query::runQuery(query, (const uint8_t*) records.storage.buf, records.writePos, recordsOffset,
+            numThreads, print ? &sink : nullptr, stats))
+        return;
+
+    auto end = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(end - start).count();
+
+    printf("%-10s %2u threads %8.3f GB/s %10llu matches %10zu bytes out\n", name, numThreads,
+            stats.bytes / s * 1e-9, (unsigned long long) stats.matches, sink.bytes);
+}
+
+int main(int argc, char** argv) {
+    const size_t count = 2000000;
+
+    utility::MemoryReaderWriter records;
+    reflection::RecordFileWriter writer(&records);
+    writer.begin(reflection::versionedNameOfClass<DataPacket>(), reflection::reflectFingerprint<DataPacket>());
+
+    for (size_t i = 0; i < count; i++) {
+        DataPacket packet;
+        packet.name = (i % 7 == 0) ? "importantData" : "telemetry";
+        packet.length = (int64_t) ((i * 2654435761u) % 4096);
+        packet.priority = (int) (i % 5);
+        packet.weight = i * 0.25;
+        packet.origin = { "10.0.0.1", 8000 + (int) (i % 100) };
+        packet.payload = "lorem ipsum dolor sit amet, consectetur adipiscing elit";
+
+        writer.write(packet);
+    }
+
+    writer.finish();
+
+    utility::MemoryReaderWriter bundleData;
+    reflection::writeSchemaBundle(&bundleData);
+
+    if (argc >= 3) {
+        FILE* recordsFile = fopen(argv[1], "wb");
+        FILE* bundleFile = fopen(argv[2], "wb");
+
+        if (recordsFile == nullptr || bundleFile == nullptr)
+            return -1;
+
+        fwrite(records.storage.buf, 1, records.writePos, recordsFile);
+        fwrite(bundleData.storage.buf, 1, bundleData.writePos, bundleFile);
+        fclose(recordsFile);
+        fclose(bundleFile);
+    }
+
+    reflection::SchemaBundle bundle;
+    reflection::SchemaCache cache(&bundle);
+
+    if (!bundle.openMemory(bundleData.storage.buf, bundleData.writePos))
+        return -1;
+
+    reflection::BufString_t classId;
+    reflection::Fingerprint_t fingerprint;
+    size_t recordsOffset;
+
+    if (!reflection::readRecordFileHeader((const uint8_t*) records.storage.buf, records.writePos, classId,
+            fingerprint, recordsOffset))
+        return -1;
+
+    printf("%zu records, %.1f MB\n", count, records.writePos * 1e-6);
+
+    const unsigned maxThreads = std::thread::hardware_concurrency();
+
+    for (unsigned numThreads = 1; ; numThreads *= 2) {
+        if (numThreads > maxThreads)
+            numThreads = maxThreads;
+
+        // the first two fields decide; the rest of each record is jumped over
+        measure("count", cache, "length > 1000", "", false, records, recordsOffset, numThreads);
+        // decodes up to origin.port
+        measure("project", cache, "name == importantData && origin.port >= 8050", "name,length,origin.port", true,
+                records, recordsOffset, numThreads);
+
+        if (numThreads == maxThreads)
+            break;
+    }
+
+    return 0;
+}
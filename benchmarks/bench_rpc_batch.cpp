@@ -0,0 +1,216 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/rpc_async.hpp>
+
+#include <extras/rpc_pipeline.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Small calls over a socketpair: one round trip per call, pipelined calls, and batches.
+// Reports calls/s and write() syscalls per call on both sides.
+
+static std::atomic<size_t> numWrites(0);
+static size_t numHellos = 0;
+
+void sayHelloTo(const std::string& to) {
+    numHellos++;
+}
+
+BEGIN_RPC_TABLE(rpcTable)
+    RPC_TABLE_ENTRY("sayHelloTo", sayHelloTo)
+END_RPC_TABLE
+
+RPC_ASYNC(sayHelloToAsync, sayHelloTo)
+
+static bool writeAll(int fd, const uint8_t* data, size_t size) {
+    numWrites++;
+
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+
+        if (written <= 0)
+            return false;
+
+        data += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+static void serve(int fd) {
+    rpc_pipeline::FrameAssembler assembler;
+    utility::MemoryReaderWriter response;
+    uint8_t buffer[64 * 1024];
+
+    for (;;) {
+        ssize_t got = ::read(fd, buffer, sizeof(buffer));
+
+        if (got <= 0)
+            return;
+
+        assembler.append(buffer, got);
+
+        const uint8_t* frame;
+        size_t size;
+
+        // everything answerable from this read goes out in one write
+        response.reset();
+
+        while (assembler.next(frame, size)) {
+            if (!rpc_pipeline::dispatchRequestFrame<rpcTable>(frame, size, response))
+                return;
+        }
+
+        if (response.writePos > 0 && !writeAll(fd, (const uint8_t*) response.storage.buf, response.writePos))
+            return;
+    }
+}
+
+class SocketChannel : public rpc_pipeline::PipelinedRpcChannel {
+public:
+    explicit SocketChannel(int fd) : fd(fd), reader(&SocketChannel::receive, this) {}
+
+    ~SocketChannel() {
+        ::shutdown(fd, SHUT_RDWR);
+        reader.join();
+    }
+
+protected:
+    virtual bool sendFrame(const uint8_t* frame, size_t size) override {
+        return writeAll(fd, frame, size);
+    }
+
+private:
+    void receive() {
+        rpc_pipeline::FrameAssembler assembler;
+        uint8_t buffer[64 * 1024];
+
+        for (;;) {
+            ssize_t got = ::read(fd, buffer, sizeof(buffer));
+
+            if (got <= 0)
+                break;
+
+            assembler.append(buffer, got);
+
+            const uint8_t* frame;
+            size_t size;
+
+            while (assembler.next(frame, size))
+                receiveFrame(frame, size);
+        }
+
+        failPending();
+    }
+
+    int fd;
+    std::thread reader;
+};
+
+template <typename Func>
+static void measure(const char* name, size_t numCalls, Func func) {
+    numWrites = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    printf("%-20s %10.0f calls/s %8.3f writes/call\n", name, numCalls / seconds, double(numWrites) / numCalls);
+}
+
+int main(int argc, char** argv) {
+    int fds[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        return perror("socketpair"), -1;
+
+    std::thread server(serve, fds[1]);
+
+    const size_t numCalls = 20000;
+    const size_t batchSize = 32;
+    const std::string to = "me";
+
+    {
+        SocketChannel channel(fds[0]);
+
+        measure("round trip per call", numCalls, [&] {
+            for (size_t i = 0; i < numCalls; i++)
+                sayHelloToAsync(channel, to).get();
+        });
+
+        measure("pipelined", numCalls, [&] {
+            std::vector<std::future<void>> results;
+
+            for (size_t i = 0; i < numCalls; i++)
+                results.push_back(sayHelloToAsync(channel, to));
+
+            for (auto& result : results)
+                result.get();
+        });
+
+        char name[32];
+        snprintf(name, sizeof(name), "batches of %u", unsigned(batchSize));
+
+        measure(name, numCalls, [&] {
+            rpc_pipeline::RpcBatch batch;
+            std::vector<std::future<void>> results;
+
+            for (size_t i = 0; i < numCalls; i += batchSize) {
+                results.clear();
+
+                for (size_t j = i; j < i + batchSize && j < numCalls; j++)
+                    results.push_back(sayHelloToAsync(batch, to));
+
+                batch.send(channel);
+
+                for (auto& result : results)
+                    result.get();
+            }
+        });
+    }
+
+    server.join();
+    close(fds[0]);
+    close(fds[1]);
+
+    if (numHellos != 3 * numCalls)
+        return fprintf(stderr, "expected %u calls, got %u\n", unsigned(3 * numCalls), unsigned(numHellos)), -1;
+
+    return 0;
+}
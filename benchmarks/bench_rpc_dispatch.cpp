@@ -0,0 +1,129 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/rpc.hpp>
+
+#include <extras/basic_rpc_dispatcher.hpp>
+#include <utility/memory_reader_writer.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Dispatch cost over a 500-entry RPC table: indexed lookup by name and by method ID against the former
+// linear strcmp scan
+
+template <int N>
+int method(int x) {
+    return x + N;
+}
+
+#define ENTRY(n_)       RPC_TABLE_ENTRY("service.method" #n_, method<n_>)
+#define ENTRIES10(d_)   ENTRY(d_##0) ENTRY(d_##1) ENTRY(d_##2) ENTRY(d_##3) ENTRY(d_##4)\
+                        ENTRY(d_##5) ENTRY(d_##6) ENTRY(d_##7) ENTRY(d_##8) ENTRY(d_##9)
+#define ENTRIES100(h_)  ENTRIES10(h_##0) ENTRIES10(h_##1) ENTRIES10(h_##2) ENTRIES10(h_##3) ENTRIES10(h_##4)\
+                        ENTRIES10(h_##5) ENTRIES10(h_##6) ENTRIES10(h_##7) ENTRIES10(h_##8) ENTRIES10(h_##9)
+
+BEGIN_RPC_TABLE(rpcTable)
+    ENTRIES100(1)
+    ENTRIES100(2)
+    ENTRIES100(3)
+    ENTRIES100(4)
+    ENTRIES100(5)
+END_RPC_TABLE
+
+static const basic_rpc_dispatcher::RpcFunction_t* linearFind(const char* functionName) {
+    for (size_t i = 0; rpcTable[i].functionName != nullptr; i++) {
+        if (strcmp(rpcTable[i].functionName, functionName) == 0)
+            return &rpcTable[i];
+    }
+
+    return nullptr;
+}
+
+template <typename Call, typename Func>
+static void measure(const char* name, const std::vector<Call>& calls, size_t rounds, Func func) {
+    utility::MemoryReaderWriter io;
+    const int argument = 1;
+    reflection::reflectSerialize(argument, &io);
+
+    const size_t argumentSize = io.writePos;
+    long long checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t round = 0; round < rounds; round++) {
+        for (const auto& call : calls) {
+            io.readPos = 0;
+            io.writePos = argumentSize;
+
+            if (!func(call, &io))
+                return;
+
+            int result;
+            reflection::reflectDeserialize(result, &io);
+            checksum += result;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / (rounds * calls.size());
+
+    printf("%-8s %8.1f ns/call (checksum %lld)\n", name, ns, checksum);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> calls;
+
+    // every method once, in a scrambled order
+    for (int i = 0; i < 500; i++)
+        calls.push_back("service.method" + std::to_string(100 + (i * 7919) % 500));
+
+    const size_t rounds = 2000;
+
+    std::vector<rpc::RpcMethodId_t> methodIds;
+
+    for (const auto& call : calls)
+        methodIds.push_back(linearFind(call.c_str())->methodId);
+
+    measure("linear", calls, rounds, [](const std::string& functionName, utility::MemoryReaderWriter* io) {
+        const basic_rpc_dispatcher::RpcFunction_t* entry = linearFind(functionName.c_str());
+        return entry != nullptr && entry->callback(reflection::err, io, io);
+    });
+
+    measure("indexed", calls, rounds, [](const std::string& functionName, utility::MemoryReaderWriter* io) {
+        return basic_rpc_dispatcher::dispatch<rpcTable>(functionName.c_str(), io, io);
+    });
+
+    measure("by id", methodIds, rounds, [](rpc::RpcMethodId_t methodId, utility::MemoryReaderWriter* io) {
+        return basic_rpc_dispatcher::dispatch<rpcTable>(methodId, io, io);
+    });
+
+    return 0;
+}
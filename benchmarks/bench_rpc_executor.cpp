@@ -0,0 +1,147 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/rpc_async.hpp>
+
+#include <extras/rpc_executor.hpp>
+
+#include <chrono>
+
+// Pipelined calls against a single-threaded server and against the work-stealing executor:
+// CPU-heavy handlers spread over the workers, light ones run inline on the I/O thread.
+// `bench_rpc_executor [workers]`
+
+uint64_t heavy(uint64_t seed) {
+    // some tens of microseconds of arithmetic
+    for (int i = 0; i < 20000; i++)
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return seed;
+}
+
+int light(int x) {
+    return x + 1;
+}
+
+BEGIN_RPC_TABLE(rpcTable)
+    RPC_TABLE_ENTRY("heavy",        heavy)
+    RPC_TABLE_ENTRY_INLINE("light", light)
+END_RPC_TABLE
+
+BEGIN_RPC_TABLE(pooledTable)
+    RPC_TABLE_ENTRY("heavy",        heavy)
+    RPC_TABLE_ENTRY("light",        light)
+END_RPC_TABLE
+
+RPC_ASYNC(heavyAsync, heavy)
+RPC_ASYNC(lightAsync, light)
+
+template <typename Result, typename Call>
+static double callsPerSecond(const char* address, size_t numCalls, size_t window, Call call) {
+    rpc_socket::AsyncSocketRpcChannel channel;
+
+    if (!channel.connect(address))
+        return 0;
+
+    std::vector<std::future<Result>> inFlight(window);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < numCalls + window; i++) {
+        std::future<Result>& slot = inFlight[i % window];
+
+        if (slot.valid())
+            slot.get();
+
+        if (i < numCalls)
+            slot = call(channel, i);
+    }
+
+    return numCalls / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void measure(const char* name, rpc_socket::RpcServer& server, size_t numHeavy, size_t numLight) {
+    std::thread serverThread([&server] { server.run(); });
+
+    const double heavyRate = callsPerSecond<uint64_t>(server.address(), numHeavy, 64,
+            [](rpc::IAsyncRpcChannel& channel, size_t i) { return heavyAsync(channel, i); });
+
+    const double lightRate = callsPerSecond<int>(server.address(), numLight, 64,
+            [](rpc::IAsyncRpcChannel& channel, size_t i) { return lightAsync(channel, (int) i); });
+
+    printf("%-28s heavy %8.0f calls/s   light %8.0f calls/s\n", name, heavyRate, lightRate);
+
+    server.stop();
+    serverThread.join();
+}
+
+int main(int argc, char** argv) {
+    rpc_executor::PoolOptions_t options;
+    options.numWorkers = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 0;
+
+    char address[64];
+    snprintf(address, sizeof(address), "unix:/tmp/bench_rpc_executor.%d", (int) getpid());
+
+    const size_t numHeavy = 20000, numLight = 100000;
+
+    {
+        rpc_socket::RpcServer server(&rpc_pipeline::dispatchRequestFrame<rpcTable>);
+
+        if (!server.listen(address))
+            return -1;
+
+        measure("single-threaded", server, numHeavy, numLight);
+    }
+
+    {
+        rpc_executor::RpcExecutor<pooledTable> executor(options);
+        rpc_socket::RpcServer server(&executor);
+
+        if (!server.listen(address))
+            return -1;
+
+        char name[64];
+        snprintf(name, sizeof(name), "%u workers", unsigned(executor.getPool().numWorkers()));
+        measure(name, server, numHeavy, numLight);
+    }
+
+    {
+        rpc_executor::RpcExecutor<rpcTable> executor(options);
+        rpc_socket::RpcServer server(&executor);
+
+        if (!server.listen(address))
+            return -1;
+
+        char name[64];
+        snprintf(name, sizeof(name), "%u workers, light inline", unsigned(executor.getPool().numWorkers()));
+        measure(name, server, numHeavy, numLight);
+    }
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+
+#include <extras/rpc_http.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+// JSON-RPC over HTTP on loopback TCP: requests per second for concurrent keep-alive connections,
+// each keeping a window of pipelined requests in flight.
+
+struct Point_t {
+    int x, y;
+
+    REFL_BEGIN("Point_t", 1)
+        REFL_FIELD(x)
+        REFL_FIELD(y)
+    REFL_END
+};
+
+int add(int a, int b) {
+    return a + b;
+}
+
+Point_t translate(const Point_t& p, int dx, int dy) {
+    return Point_t { p.x + dx, p.y + dy };
+}
+
+BEGIN_JSON_RPC_TABLE(jsonTable)
+    JSON_RPC_TABLE_ENTRY("add",       add)
+    JSON_RPC_TABLE_ENTRY("translate", translate)
+END_JSON_RPC_TABLE
+
+typedef std::chrono::steady_clock Clock_t;
+
+// sends numRequests copies of request, up to window at a time; returns the number of responses
+static size_t runClient(const char* address, const std::string& request, size_t numRequests, size_t window) {
+    reflection::IErrorHandler* err = reflection::err;
+    int fd = rpc_socket::connectTo(err, address);
+
+    if (fd < 0)
+        return 0;
+
+    std::string pending;
+    std::vector<char> input;
+    size_t sent = 0, received = 0;
+
+    while (received < numRequests) {
+        pending.clear();
+
+        for (; sent < numRequests && sent - received < window; sent++)
+            pending += request;
+
+        iovec iov = { (void*) pending.data(), pending.size() };
+
+        if (!pending.empty() && !rpc_socket::writeAll(err, fd, &iov, 1))
+            break;
+
+        char buffer[64 * 1024];
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+
+        if (got <= 0)
+            break;
+
+        input.insert(input.end(), buffer, buffer + got);
+
+        // count complete responses
+        size_t pos = 0;
+
+        for (;;) {
+            const char* head = input.data() + pos;
+            const char* headerEnd = (const char*) memmem(head, input.size() - pos, "\r\n\r\n", 4);
+
+            if (headerEnd == nullptr)
+                break;
+
+            const char* lengthHeader = (const char*) memmem(head, headerEnd - head, "Content-Length: ", 16);
+            const size_t contentLength = lengthHeader ? strtoul(lengthHeader + 16, nullptr, 10) : 0;
+            const size_t total = (headerEnd + 4 - head) + contentLength;
+
+            if (input.size() - pos < total)
+                break;
+
+            pos += total;
+            received++;
+        }
+
+        input.erase(input.begin(), input.begin() + pos);
+    }
+
+    close(fd);
+    return received;
+}
+
+static void bench(const char* address, const char* name, const char* body, size_t callsPerRequest,
+        size_t numConnections, size_t window, size_t numRequests) {
+    char head[128];
+    snprintf(head, sizeof(head), "POST /rpc HTTP/1.1\r\nHost: bench\r\nContent-Length: %u\r\n\r\n", unsigned(strlen(body)));
+    const std::string request = std::string(head) + body;
+
+    std::vector<std::thread> clients;
+    std::vector<size_t> received(numConnections);
+
+    auto start = Clock_t::now();
+
+    for (size_t i = 0; i < numConnections; i++)
+        clients.emplace_back([&, i] { received[i] = runClient(address, request, numRequests / numConnections, window); });
+
+    size_t total = 0;
+
+    for (size_t i = 0; i < numConnections; i++) {
+        clients[i].join();
+        total += received[i];
+    }
+
+    double seconds = std::chrono::duration<double>(Clock_t::now() - start).count();
+
+    printf("  %-10s %3u connections, window %3u   %9.0f requests/s  %9.0f calls/s\n", name, unsigned(numConnections),
+            unsigned(window), total / seconds, total * callsPerRequest / seconds);
+}
+
+int main(int argc, char** argv) {
+    const size_t numRequests = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 100000;
+
+    rpc_http::JsonRpcHttpProtocol protocol(jsonTable);
+    rpc_socket::RpcServer server(&protocol);
+
+    if (!server.listen("tcp:127.0.0.1:0"))
+        return -1;
+
+    std::thread serverThread([&server] { server.run(); });
+    const char* address = server.address();
+    printf("%s\n", address);
+
+    const char* addBody = R"({"jsonrpc":"2.0","method":"add","params":[1,2],"id":1})";
+    const char* translateBody = R"({"jsonrpc":"2.0","method":"translate","params":[{"x":1,"y":2},3,4],"id":"t"})";
+
+    std::string batchBody = "[";
+
+    for (int i = 0; i < 16; i++)
+        batchBody += std::string(i > 0 ? "," : "") + addBody;
+
+    batchBody += "]";
+
+    bench(address, "add", addBody, 1, 1, 1, numRequests / 4);
+    bench(address, "add", addBody, 1, 1, 32, numRequests);
+    bench(address, "add", addBody, 1, 16, 1, numRequests);
+    bench(address, "add", addBody, 1, 16, 32, numRequests);
+    bench(address, "translate", translateBody, 1, 16, 32, numRequests);
+    bench(address, "batch x16", batchBody.c_str(), 16, 16, 8, numRequests / 16);
+
+    server.stop();
+    serverThread.join();
+    return 0;
+}
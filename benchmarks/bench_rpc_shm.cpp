@@ -0,0 +1,147 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/rpc.hpp>
+
+#include <extras/rpc_shm.hpp>
+#include <extras/rpc_socket.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include <sys/wait.h>
+
+// Round-trip latency of plain RPC_SERIALIZED calls to a server in another process,
+// over the shared-memory rings and over a Unix domain socket.
+// The busy-polling numbers need the client and the server on different cores.
+
+int add(int a, int b) {
+    return a + b;
+}
+
+BEGIN_RPC_TABLE(rpcTable)
+    RPC_TABLE_ENTRY("add", add)
+END_RPC_TABLE
+
+RPC_SERIALIZED(addRPC, add)
+
+static rpc::IRpcChannel* currentChannel;
+
+DEFINE_RPC_GLOBAL_CHANNEL(*currentChannel)
+
+typedef std::chrono::steady_clock Clock_t;
+
+static void benchLatency(const char* name, rpc::IRpcChannel& channel, size_t numCalls) {
+    currentChannel = &channel;
+
+    // warm up
+    for (size_t i = 0; i < 1000; i++)
+        addRPC(0, 0);
+
+    std::vector<double> latencies;
+    latencies.reserve(numCalls);
+    long long checksum = 0;
+
+    auto start = Clock_t::now();
+
+    for (size_t i = 0; i < numCalls; i++) {
+        auto callStart = Clock_t::now();
+        checksum += addRPC((int) i, 1);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock_t::now() - callStart).count());
+    }
+
+    double seconds = std::chrono::duration<double>(Clock_t::now() - start).count();
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("  %-14s %9.0f calls/s   p50 %6.2f us   p99 %6.2f us   (checksum %lld)\n", name, numCalls / seconds,
+            latencies[numCalls / 2], latencies[numCalls * 99 / 100], checksum);
+}
+
+// serves both transports until killed
+static void runServer(const char* shmName, const char* unixAddress, int readyFd) {
+    rpc_shm::ShmRpcServer shmServer(&rpc_pipeline::dispatchRequestFrame<rpcTable>);
+    rpc_socket::RpcServer socketServer(&rpc_pipeline::dispatchRequestFrame<rpcTable>);
+
+    if (!shmServer.create(shmName) || !socketServer.listen(unixAddress))
+        _exit(1);
+
+    std::thread socketThread([&socketServer] { socketServer.run(); });
+
+    char ready = 1;
+    if (write(readyFd, &ready, 1) != 1)
+        _exit(1);
+
+    shmServer.run();
+    _exit(0);
+}
+
+int main(int argc, char** argv) {
+    const size_t numCalls = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+
+    char shmName[64], unixPath[64], unixAddress[80];
+    snprintf(shmName, sizeof(shmName), "/bench_rpc_shm.%d", (int) getpid());
+    snprintf(unixPath, sizeof(unixPath), "/tmp/bench_rpc_shm.%d", (int) getpid());
+    snprintf(unixAddress, sizeof(unixAddress), "unix:%s", unixPath);
+
+    int readyPipe[2];
+
+    if (pipe(readyPipe) != 0)
+        return -1;
+
+    const pid_t server = fork();
+
+    if (server < 0)
+        return -1;
+
+    if (server == 0)
+        runServer(shmName, unixAddress, readyPipe[1]);
+
+    char ready;
+
+    if (read(readyPipe[0], &ready, 1) != 1)
+        return -1;
+
+    {
+        rpc_shm::ShmRpcChannel shmChannel;
+        rpc_socket::SocketRpcChannel socketChannel;
+
+        if (shmChannel.connect(shmName) && socketChannel.connect(unixAddress)) {
+            benchLatency("shared memory", shmChannel, numCalls);
+            benchLatency("unix socket", socketChannel, numCalls / 4);
+        }
+    }
+
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+
+    shm_unlink(shmName);
+    unlink(unixPath);
+    return 0;
+}
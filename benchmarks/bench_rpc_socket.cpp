@@ -0,0 +1,205 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/rpc_async.hpp>
+
+#include <extras/rpc_socket.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// Socket transport over Unix domain sockets and loopback TCP:
+// latency of blocking calls, throughput of pipelined calls and of batches, and bulk transfer.
+
+int add(int a, int b) {
+    return a + b;
+}
+
+std::string echo(const std::string& data) {
+    return data;
+}
+
+BEGIN_RPC_TABLE(rpcTable)
+    RPC_TABLE_ENTRY("add",  add)
+    RPC_TABLE_ENTRY("echo", echo)
+END_RPC_TABLE
+
+RPC_CHANNEL(addRPC, add)
+RPC_ASYNC(addAsync, add)
+RPC_ASYNC(echoAsync, echo)
+
+typedef std::chrono::steady_clock Clock_t;
+
+static double secondsSince(Clock_t::time_point start) {
+    return std::chrono::duration<double>(Clock_t::now() - start).count();
+}
+
+static void benchLatency(const char* address, size_t numCalls) {
+    rpc_socket::SocketRpcChannel channel;
+
+    if (!channel.connect(address))
+        return;
+
+    std::vector<double> latencies;
+    latencies.reserve(numCalls);
+    long long checksum = 0;
+
+    auto start = Clock_t::now();
+
+    for (size_t i = 0; i < numCalls; i++) {
+        auto callStart = Clock_t::now();
+        checksum += addRPC(channel, (int) i, 1);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock_t::now() - callStart).count());
+    }
+
+    double seconds = secondsSince(start);
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("  blocking         %9.0f calls/s   p50 %6.1f us   p99 %6.1f us   (checksum %lld)\n", numCalls / seconds,
+            latencies[numCalls / 2], latencies[numCalls * 99 / 100], checksum);
+}
+
+// keeps up to `window` calls in flight
+static void benchPipelined(const char* address, size_t numCalls, size_t window) {
+    rpc_socket::AsyncSocketRpcChannel channel;
+
+    if (!channel.connect(address))
+        return;
+
+    std::vector<std::future<int>> inFlight(window);
+    long long checksum = 0;
+
+    auto start = Clock_t::now();
+
+    for (size_t i = 0; i < numCalls + window; i++) {
+        std::future<int>& slot = inFlight[i % window];
+
+        if (slot.valid())
+            checksum += slot.get();
+
+        if (i < numCalls)
+            slot = addAsync(channel, (int) i, 1);
+    }
+
+    double seconds = secondsSince(start);
+
+    printf("  pipelined (%3u)  %9.0f calls/s                               (checksum %lld)\n", unsigned(window),
+            numCalls / seconds, checksum);
+}
+
+static void benchBatched(const char* address, size_t numCalls, size_t batchSize) {
+    rpc_socket::AsyncSocketRpcChannel channel;
+
+    if (!channel.connect(address))
+        return;
+
+    rpc_pipeline::RpcBatch batch;
+    std::vector<std::future<int>> previous, current;
+    long long checksum = 0;
+
+    auto start = Clock_t::now();
+
+    // two batches in flight: the next one is built while the previous one is answered
+    for (size_t i = 0; i < numCalls; i += batchSize) {
+        for (size_t j = i; j < i + batchSize && j < numCalls; j++)
+            current.push_back(addAsync(batch, (int) j, 1));
+
+        batch.send(channel);
+
+        for (auto& result : previous)
+            checksum += result.get();
+
+        previous.swap(current);
+        current.clear();
+    }
+
+    for (auto& result : previous)
+        checksum += result.get();
+
+    double seconds = secondsSince(start);
+
+    printf("  batches of %3u   %9.0f calls/s                               (checksum %lld)\n", unsigned(batchSize),
+            numCalls / seconds, checksum);
+}
+
+static void benchBulk(const char* address, size_t numCalls, size_t size, size_t window) {
+    rpc_socket::AsyncSocketRpcChannel channel;
+
+    if (!channel.connect(address))
+        return;
+
+    const std::string data(size, 'x');
+    std::vector<std::future<std::string>> inFlight(window);
+    size_t received = 0;
+
+    auto start = Clock_t::now();
+
+    for (size_t i = 0; i < numCalls + window; i++) {
+        std::future<std::string>& slot = inFlight[i % window];
+
+        if (slot.valid())
+            received += slot.get().size();
+
+        if (i < numCalls)
+            slot = echoAsync(channel, data);
+    }
+
+    double seconds = secondsSince(start);
+
+    printf("  echo %5u B      %9.1f MB/s each way\n", unsigned(size), received / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    const size_t numCalls = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 50000;
+
+    char unixAddress[64];
+    snprintf(unixAddress, sizeof(unixAddress), "unix:/tmp/bench_rpc_socket.%d", (int) getpid());
+
+    rpc_socket::RpcServer server(&rpc_pipeline::dispatchRequestFrame<rpcTable>);
+
+    if (!server.listen(unixAddress) || !server.listen("tcp:127.0.0.1:0"))
+        return -1;
+
+    std::thread serverThread([&server] { server.run(); });
+
+    for (size_t i = 0; i < 2; i++) {
+        const char* address = server.address(i);
+        printf("%s\n", address);
+
+        benchLatency(address, numCalls);
+        benchPipelined(address, numCalls, 64);
+        benchBatched(address, numCalls, 64);
+        benchBulk(address, numCalls / 10, 16 * 1024, 16);
+    }
+
+    server.stop();
+    serverThread.join();
+    return 0;
+}
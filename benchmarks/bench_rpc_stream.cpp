@@ -0,0 +1,187 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_templates.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/rpc_async.hpp>
+#include <reflection/rpc_stream.hpp>
+
+#include <extras/rpc_executor.hpp>
+
+#include <chrono>
+#include <string>
+
+#include <sys/resource.h>
+
+// A large result set over a Unix socket, returned as one std::vector and streamed row by row (through
+// an iterator and through a callback): time to the first row, throughput, and peak memory of the
+// process, which holds both ends. Streams run first, since the peak only ever grows.
+// `bench_rpc_stream [rows]`
+
+static std::atomic<size_t> rowsProduced(0);
+
+static std::string makeRow(int id) {
+    char row[64];
+    snprintf(row, sizeof(row), "%d,row #%d,%.1f", id, id, id * 0.5);
+    return row;
+}
+
+std::vector<std::string> scanAll(int count) {
+    std::vector<std::string> rows;
+
+    for (int i = 0; i < count; i++)
+        rows.push_back(makeRow(i));
+
+    rowsProduced += count;
+    return rows;
+}
+
+void scan(rpc::RpcStreamWriter<std::string>& out, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!out.write(makeRow(i)))
+            return;
+
+        rowsProduced++;
+    }
+}
+
+BEGIN_RPC_TABLE(rpcTable)
+    RPC_TABLE_ENTRY("scanAll",      scanAll)
+    RPC_STREAM_TABLE_ENTRY("scan",  scan)
+END_RPC_TABLE
+
+RPC_ASYNC(scanAllAsync, scanAll)
+RPC_STREAM(scanStream, scan)
+RPC_STREAM_CALLBACK(scanEach, scan)
+
+typedef std::chrono::steady_clock Clock_t;
+
+static double millisecondsSince(Clock_t::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock_t::now() - start).count();
+}
+
+static long peakRssMiB() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+static void report(const char* name, size_t rows, double firstMs, double totalMs) {
+    printf("%-20s %8u rows   first row %9.3f ms   total %8.1f ms   %10.0f rows/s   peak RSS %5ld MiB\n", name,
+            unsigned(rows), firstMs, totalMs, rows / (totalMs / 1000), peakRssMiB());
+}
+
+int main(int argc, char** argv) {
+    const int numRows = (argc > 1) ? atoi(argv[1]) : 1000000;
+
+    char address[64];
+    snprintf(address, sizeof(address), "unix:/tmp/bench_rpc_stream.%d", (int) getpid());
+
+    rpc_executor::RpcExecutor<rpcTable> executor;
+    rpc_socket::RpcServer server(&executor);
+
+    if (!server.listen(address))
+        return -1;
+
+    std::thread serverThread([&server] { server.run(); });
+
+    rpc_socket::AsyncSocketRpcChannel channel;
+
+    if (!channel.connect(server.address()))
+        return -1;
+
+    printf("stream window %u KiB\n", unsigned(channel.streamWindow / 1024));
+
+    {
+        auto start = Clock_t::now();
+        double firstMs = 0;
+        size_t rows = 0;
+
+        rpc::RpcStreamReader<std::string> reader = scanStream(channel, numRows);
+
+        for (const std::string& row : reader) {
+            if (rows++ == 0)
+                firstMs = millisecondsSince(start);
+
+            (void) row;
+        }
+
+        if (!reader.ok())
+            return printf("stream failed\n"), -1;
+
+        report("stream (iterator)", rows, firstMs, millisecondsSince(start));
+    }
+
+    {
+        auto start = Clock_t::now();
+        double firstMs = 0;
+        size_t rows = 0;
+        std::promise<bool> done;
+
+        scanEach(channel, [&](std::string&& row) {
+            if (rows++ == 0)
+                firstMs = millisecondsSince(start);
+
+            return true;
+        }, [&](bool ok) { done.set_value(ok); }, numRows);
+
+        if (!done.get_future().get())
+            return printf("stream failed\n"), -1;
+
+        report("stream (callback)", rows, firstMs, millisecondsSince(start));
+    }
+
+    {
+        // the consumer stops early; the server stops within a window of it
+        rowsProduced = 0;
+        size_t rows = 0;
+
+        rpc::RpcStreamReader<std::string> reader = scanStream(channel, numRows);
+        std::string row;
+
+        while (rows < 1000 && reader.next(row))
+            rows++;
+
+        reader.close();
+        executor.getPool().waitIdle();
+
+        printf("%-20s %8u rows read, %u produced\n", "stream (cancelled)", unsigned(rows), unsigned(rowsProduced));
+    }
+
+    {
+        auto start = Clock_t::now();
+        const std::vector<std::string> rows = scanAllAsync(channel, numRows).get();
+        const double totalMs = millisecondsSince(start);
+
+        report("std::vector", rows.size(), totalMs, totalMs);
+    }
+
+    channel.disconnect();
+    server.stop();
+    serverThread.join();
+    return 0;
+}
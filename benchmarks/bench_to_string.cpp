@@ -0,0 +1,142 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/magic.hpp>
+
+#include <reflection/basic_templates.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+
+#include <chrono>
+#include <vector>
+
+// reflectToString over growing vectors: time per element should stay flat as the size goes up.
+// Then a small struct, as printed in logging paths, through each of the output variants.
+
+struct LogRecord {
+    int id;
+    float value;
+    std::string tag;
+
+    REFL_BEGIN("LogRecord", 1)
+        REFL_FIELD(id)
+        REFL_FIELD(value)
+        REFL_FIELD(tag)
+    REFL_END
+};
+
+class NullWriter : public serialization::IWriter {
+public:
+    virtual bool write(reflection::IErrorHandler* err, const void* buffer, size_t count) override {
+        bytes += count;
+        return true;
+    }
+
+    size_t bytes = 0;
+};
+
+template <typename Func>
+static void measureRecord(const char* name, size_t iterations, Func func) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++)
+        func();
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+    printf("%-28s %8.2f ns/record\n", name, ns / iterations);
+}
+
+template <typename T>
+static void measure(const char* name, const std::vector<T>& values, size_t iterations) {
+    size_t length = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++)
+        length += reflection::reflectToString(values).length();
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+    printf("%-14s %8zu elements %8.2f ns/element %10zu chars\n", name, values.size(),
+            ns / (iterations * values.size()), length / iterations);
+}
+
+int main(int argc, char** argv) {
+    const size_t sizes[] = { 1000, 10000, 100000, 1000000 };
+
+    for (size_t size : sizes) {
+        std::vector<int> ints(size);
+
+        for (size_t i = 0; i < size; i++)
+            ints[i] = (int) (i * 2654435761u);
+
+        measure("vector<int>", ints, 1000000 / size + 1);
+    }
+
+    for (size_t size : sizes) {
+        std::vector<std::string> strings(size, "sample");
+
+        measure("vector<string>", strings, 1000000 / size + 1);
+    }
+
+    for (size_t size : sizes) {
+        std::vector<double> doubles(size);
+
+        for (size_t i = 0; i < size; i++)
+            doubles[i] = i * 0.25;
+
+        measure("vector<double>", doubles, 1000000 / size + 1);
+    }
+
+    LogRecord record = { 42, 0.5f, "request" };
+    const size_t iterations = 1000000;
+    volatile size_t sink = 0;
+
+    measureRecord("reflectToString", iterations, [&]() {
+        sink += reflection::reflectToString(record).length();
+    });
+
+    char buf[128];
+
+    measureRecord("reflectToBuffer", iterations, [&]() {
+        sink += reflection::reflectToBuffer(record, buf, sizeof(buf));
+    });
+
+    measureRecord("reflectToBuffer (truncating)", iterations, [&]() {
+        sink += reflection::reflectToBuffer(record, buf, 16);
+    });
+
+    NullWriter writer;
+
+    measureRecord("reflectToWriter", iterations, [&]() {
+        reflection::reflectToWriter(record, &writer);
+    });
+
+    return 0;
+}
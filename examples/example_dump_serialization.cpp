@@ -25,6 +25,7 @@
 */
 
 #include <reflection/dump.hpp>
+#include <reflection/schema_bundle.hpp>
 
 #include <cassert>
 #include <string>
@@ -63,7 +64,7 @@ public:
             return nullptr;
 
         // don't take this as a good example
-        printf(" (using schema '%s')", path.c_str());
+        fprintf(stderr, "(using schema '%s')\n", path.c_str());
 
         return new MyReader(file);
     }
@@ -88,12 +89,27 @@ bool str_ends_with(const char* str, const char* suffix) {
 }
 
 int usage() {
-    fprintf(stderr, "usage: example_dump_serialization <filename>.class <classId>\n");
-    fprintf(stderr, "\tOR example_dump_serialization <filename>.class_schema\n");
+    fprintf(stderr, "usage: example_dump_serialization [--json] [--bundle <bundle>] <filename>.class <classId>\n");
+    fprintf(stderr, "\tOR example_dump_serialization [--json] [--bundle <bundle>] <filename>.class_schema\n");
     return -1;
 }
 
 int main(int argc, char** argv) {
+    bool json = false;
+    const char* bundlePath = nullptr;
+
+    if (argc >= 2 && strcmp(argv[1], "--json") == 0) {
+        json = true;
+        argc--;
+        argv++;
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--bundle") == 0) {
+        bundlePath = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+
     if (argc < 2)
         return usage();
 
@@ -102,21 +118,41 @@ int main(int argc, char** argv) {
     assert(file != nullptr);
 
     MyReader rd(file);
-    MySchemaProvider sp;
+    MySchemaProvider files;
+
+    // a schema bundle (see example_serialization) replaces the individual schema files
+    reflection::SchemaBundle bundle;
+    reflection::ISchemaProvider* sp = &files;
+
+    if (bundlePath != nullptr) {
+        if (!bundle.open(bundlePath))
+            return -1;
+
+        sp = &bundle;
+    }
+
+    // all output goes through one buffered builder
+    char storage[reflection::DUMP_BUFFER_SIZE];
+    reflection::FileTextSink sink(stdout);
+    reflection::StringBuilder_t out(storage, sizeof(storage), &sink);
+
+    reflection::PrettyDumpVisitor pretty(out);
+    reflection::JsonDumpVisitor jsonVisitor(out);
+    reflection::Dumper dumper(json ? static_cast<reflection::IDumpVisitor*>(&jsonVisitor) : &pretty, sp);
 
     if (str_ends_with(fileName, ".class")) {
         if (argc < 3)
             return usage();
 
-        reflection::dumpClass(&rd, &rd, argv[2], &sp);
-        printf("\n");
-    }
-    else if (str_ends_with(fileName, ".class_schema")) {
-        reflection::dumpValue(reflection::TAG_CLASS_SCHEMA, &rd, &rd, &sp);
-        printf("\n");
+        dumper.dumpClass(&rd, argv[2]);
     }
+    else if (str_ends_with(fileName, ".class_schema"))
+        dumper.dumpValue(reflection::TAG_CLASS_SCHEMA, &rd);
     else
         return usage();
 
+    reflection::stringBuilderAppendChar(reflection::err, out, '\n');
+    reflection::stringBuilderFlush(reflection::err, out);
+
     fclose(file);
 }
@@ -28,8 +28,10 @@
 #include <reflection/basic_types.hpp>
 #include <reflection/class.hpp>
 #include <reflection/rpc.hpp>
+#include <reflection/rpc_handshake.hpp>
 
 #include <extras/basic_rpc_dispatcher.hpp>
+#include <extras/rpc_channel.hpp>
 #include <utility/memory_reader_writer.hpp>
 
 // Type declarations common for server and client
@@ -53,15 +55,26 @@ struct CachePolicy_t {
 void sayHelloTo(const string& to);
 int getResourceFromServer(const string& resource, unsigned int maxSize, const CachePolicy_t& cp);
 
-RPC_SERIALIZED(sayHelloToRPC, sayHelloTo)
-RPC_SERIALIZED(getResourceFromServerRPC, getResourceFromServer)
+RPC_CHANNEL(sayHelloToRPC, sayHelloTo)
+RPC_CHANNEL(getResourceFromServerRPC, getResourceFromServer)
+
+namespace rpc {
+    std::unique_ptr<IRpcChannel> connect();
+    bool handshake();
+}
 
 int main(int argc, char* argv[]) {
-    sayHelloToRPC("me");
+    if (!rpc::handshake())
+        return -1;
+
+    // one channel per thread (or per pooled connection); this example makes its calls from a single thread
+    auto channel = rpc::connect();
+
+    sayHelloToRPC(*channel, "me");
     puts("");
 
     CachePolicy_t cp = {"static-only", 4096, 3600};
-    int result = getResourceFromServerRPC("/test", 3000, cp);
+    int result = getResourceFromServerRPC(*channel, "/test", 3000, cp);
 
     printf("[CLIENT]\tResult is %d\n", result);
 }
@@ -85,49 +98,60 @@ BEGIN_RPC_TABLE(rpcTable)
 END_RPC_TABLE
 
 // Implementation of byte-level RPC transport
-// In this example, we just stuff everything into a buffer
+// In this example, the channel hands its request buffer straight to the dispatcher
 
 namespace rpc {
-    string rpcFunctionName;
-    bool rpcReturnsValue;
-    utility::MemoryReaderWriter io;
-
-    // Called by client when initiating a RPC request
-    // Returned writer and reader are used for serializing the arguments and deserializing
-    // the response, respectively
-    bool beginRPC(const char* functionName, bool returnsValue, IWriter*& writer_out, IReader*& reader_out) {
-        rpcFunctionName = functionName;
-        rpcReturnsValue = returnsValue;
-        writer_out = &io;
-        reader_out = &io;
-        return true;
+    class ExampleChannel : public rpc_channel::BufferedRpcChannel {
+    protected:
+        // Called after all arguments are written to the request buffer
+        // After this function returns, the client will read the response
+        virtual bool transact(utility::MemoryReaderWriter& request, utility::MemoryReaderWriter& response) override {
+            printf("[RPC]\t%u bytes of request to server\n", unsigned(request.writePos));
+
+            if (!basic_rpc_dispatcher::dispatchCall<rpcTable>(&request, &response))
+                return false;
+
+            if (returnsValue)
+                printf("[RPC]\t%u bytes of response from server\n", unsigned(response.writePos));
+
+            return true;
+        }
+    };
+
+    std::unique_ptr<IRpcChannel> connect() {
+        return std::unique_ptr<IRpcChannel>(new ExampleChannel());
     }
 
-    // Called after all arguments are written throught the provided reader
-    // After this function returns, the client will read the response
-    bool invokeRPC() {
-        printf("[RPC]\t%u bytes of arguments to server\n", unsigned(io.writePos));
-        auto w1 = io.writePos;
+    // Once per connection: the client announces the layouts of the classes it sends,
+    // the server checks them against its own
+    bool handshake() {
+        utility::MemoryReaderWriter io;
 
-        if (!basic_rpc_dispatcher::dispatch<rpcTable>(rpcFunctionName.c_str(), &io, &io))
+        if (!writeHandshake<CachePolicy_t>(err, &io))
             return false;
 
-        if (rpcReturnsValue)
-            printf("[RPC]\t%u bytes of response from server\n", unsigned(io.writePos - w1));
+        const TypeFingerprint_t serverTypes[] = {
+            {CachePolicy_t::reflection_s_classIdHash(REFL_MATCH), reflectFingerprint<CachePolicy_t>()},
+        };
 
-        return true;
-    }
+        bool incompatible[1];
+        size_t numIncompatible;
 
-    void endRPC() {
-        io.reset();
+        if (!readHandshake(err, &io, serverTypes, 1, incompatible, numIncompatible))
+            return false;
+
+        printf("[RPC]\thandshake: %u bytes, %u incompatible types\n\n", unsigned(io.writePos), unsigned(numIncompatible));
+        return true;
     }
 }
 
 /*
-[RPC]   3 bytes of arguments to server
+[RPC]   handshake: 17 bytes, 0 incompatible types
+
+[RPC]   7 bytes of request to server
 [SERVER]        sayHelloTo(me)
 
-[RPC]   24 bytes of arguments to server
+[RPC]   28 bytes of request to server
 [SERVER]        getResourceFromServer(/test, 3000, [static-only, max 4096 kB, 3600 s])
 [RPC]   1 bytes of response from server
 [CLIENT]        Result is 42
@@ -0,0 +1,157 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+#include <reflection/rpc_async.hpp>
+
+#include <extras/rpc_pipeline.hpp>
+
+// Server functions
+
+using std::string;
+
+int add(int a, int b) {
+    printf("[SERVER]\tadd(%d, %d)\n", a, b);
+    return a + b;
+}
+
+string greet(const string& name) {
+    printf("[SERVER]\tgreet(%s)\n", name.c_str());
+    return "Hello, " + name;
+}
+
+void ping() {
+    printf("[SERVER]\tping()\n");
+}
+
+BEGIN_RPC_TABLE(rpcTable)
+    RPC_TABLE_ENTRY("add",      add)
+    RPC_TABLE_ENTRY("greet",    greet)
+    RPC_TABLE_ENTRY("ping",     ping)
+END_RPC_TABLE
+
+// Client-side stubs
+
+RPC_ASYNC(addAsync, add)
+RPC_ASYNC(pingAsync, ping)
+RPC_ASYNC_CALLBACK(greetWithCallback, greet)
+
+// Transport: requests are queued as if they were on the wire; the "server" answers them
+// in reverse order, and the responses come back as one byte stream
+
+class QueueChannel : public rpc_pipeline::PipelinedRpcChannel {
+public:
+    void serveQueued() {
+        utility::MemoryReaderWriter stream;
+
+        for (size_t i = queued.size(); i-- > 0; ) {
+            if (!rpc_pipeline::dispatchRequestFrame<rpcTable>(queued[i].data(), queued[i].size(), stream))
+                return;
+        }
+
+        queued.clear();
+        printf("[RPC]\t%u bytes of responses\n", unsigned(stream.writePos));
+
+        rpc_pipeline::FrameAssembler assembler;
+        assembler.append(stream.storage.buf, stream.writePos);
+
+        const uint8_t* frame;
+        size_t size;
+
+        while (assembler.next(frame, size))
+            receiveFrame(frame, size);
+    }
+
+protected:
+    virtual bool sendFrame(const uint8_t* frame, size_t size) override {
+        printf("[RPC]\t%u bytes of request\n", unsigned(size));
+        queued.emplace_back(frame, frame + size);
+        return true;
+    }
+
+private:
+    std::vector<std::vector<uint8_t>> queued;
+};
+
+int main(int argc, char* argv[]) {
+    QueueChannel channel;
+
+    // three calls in flight at once
+    std::future<int> sum = addAsync(channel, 2, 3);
+    std::future<void> pong = pingAsync(channel);
+
+    auto completion = rpc::makeRpcCompletion<string>([](bool ok, string&& greeting) {
+        printf("[CLIENT]\tgreeting: %s\n", ok ? greeting.c_str() : "(failed)");
+    });
+
+    if (!greetWithCallback(channel, completion, "pipeline"))
+        delete completion;
+
+    printf("[CLIENT]\t%u calls pending\n\n", unsigned(channel.numPending()));
+
+    channel.serveQueued();
+
+    pong.get();
+    printf("[CLIENT]\tsum: %d\n\n", sum.get());
+
+    // a burst of small calls in one request frame, answered in one response frame
+    rpc_pipeline::RpcBatch batch;
+    std::vector<std::future<int>> sums;
+
+    for (int i = 1; i <= 3; i++)
+        sums.push_back(addAsync(batch, i, i * 10));
+
+    batch.send(channel);
+    channel.serveQueued();
+
+    for (auto& result : sums)
+        printf("[CLIENT]\tsum: %d\n", result.get());
+}
+
+/*
+[RPC]   14 bytes of request
+[RPC]   12 bytes of request
+[RPC]   21 bytes of request
+[CLIENT]        3 calls pending
+
+[SERVER]        greet(pipeline)
+[SERVER]        ping()
+[SERVER]        add(2, 3)
+[RPC]   44 bytes of responses
+[CLIENT]        greeting: Hello, pipeline
+[CLIENT]        sum: 5
+
+[RPC]   47 bytes of request
+[SERVER]        add(1, 10)
+[SERVER]        add(2, 20)
+[SERVER]        add(3, 30)
+[RPC]   27 bytes of responses
+[CLIENT]        sum: 11
+[CLIENT]        sum: 22
+[CLIENT]        sum: 33
+*/
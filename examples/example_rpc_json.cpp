@@ -0,0 +1,116 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <reflection/api.hpp>
+#include <reflection/basic_types.hpp>
+#include <reflection/class.hpp>
+
+#include <extras/rpc_http.hpp>
+
+// Server functions, callable over JSON-RPC. Run with an address (e.g. tcp:127.0.0.1:8080) to serve them:
+//
+//     curl -d '{"jsonrpc": "2.0", "method": "area", "params": [{"width": 3, "height": 4}], "id": 1}' http://127.0.0.1:8080/
+
+using std::string;
+
+struct Rect_t {
+    string name;
+    double width, height;
+
+    REFL_BEGIN("Rect_t", 1)
+        REFL_FIELD(name)
+        REFL_FIELD(width)
+        REFL_FIELD(height)
+    REFL_END
+};
+
+int add(int a, int b) {
+    return a + b;
+}
+
+double area(const Rect_t& rect) {
+    return rect.width * rect.height;
+}
+
+std::vector<Rect_t> split(const Rect_t& rect, int parts) {
+    std::vector<Rect_t> result;
+
+    for (int i = 0; i < parts; i++)
+        result.push_back(Rect_t { rect.name + "." + std::to_string(i), rect.width / parts, rect.height });
+
+    return result;
+}
+
+void ping() {
+}
+
+BEGIN_JSON_RPC_TABLE(jsonTable)
+    JSON_RPC_TABLE_ENTRY("add",     add)
+    JSON_RPC_TABLE_ENTRY("area",    area)
+    JSON_RPC_TABLE_ENTRY("split",   split)
+    JSON_RPC_TABLE_ENTRY("ping",    ping)
+END_JSON_RPC_TABLE
+
+static void call(rpc_json::JsonRpcDispatcher& dispatcher, const char* request) {
+    reflection::StringBuilder_t response;
+
+    if (!dispatcher.handle(request, strlen(request), response))
+        return;
+
+    printf("--> %s\n<-- %s\n\n", request, response.length > 0 ? response.buf : "(nothing)");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        rpc_http::JsonRpcHttpProtocol protocol(jsonTable);
+        rpc_socket::RpcServer server(&protocol);
+
+        if (!server.listen(argv[1]))
+            return -1;
+
+        printf("Serving on %s\n", server.address());
+        return server.run() ? 0 : -1;
+    }
+
+    // without a server: the same requests as an HTTP client would POST
+    rpc_json::JsonRpcDispatcher dispatcher(jsonTable);
+
+    // <-- {"jsonrpc":"2.0","result":5,"id":1}
+    call(dispatcher, R"({"jsonrpc": "2.0", "method": "add", "params": [2, 3], "id": 1})");
+
+    // parameters by name: the object is the function's only argument
+    // <-- {"jsonrpc":"2.0","result":12,"id":"a"}
+    call(dispatcher, R"({"jsonrpc": "2.0", "method": "area", "params": {"width": 3, "height": 4}, "id": "a"})");
+
+    // <-- [{"jsonrpc":"2.0","result":[{"name":"r.0","width":1,"height":1},{"name":"r.1","width":1,"height":1}],"id":2},
+    //      {"jsonrpc":"2.0","error":{"code":-32601,"message":"Method not found"},"id":3}]
+    call(dispatcher, R"([{"jsonrpc": "2.0", "method": "split", "params": [{"name": "r", "width": 2, "height": 1}, 2], "id": 2},
+            {"jsonrpc": "2.0", "method": "ping"},
+            {"jsonrpc": "2.0", "method": "resize", "id": 3}])");
+
+    // <-- {"jsonrpc":"2.0","error":{"code":-32602,"message":"Invalid params: parameter of the wrong type"},"id":4}
+    call(dispatcher, R"({"jsonrpc": "2.0", "method": "add", "params": [2, "3"], "id": 4})");
+}
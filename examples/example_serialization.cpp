@@ -29,6 +29,7 @@
 
 #include <reflection/basic_types.hpp>
 #include <reflection/class.hpp>
+#include <reflection/schema_bundle.hpp>
 
 #include <map>
 
@@ -176,8 +177,18 @@ public:
     FILE* file;
 };
 
+// reflectVisit passes every field with its actual type (in C++14, a generic lambda will do)
+struct FieldSizeVisitor {
+    template <typename T>
+    void operator()(const T& value, const char* name, uint32_t systemFlags, uint32_t flags) {
+        printf("%s: %u bytes\n", name, (unsigned) sizeof(value));
+    }
+};
+
 template <typename C>
 static void dumpSchema() {
+    reflection::reflectRegister<C>();
+
     const char* className = reflection::versionedNameOfClass<C>();
     auto fields = reflection::reflectFieldsStatic<C>();
 
@@ -195,12 +206,21 @@ int main(int argc, char** argv) {
     DataPacket packet = { "importantData", 1000, 200 };
     reflection::reflectPrint(packet);
 
+    const SpecialDataPacket specialPacket;
+    reflection::reflectVisit(specialPacket, FieldSizeVisitor());
+    printf("\n");
+
     Actor* chr = new GameCharacter("kokos");
 
     reflection::reflectPrint(*chr);
 
     string asString = reflection::reflectToString(*chr);
     printf("chr asString: %s\n", asString.c_str());
+
+    // fixed-size buffer, e.g. for a log line; the return value tells if it was cut short
+    char logBuf[48];
+    size_t length = reflection::reflectToBuffer(*chr, logBuf, sizeof(logBuf));
+    printf("chr truncated: %s%s\n", logBuf, length >= sizeof(logBuf) ? "..." : "");
     //reflection::reflectFromString(*chr, serialized);
 
     FILE* file = fopen("chr.class", "wb");
@@ -215,4 +235,13 @@ int main(int argc, char** argv) {
     dumpSchema<Sword>();
     dumpSchema<Actor>();
     dumpSchema<GameCharacter>();
+
+    // the same schemas, plus those of every other class used so far, in a single file
+    file = fopen("schemas/schemas.schema_bundle", "wb");
+    assert(file != nullptr);
+
+    MyWriter bundleWr(file);
+    reflection::writeSchemaBundle(&bundleWr);
+
+    fclose(file);
 }
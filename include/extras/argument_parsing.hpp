@@ -40,116 +40,158 @@ struct Command_t {
     void (*help)(const Command_t& cmd, const char* programName, bool full);
 };
 
+// indices of fields with a dash spec, sorted by spec; built once per command
+struct ArgumentIndex_t {
+    size_t* bySpec;
+    size_t count;
+};
+
 template <class Fields>
-bool setDashArgument(Fields& fields, int argc, char* argv[], int& i, const char* programName, char argSpecified[]) {
-    for (size_t j = 0; j < fields.count(); j++) {
-        auto field = fields[j];
+ArgumentIndex_t buildArgumentIndex(const Fields& fields) {
+    ArgumentIndex_t index = {(size_t*) malloc(fields.count() * sizeof(size_t)), 0};
 
-        const char* spec = field.params;
+    if (index.bySpec == nullptr)
+        return index;
 
-        if (spec[0] == '-' && spec[1] == argv[i][1]) {
-            // -option [value]
-            if (spec[2] != 0) {
-                if (strcmp(spec, argv[i]) != 0)
-                    continue;
+    for (size_t j = 0; j < fields.count(); j++) {
+        const char* spec = fields[j].params;
 
-                if (field.template isType<bool>()) {
-                    // -option
-                    if (!field.setFromString("1"))
-                        return false;
+        if (spec == nullptr || spec[0] != '-')
+            continue;
 
-                    argSpecified[j] = 1;
-                    return true;
-                }
-                else {
-                    // -option Value
-                    ++i;
+        // insertion sort by spec
+        size_t k = index.count++;
 
-                    if (i >= argc) {
-                        fprintf(stderr, "%s: error: expected '%s <%s>'\n", programName, spec, field.name);
-                        return false;
-                    }
+        for (; k > 0 && strcmp(fields[index.bySpec[k - 1]].params, spec) > 0; k--)
+            index.bySpec[k] = index.bySpec[k - 1];
 
-                    if (!field.setFromString(argv[i]))
-                        return false;
+        index.bySpec[k] = j;
+    }
 
-                    argSpecified[j] = 1;
-                    return true;
-                }
+    return index;
+}
+
+template <class Fields>
+bool findArgument(const Fields& fields, const ArgumentIndex_t& index, const char* arg, size_t argLen, size_t& j_out) {
+    if (index.bySpec == nullptr) {
+        // index couldn't be allocated
+        for (size_t j = 0; j < fields.count(); j++) {
+            const char* spec = fields[j].params;
+
+            if (spec != nullptr && reflection::compareFieldName(spec, arg, argLen) == 0) {
+                j_out = j;
+                return true;
             }
-            // -f / -fvalue / -f value
-            else {
-                if (field.template isType<bool>()) {
-                    // -f
-                    if (!field.setFromString("1"))
-                        return false;
+        }
 
-                    argSpecified[j] = 1;
-                    return true;
-                }
-                else if (argv[i][2] != 0) {
-                    // -fValue
-                    if (!field.setFromString(argv[i] + 2))
-                        return false;
+        return false;
+    }
 
-                    argSpecified[j] = 1;
-                    return true;
-                }
-                else {
-                    // -f Value
-                    ++i;
+    size_t low = 0, high = index.count;
 
-                    if (i >= argc) {
-                        fprintf(stderr, "%s: error: expected '%s <%s>'\n", programName, spec, field.name);
-                        return false;
-                    }
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
 
-                    if (!field.setFromString(argv[i]))
-                        return false;
+        if (reflection::compareFieldName(fields[index.bySpec[mid]].params, arg, argLen) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
 
-                    argSpecified[j] = 1;
-                    return true;
-                }
-            }
-        }
+    if (low < index.count && reflection::compareFieldName(fields[index.bySpec[low]].params, arg, argLen) == 0) {
+        j_out = index.bySpec[low];
+        return true;
     }
 
-    fprintf(stderr, "%s: error: unrecognized argument '%s'\n", programName, argv[i]);
     return false;
 }
 
+template <class Field>
+bool setArgumentFromNext(Field& field, int argc, char* argv[], int& i, const char* programName) {
+    ++i;
+
+    if (i >= argc) {
+        fprintf(stderr, "%s: error: expected '%s <%s>'\n", programName, field.params, field.name);
+        return false;
+    }
+
+    return field.setFromString(argv[i]);
+}
+
 template <class Fields>
-bool setDashDashArgument(Fields& fields, int argc, char* argv[], int& i, const char* programName, char argSpecified[]) {
-    for (size_t j = 0; j < fields.count(); j++) {
+bool setDashArgument(Fields& fields, const ArgumentIndex_t& index, int argc, char* argv[], int& i,
+        const char* programName, char argSpecified[]) {
+    const char* arg = argv[i];
+    size_t argLen = strlen(arg);
+    size_t j;
+
+    if (argLen > 2 && findArgument(fields, index, arg, argLen, j)) {
+        // -option [value]
         auto field = fields[j];
 
-        const char* spec = field.params;
+        if (field.template isType<bool>()) {
+            // -option
+            if (!field.setFromString("1"))
+                return false;
+        }
+        else {
+            // -option Value
+            if (!setArgumentFromNext(field, argc, argv, i, programName))
+                return false;
+        }
 
-        if (strcmp(spec, argv[i]) == 0) {
-            if (field.template isType<bool>()) {
-                // --option
-                if (!field.setFromString("1"))
-                    return false;
+        argSpecified[j] = 1;
+        return true;
+    }
+    else if (argLen >= 2 && findArgument(fields, index, arg, 2, j)) {
+        // -f / -fvalue / -f value
+        auto field = fields[j];
 
-                argSpecified[j] = 1;
-                return true;
-            }
-            else {
-                // --option Value
-                ++i;
+        if (field.template isType<bool>()) {
+            // -f
+            if (!field.setFromString("1"))
+                return false;
+        }
+        else if (argLen > 2) {
+            // -fValue
+            if (!field.setFromString(arg + 2))
+                return false;
+        }
+        else {
+            // -f Value
+            if (!setArgumentFromNext(field, argc, argv, i, programName))
+                return false;
+        }
 
-                if (i >= argc) {
-                    fprintf(stderr, "%s: error: expected '%s <%s>'\n", programName, spec, field.name);
-                    return false;
-                }
+        argSpecified[j] = 1;
+        return true;
+    }
+
+    fprintf(stderr, "%s: error: unrecognized argument '%s'\n", programName, argv[i]);
+    return false;
+}
 
-                if (!field.setFromString(argv[i]))
-                    return false;
+template <class Fields>
+bool setDashDashArgument(Fields& fields, const ArgumentIndex_t& index, int argc, char* argv[], int& i,
+        const char* programName, char argSpecified[]) {
+    size_t j;
 
-                argSpecified[j] = 1;
-                return true;
-            }
+    if (findArgument(fields, index, argv[i], strlen(argv[i]), j)) {
+        auto field = fields[j];
+
+        if (field.template isType<bool>()) {
+            // --option
+            if (!field.setFromString("1"))
+                return false;
+        }
+        else {
+            // --option Value
+            if (!setArgumentFromNext(field, argc, argv, i, programName))
+                return false;
         }
+
+        argSpecified[j] = 1;
+        return true;
     }
 
     fprintf(stderr, "%s: error: unrecognized argument '%s'\n", programName, argv[i]);
@@ -184,6 +226,8 @@ int execute(const Command_t& cmd, int argc, char* argv[], const char* programNam
     Command command;
     auto fields = reflection::reflectFields(command);
 
+    static const ArgumentIndex_t index = buildArgumentIndex(fields);
+
     // just an array of bools
     char* argSpecified = (char*) alloca(fields.count());
     memset(argSpecified, 0, fields.count());
@@ -195,13 +239,13 @@ int execute(const Command_t& cmd, int argc, char* argv[], const char* programNam
             if (arg[1] != '-') {
                 // dash argument
 
-                if (!setDashArgument(fields, argc, argv, i, programName, argSpecified))
+                if (!setDashArgument(fields, index, argc, argv, i, programName, argSpecified))
                     return -1;
             }
             else {
                 // double-dash argument
 
-                if (!setDashDashArgument(fields, argc, argv, i, programName, argSpecified))
+                if (!setDashDashArgument(fields, index, argc, argv, i, programName, argSpecified))
                     return -1;
             }
         }
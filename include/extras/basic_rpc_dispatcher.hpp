@@ -26,31 +26,301 @@
 
 #pragma once
 
-#include <reflection/rpc.hpp>
+#include <reflection/rpc_stream.hpp>
 
 #define BEGIN_RPC_TABLE(rpcTable_) ::basic_rpc_dispatcher::RpcFunction_t rpcTable_[] = {\
 
-#define RPC_TABLE_ENTRY(name_, function_)\
-    {name_, ::rpc::getRpcSerializedExecute<decltype(&function_), &function_>(&function_)},
+#define RPC_TABLE_ENTRY(name_, function_) RPC_TABLE_ENTRY_FLAGS(name_, function_, 0)
+
+// for handlers short enough to run on the I/O thread of a multi-threaded server (see rpc_executor.hpp)
+#define RPC_TABLE_ENTRY_INLINE(name_, function_) RPC_TABLE_ENTRY_FLAGS(name_, function_,\
+        ::basic_rpc_dispatcher::RPC_FUNCTION_INLINE)
+
+#define RPC_TABLE_ENTRY_FLAGS(name_, function_, flags_)\
+    {name_, ::rpc::getRpcSerializedExecute<decltype(&function_), &function_>(&function_),\
+            ::reflection::hashClassId(name_), ::rpc::rpcMethodId(name_, decltype(&function_)(nullptr)), (flags_)},
+
+// for server-streaming functions (see reflection/rpc_stream.hpp); served by rpc_executor::RpcExecutor only
+#define RPC_STREAM_TABLE_ENTRY(name_, function_)\
+    {name_, &::basic_rpc_dispatcher::rpcStreamOnly, ::reflection::hashClassId(name_),\
+            ::rpc::rpcStreamMethodId(name_, decltype(&function_)(nullptr)), ::basic_rpc_dispatcher::RPC_FUNCTION_STREAM,\
+            ::rpc::getRpcStreamExecute<decltype(&function_), &function_>(&function_)},
 
 #define END_RPC_TABLE {}};\
 
 namespace basic_rpc_dispatcher {
+    enum {
+        RPC_FUNCTION_INLINE = 1,
+        RPC_FUNCTION_STREAM = 2,
+    };
+
     struct RpcFunction_t {
         const char* functionName;
         bool (*callback)(reflection::IErrorHandler* err, serialization::IReader* reader, serialization::IWriter* writer);
+        uint64_t nameHash;                  // FNV-1a of functionName, computed at compile time by RPC_TABLE_ENTRY
+        rpc::RpcMethodId_t methodId;        // see rpc::rpcMethodId
+        unsigned flags;                     // RPC_FUNCTION_*
+
+        // RPC_FUNCTION_STREAM: runs the function instead of callback
+        bool (*streamCallback)(reflection::IErrorHandler* err, serialization::IReader* reader, rpc::IRpcStreamSink& sink);
     };
 
+    // callback of stream entries, for servers that answer every request with a single response
+    inline bool rpcStreamOnly(reflection::IErrorHandler* err, serialization::IReader* reader,
+            serialization::IWriter* writer) {
+        return err->error("RpcStreamNotSupported", "Streaming RPC function called on a server without stream support"),
+                false;
+    }
+
+    // open-addressing indexes over the name hashes and method IDs of a table, built on first use
+    struct RpcIndex_t {
+        const RpcFunction_t** slots;        // nullptr: not available, fall back to a linear search
+        const RpcFunction_t** idSlots;
+        size_t mask;
+    };
+
+    // an entry without a callback stands for a method ID shared by entries of different names;
+    // such calls must go by name
+    inline const RpcFunction_t* ambiguousRpcFunction() {
+        static const RpcFunction_t entry = {};
+        return &entry;
+    }
+
+    // same hash as reflection::hashClassId, without the recursion
+    inline uint64_t hashFunctionName(const char* functionName) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+
+        for (const char* p = functionName; *p != 0; p++)
+            hash = (hash ^ (uint8_t) *p) * 0x100000001b3ULL;
+
+        return hash;
+    }
+
+    inline RpcIndex_t buildRpcIndex(const RpcFunction_t* entries) {
+        size_t count = 0;
+
+        while (entries[count].functionName != nullptr)
+            count++;
+
+        size_t capacity = 16;
+
+        while (capacity < count * 2)
+            capacity *= 2;
+
+        RpcIndex_t index = { (const RpcFunction_t**) calloc(capacity * 2, sizeof(RpcFunction_t*)), nullptr, capacity - 1 };
+
+        if (index.slots == nullptr)
+            return index;
+
+        index.idSlots = index.slots + capacity;
+
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = (size_t) entries[i].nameHash & index.mask;
+
+            while (index.slots[slot] != nullptr) {
+                // the first of duplicate names wins, as with a linear search
+                if (strcmp(index.slots[slot]->functionName, entries[i].functionName) == 0)
+                    break;
+
+                slot = (slot + 1) & index.mask;
+            }
+
+            if (index.slots[slot] == nullptr)
+                index.slots[slot] = &entries[i];
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = (size_t) entries[i].methodId & index.mask;
+
+            while (index.idSlots[slot] != nullptr && index.idSlots[slot]->methodId != entries[i].methodId)
+                slot = (slot + 1) & index.mask;
+
+            const RpcFunction_t* existing = index.idSlots[slot];
+
+            if (existing == nullptr) {
+                index.idSlots[slot] = &entries[i];
+            }
+            else if (existing->callback != nullptr && strcmp(existing->functionName, entries[i].functionName) != 0) {
+                // keep the ID in the slot so that probing for other IDs is not affected
+                RpcFunction_t* marker = (RpcFunction_t*) calloc(1, sizeof(RpcFunction_t));
+
+                if (marker == nullptr) {
+                    free(index.slots);
+                    index.slots = nullptr;
+                    return index;
+                }
+
+                marker->functionName = existing->functionName;
+                marker->methodId = existing->methodId;
+                index.idSlots[slot] = marker;
+            }
+        }
+
+        return index;
+    }
+
+    template <const RpcFunction_t* entries>
+    const RpcIndex_t& rpcIndex() {
+        static const RpcIndex_t index = buildRpcIndex(entries);
+        return index;
+    }
+
+    inline const RpcFunction_t* findRpcFunction(const RpcFunction_t* entries, const RpcIndex_t& index,
+            const char* functionName) {
+        if (index.slots == nullptr) {
+            for (size_t i = 0; entries[i].functionName != nullptr; i++) {
+                if (strcmp(entries[i].functionName, functionName) == 0)
+                    return &entries[i];
+            }
+
+            return nullptr;
+        }
+
+        const uint64_t hash = hashFunctionName(functionName);
+
+        for (size_t slot = (size_t) hash & index.mask; index.slots[slot] != nullptr; slot = (slot + 1) & index.mask) {
+            const RpcFunction_t* entry = index.slots[slot];
+
+            if (entry->nameHash == hash && strcmp(entry->functionName, functionName) == 0)
+                return entry;
+        }
+
+        return nullptr;
+    }
+
+    // returns an entry without a callback if the ID is shared by differently named entries
+    inline const RpcFunction_t* findRpcFunction(const RpcFunction_t* entries, const RpcIndex_t& index,
+            rpc::RpcMethodId_t methodId) {
+        if (index.slots == nullptr) {
+            const RpcFunction_t* found = nullptr;
+
+            for (size_t i = 0; entries[i].functionName != nullptr; i++) {
+                if (entries[i].methodId != methodId)
+                    continue;
+
+                if (found == nullptr)
+                    found = &entries[i];
+                else if (strcmp(found->functionName, entries[i].functionName) != 0)
+                    return ambiguousRpcFunction();
+            }
+
+            return found;
+        }
+
+        for (size_t slot = (size_t) methodId & index.mask; index.idSlots[slot] != nullptr; slot = (slot + 1) & index.mask) {
+            const RpcFunction_t* entry = index.idSlots[slot];
+
+            if (entry->methodId == methodId)
+                return entry;
+        }
+
+        return nullptr;
+    }
+
     template <const RpcFunction_t* entries>
     bool dispatch(const char* functionName, serialization::IReader* reader, serialization::IWriter* writer) {
         auto err = reflection::err;
 
-        for (size_t i = 0; entries[i].functionName != nullptr; i++) {
-            if (strcmp(entries[i].functionName, functionName) == 0)
-                return entries[i].callback(err, reader, writer);
+        const RpcFunction_t* entry = findRpcFunction(entries, rpcIndex<entries>(), functionName);
+
+        if (entry == nullptr) {
+            err->errorf("UndefinedRpcFunction", "Undefined RPC function `%s`", functionName);
+            return false;
+        }
+
+        return entry->callback(err, reader, writer);
+    }
+
+    template <const RpcFunction_t* entries>
+    bool dispatch(rpc::RpcMethodId_t methodId, serialization::IReader* reader, serialization::IWriter* writer) {
+        auto err = reflection::err;
+
+        const RpcFunction_t* entry = findRpcFunction(entries, rpcIndex<entries>(), methodId);
+
+        if (entry == nullptr) {
+            err->errorf("UndefinedRpcFunction", "Undefined RPC method ID 0x%08X", (unsigned) methodId);
+            return false;
+        }
+
+        if (entry->callback == nullptr) {
+            err->errorf("AmbiguousRpcMethodId", "RPC method ID 0x%08X is shared by several functions, call by name",
+                    (unsigned) methodId);
+            return false;
         }
 
-        err->errorf("UndefinedRpcFunction", "Undefined RPC function `%s`", functionName);
-        return false;
+        return entry->callback(err, reader, writer);
+    }
+
+    // Call header preceding the arguments: 4-byte little-endian method ID. An ID of 0 is followed by the
+    // function name (SmvInt length + UTF-8 bytes), for callers that resolve by name.
+    enum { MAX_RPC_FUNCTION_NAME = 255 };
+
+    inline bool writeCallHeader(reflection::IErrorHandler* err, serialization::IWriter* writer,
+            rpc::RpcMethodId_t methodId, const char* functionName) {
+        uint8_t bytes[4];
+
+        for (size_t i = 0; i < sizeof(bytes); i++)
+            bytes[i] = (uint8_t)(methodId >> (i * 8));
+
+        if (!writer->write(err, bytes, sizeof(bytes)))
+            return false;
+
+        if (methodId != 0)
+            return true;
+
+        const uint64_t length = strlen(functionName);
+
+        if (length > MAX_RPC_FUNCTION_NAME)
+            return err->errorf("RpcFunctionNameTooLong", "RPC function name `%s` is too long", functionName), false;
+
+        return serialization::SmvIntSerializer<uint64_t>::serializeValue(err, writer, length)
+                && writer->write(err, functionName, (size_t) length);
+    }
+
+    // Reads a call header. functionName_out must hold MAX_RPC_FUNCTION_NAME + 1 characters and is set when
+    // methodId_out is 0.
+    inline bool readCallHeader(reflection::IErrorHandler* err, serialization::IReader* reader,
+            rpc::RpcMethodId_t& methodId_out, char* functionName_out) {
+        uint8_t bytes[4];
+
+        if (!reader->read(err, bytes, sizeof(bytes)))
+            return false;
+
+        methodId_out = 0;
+
+        for (size_t i = 0; i < sizeof(bytes); i++)
+            methodId_out |= (rpc::RpcMethodId_t) bytes[i] << (i * 8);
+
+        if (methodId_out != 0)
+            return true;
+
+        uint64_t length;
+
+        if (!serialization::SmvIntSerializer<uint64_t>::deserializeValue(err, reader, length))
+            return false;
+
+        if (length > MAX_RPC_FUNCTION_NAME)
+            return err->error("RpcFunctionNameTooLong", "RPC function name is too long"), false;
+
+        if (!reader->read(err, functionName_out, (size_t) length))
+            return false;
+
+        functionName_out[length] = 0;
+        return true;
+    }
+
+    // reads a call header and dispatches the call; arguments follow the header in reader
+    template <const RpcFunction_t* entries>
+    bool dispatchCall(serialization::IReader* reader, serialization::IWriter* writer) {
+        rpc::RpcMethodId_t methodId;
+        char functionName[MAX_RPC_FUNCTION_NAME + 1];
+
+        if (!readCallHeader(reflection::err, reader, methodId, functionName))
+            return false;
+
+        if (methodId != 0)
+            return dispatch<entries>(methodId, reader, writer);
+
+        return dispatch<entries>(functionName, reader, writer);
     }
 }
@@ -0,0 +1,719 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <reflection/numeric.hpp>
+#include <reflection/record_file.hpp>
+#include <reflection/schema.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace record_query {
+using reflection::err;
+using reflection::Tag_t;
+using reflection::StringBuilder_t;
+
+// Filters and projects the records of a record file (see record_file.hpp) without compiled-in types.
+//
+// A class is flattened into its leaf fields, in serialization order ("name", "position.x", ...).
+// Records are decoded only up to the last field a query refers to, fields in between are skipped,
+// and decoding stops at the first predicate that fails.
+
+enum Op_t {
+    OP_EQ,
+    OP_NE,
+    OP_LT,
+    OP_LE,
+    OP_GT,
+    OP_GE,
+    OP_CONTAINS,
+};
+
+// decoded leaf; strings point into the record
+struct Value_t {
+    int64_t intValue;                       // TAG_BOOL, TAG_CHAR, TAG_SMVINT
+    double doubleValue;                     // TAG_REAL32, TAG_REAL64
+    const char* str;                        // TAG_UTF8
+    size_t length;
+};
+
+struct Leaf_t {
+    std::string path;
+    Tag_t tag;
+};
+
+class Query {
+public:
+    Query() : numSteps(0) {}
+
+    // where:  "<field> <op> <value> [&& ...]", op one of == != < <= > >= ~ (substring); may be empty
+    // select: comma-separated fields; empty selects every field
+    bool compile(reflection::SchemaCache& cache, const char* classId, const char* where, const char* select) {
+        const reflection::ClassSchema_t* schema = cache.get(classId);
+
+        if (schema == nullptr)
+            return err->errorf("SchemaUnavailable", "Schema for class `%s` is not available.", classId), false;
+
+        leaves.clear();
+        predicates.clear();
+        projection.clear();
+
+        if (!flatten(cache, schema, std::string()) || !parseWhere(where) || !parseSelect(select))
+            return false;
+
+        // predicates are checked as soon as their field has been decoded
+        std::stable_sort(predicates.begin(), predicates.end(),
+                [](const Predicate_t& a, const Predicate_t& b) { return a.leaf < b.leaf; });
+
+        steps.assign(leaves.size(), Step_t { 0, false, 0, 0 });
+        numSteps = 0;
+
+        for (size_t i = 0; i < leaves.size(); i++)
+            steps[i].tag = leaves[i].tag;
+
+        for (size_t i = 0; i < predicates.size(); i++) {
+            Step_t& step = steps[predicates[i].leaf];
+
+            if (step.numPredicates++ == 0)
+                step.firstPredicate = (uint32_t) i;
+
+            step.needed = true;
+        }
+
+        for (size_t leaf : projection)
+            steps[leaf].needed = true;
+
+        for (size_t i = 0; i < steps.size(); i++) {
+            if (steps[i].needed)
+                numSteps = i + 1;
+        }
+
+        for (size_t i = 0; i < numSteps; i++) {
+            if (!isSupported(steps[i].tag))
+                return err->errorf("UnknownType", "Field `%s` has a type that can't be queried (tag %02X).",
+                        leaves[i].path.c_str(), steps[i].tag), false;
+        }
+
+        return true;
+    }
+
+    const std::vector<Leaf_t>& layout() const { return leaves; }
+
+    // size of the values array expected by evaluate()
+    size_t numValues() const { return numSteps; }
+
+    // false if the record is malformed
+    bool evaluate(const uint8_t* record, size_t size, Value_t* values, bool& match_out) const {
+        const uint8_t* p = record;
+        const uint8_t* end = record + size;
+
+        for (size_t i = 0; i < numSteps; i++) {
+            const Step_t& step = steps[i];
+            Value_t& value = values[i];
+
+            switch (step.tag) {
+                case reflection::TAG_VOID:
+                    break;
+
+                case reflection::TAG_BOOL:
+                case reflection::TAG_CHAR:
+                    if (p == end)
+                        return false;
+
+                    value.intValue = *p++;
+                    break;
+
+                case reflection::TAG_SMVINT:
+                    if (step.needed) {
+                        if (!serialization::SmvIntSerializer<int64_t>::decodeValue(p, end, value.intValue))
+                            return false;
+                    }
+                    else {
+                        while (p < end && (*p & 0x80))
+                            p++;
+
+                        if (p++ == end)
+                            return false;
+                    }
+                    break;
+
+                case reflection::TAG_REAL32: {
+                    float f;
+
+                    if (end - p < (ptrdiff_t) sizeof(f))
+                        return false;
+
+                    memcpy(&f, p, sizeof(f));
+                    value.doubleValue = f;
+                    p += sizeof(f);
+                    break;
+                }
+
+                case reflection::TAG_REAL64:
+                    if (end - p < (ptrdiff_t) sizeof(double))
+                        return false;
+
+                    memcpy(&value.doubleValue, p, sizeof(double));
+                    p += sizeof(double);
+                    break;
+
+                case reflection::TAG_UTF8: {
+                    uint64_t length;
+
+                    if (!serialization::SmvIntSerializer<uint64_t>::decodeValue(p, end, length)
+                            || length > (uint64_t) (end - p))
+                        return false;
+
+                    value.str = (const char*) p;
+                    value.length = (size_t) length;
+                    p += length;
+                    break;
+                }
+
+                default:
+                    return false;
+            }
+
+            for (uint32_t j = 0; j < step.numPredicates; j++) {
+                if (!test(predicates[step.firstPredicate + j], value))
+                    return match_out = false, true;
+            }
+        }
+
+        match_out = true;
+        return true;
+    }
+
+    // appends the selected fields as a tab-separated line
+    bool project(StringBuilder_t& out, const Value_t* values) const {
+        for (size_t i = 0; i < projection.size(); i++) {
+            if (i > 0 && !reflection::stringBuilderAppendChar(err, out, '\t'))
+                return false;
+
+            if (!formatValue(out, leaves[projection[i]].tag, values[projection[i]]))
+                return false;
+        }
+
+        return reflection::stringBuilderAppendChar(err, out, '\n');
+    }
+
+    // tab-separated names of the selected fields
+    bool header(StringBuilder_t& out) const {
+        for (size_t i = 0; i < projection.size(); i++) {
+            if ((i > 0 && !reflection::stringBuilderAppendChar(err, out, '\t'))
+                    || !reflection::stringBuilderAppend(err, out, leaves[projection[i]].path.c_str(),
+                            leaves[projection[i]].path.size()))
+                return false;
+        }
+
+        return reflection::stringBuilderAppendChar(err, out, '\n');
+    }
+
+private:
+    struct Predicate_t {
+        size_t leaf;
+        Tag_t tag;
+        Op_t op;
+        Value_t literal;                    // numeric literals
+        std::string text;                   // TAG_UTF8 literal
+    };
+
+    struct Step_t {
+        Tag_t tag;
+        bool needed;
+        uint32_t firstPredicate, numPredicates;
+    };
+
+    static bool isSupported(Tag_t tag) {
+        switch (tag) {
+            case reflection::TAG_VOID:
+            case reflection::TAG_BOOL:
+            case reflection::TAG_CHAR:
+            case reflection::TAG_SMVINT:
+            case reflection::TAG_REAL32:
+            case reflection::TAG_REAL64:
+            case reflection::TAG_UTF8:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    bool flatten(reflection::SchemaCache& cache, const reflection::ClassSchema_t* schema, const std::string& prefix) {
+        for (size_t i = 0; i < schema->numFields; i++) {
+            const reflection::SchemaField_t& field = schema->fields[i];
+
+            if (field.classId != nullptr) {
+                const reflection::ClassSchema_t* nested = cache.nested(field);
+
+                if (nested == nullptr)
+                    return err->errorf("SchemaUnavailable", "Schema for class `%s` is not available.",
+                            field.classId), false;
+
+                if (!flatten(cache, nested, prefix + field.name + "."))
+                    return false;
+            }
+            else
+                leaves.push_back(Leaf_t { prefix + field.name, field.tag });
+        }
+
+        return true;
+    }
+
+    bool findLeaf(const char* name, size_t nameLen, size_t& leaf_out) const {
+        for (size_t i = 0; i < leaves.size(); i++) {
+            if (leaves[i].path.size() == nameLen && memcmp(leaves[i].path.data(), name, nameLen) == 0)
+                return leaf_out = i, true;
+        }
+
+        return err->errorf("UnknownField", "No field named `%.*s`.", (int) nameLen, name), false;
+    }
+
+    static void trim(const char*& begin, const char*& end) {
+        while (begin < end && (*begin == ' ' || *begin == '\t'))
+            begin++;
+
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+            end--;
+    }
+
+    bool parseWhere(const char* where) {
+        const char* p = where;
+
+        while (*p != 0) {
+            const char* clauseEnd = strstr(p, "&&");
+
+            if (clauseEnd == nullptr)
+                clauseEnd = p + strlen(p);
+
+            if (!parsePredicate(p, clauseEnd))
+                return false;
+
+            p = (*clauseEnd != 0) ? clauseEnd + 2 : clauseEnd;
+        }
+
+        return true;
+    }
+
+    bool parsePredicate(const char* begin, const char* end) {
+        static const struct { const char* token; Op_t op; } ops[] = {
+            {"==", OP_EQ}, {"!=", OP_NE}, {"<=", OP_LE}, {">=", OP_GE},
+            {"<", OP_LT}, {">", OP_GT}, {"=", OP_EQ}, {"~", OP_CONTAINS},
+        };
+
+        const char* opPos = begin;
+
+        while (opPos < end && strchr("=!<>~", *opPos) == nullptr)
+            opPos++;
+
+        Predicate_t predicate;
+        size_t opLen = 0;
+
+        for (const auto& op : ops) {
+            const size_t len = strlen(op.token);
+
+            if ((size_t) (end - opPos) >= len && memcmp(opPos, op.token, len) == 0) {
+                predicate.op = op.op;
+                opLen = len;
+                break;
+            }
+        }
+
+        const char* nameBegin = begin;
+        const char* nameEnd = opPos;
+        const char* valueBegin = opPos + opLen;
+        const char* valueEnd = end;
+
+        trim(nameBegin, nameEnd);
+        trim(valueBegin, valueEnd);
+
+        if (opLen == 0 || nameBegin == nameEnd)
+            return err->errorf("QuerySyntaxError", "Expected `<field> <op> <value>`, got `%.*s`.",
+                    (int) (end - begin), begin), false;
+
+        if (!findLeaf(nameBegin, nameEnd - nameBegin, predicate.leaf))
+            return false;
+
+        // optional quotes
+        if (valueEnd - valueBegin >= 2 && (*valueBegin == '"' || *valueBegin == '\'') && valueEnd[-1] == *valueBegin) {
+            valueBegin++;
+            valueEnd--;
+        }
+
+        const Tag_t tag = leaves[predicate.leaf].tag;
+
+        if (predicate.op == OP_CONTAINS && tag != reflection::TAG_UTF8)
+            return err->errorf("QuerySyntaxError", "`~` only applies to strings (field `%s`).",
+                    leaves[predicate.leaf].path.c_str()), false;
+
+        if (!parseLiteral(tag, valueBegin, valueEnd - valueBegin, predicate))
+            return err->errorf("QuerySyntaxError", "`%.*s` is not a valid value for field `%s`.",
+                    (int) (valueEnd - valueBegin), valueBegin, leaves[predicate.leaf].path.c_str()), false;
+
+        predicate.tag = tag;
+        predicates.push_back(predicate);
+        return true;
+    }
+
+    static bool parseLiteral(Tag_t tag, const char* str, size_t length, Predicate_t& predicate) {
+        Value_t& literal = predicate.literal;
+
+        switch (tag) {
+            case reflection::TAG_BOOL:
+                if ((length == 4 && memcmp(str, "true", 4) == 0) || (length == 1 && *str == '1'))
+                    return literal.intValue = 1, true;
+
+                if ((length == 5 && memcmp(str, "false", 5) == 0) || (length == 1 && *str == '0'))
+                    return literal.intValue = 0, true;
+
+                return false;
+
+            case reflection::TAG_CHAR:
+                if (length == 1)
+                    return literal.intValue = (unsigned char) *str, true;
+
+                return reflection::parseInteger(str, length, literal.intValue) == reflection::PARSE_OK;
+
+            case reflection::TAG_SMVINT:
+                return reflection::parseInteger(str, length, literal.intValue) == reflection::PARSE_OK;
+
+            case reflection::TAG_REAL32:
+            case reflection::TAG_REAL64:
+                return reflection::parseFloat(str, length, literal.doubleValue) == reflection::PARSE_OK;
+
+            case reflection::TAG_UTF8:
+                predicate.text.assign(str, length);
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    bool parseSelect(const char* select) {
+        if (*select == 0) {
+            for (size_t i = 0; i < leaves.size(); i++)
+                projection.push_back(i);
+
+            return true;
+        }
+
+        const char* p = select;
+
+        for (;;) {
+            const char* nameEnd = strchr(p, ',');
+
+            if (nameEnd == nullptr)
+                nameEnd = p + strlen(p);
+
+            const char* nameBegin = p;
+            const char* next = nameEnd;
+            trim(nameBegin, nameEnd);
+
+            size_t leaf;
+
+            if (!findLeaf(nameBegin, nameEnd - nameBegin, leaf))
+                return false;
+
+            projection.push_back(leaf);
+
+            if (*next == 0)
+                return true;
+
+            p = next + 1;
+        }
+    }
+
+    template <typename T>
+    static bool compare(Op_t op, const T& a, const T& b) {
+        switch (op) {
+            case OP_EQ: return a == b;
+            case OP_NE: return a != b;
+            case OP_LT: return a < b;
+            case OP_LE: return a <= b;
+            case OP_GT: return a > b;
+            case OP_GE: return a >= b;
+            default:    return false;
+        }
+    }
+
+    static bool test(const Predicate_t& predicate, const Value_t& value) {
+        switch (predicate.tag) {
+            case reflection::TAG_REAL32:
+            case reflection::TAG_REAL64:
+                return compare(predicate.op, value.doubleValue, predicate.literal.doubleValue);
+
+            case reflection::TAG_UTF8: {
+                const std::string& text = predicate.text;
+
+                if (predicate.op == OP_CONTAINS)
+                    return contains(value.str, value.length, text.data(), text.size());
+
+                const size_t common = (value.length < text.size()) ? value.length : text.size();
+                int order = memcmp(value.str, text.data(), common);
+
+                if (order == 0)
+                    order = (value.length > text.size()) - (value.length < text.size());
+
+                return compare(predicate.op, order, 0);
+            }
+
+            default:
+                return compare(predicate.op, value.intValue, predicate.literal.intValue);
+        }
+    }
+
+    static bool contains(const char* str, size_t length, const char* needle, size_t needleLength) {
+        if (needleLength == 0)
+            return true;
+
+        const char* end = str + length;
+
+        for (const char* p = str; (size_t) (end - p) >= needleLength; p++) {
+            p = (const char*) memchr(p, needle[0], (end - p) - needleLength + 1);
+
+            if (p == nullptr)
+                return false;
+
+            if (memcmp(p, needle, needleLength) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static bool formatValue(StringBuilder_t& out, Tag_t tag, const Value_t& value) {
+        char buf[reflection::MAX_FLOAT_CHARS];
+
+        switch (tag) {
+            case reflection::TAG_VOID:
+                return true;
+
+            case reflection::TAG_BOOL:
+                return value.intValue ? reflection::stringBuilderAppend(err, out, "true", 4)
+                        : reflection::stringBuilderAppend(err, out, "false", 5);
+
+            case reflection::TAG_CHAR:
+                return reflection::stringBuilderAppendChar(err, out, (char) value.intValue);
+
+            case reflection::TAG_SMVINT:
+                return reflection::stringBuilderAppend(err, out, buf, reflection::formatInteger(buf, value.intValue));
+
+            case reflection::TAG_REAL32:
+                return reflection::stringBuilderAppend(err, out, buf, reflection::formatFloat(buf, (float) value.doubleValue));
+
+            case reflection::TAG_REAL64:
+                return reflection::stringBuilderAppend(err, out, buf, reflection::formatFloat(buf, value.doubleValue));
+
+            case reflection::TAG_UTF8:
+                return appendEscaped(out, value.str, value.length);
+
+            default:
+                return false;
+        }
+    }
+
+    // keeps one record per line
+    static bool appendEscaped(StringBuilder_t& out, const char* str, size_t length) {
+        size_t start = 0;
+
+        for (size_t i = 0; i < length; i++) {
+            const char c = str[i];
+
+            if (c != '\t' && c != '\n' && c != '\r' && c != '\\')
+                continue;
+
+            const char escaped[2] = {'\\', c == '\t' ? 't' : c == '\n' ? 'n' : c == '\r' ? 'r' : '\\'};
+
+            if (!reflection::stringBuilderAppend(err, out, str + start, i - start)
+                    || !reflection::stringBuilderAppend(err, out, escaped, 2))
+                return false;
+
+            start = i + 1;
+        }
+
+        return reflection::stringBuilderAppend(err, out, str + start, length - start);
+    }
+
+    std::vector<Leaf_t> leaves;
+    std::vector<Step_t> steps;
+    std::vector<Predicate_t> predicates;
+    std::vector<size_t> projection;
+    size_t numSteps;
+};
+
+struct QueryStats_t {
+    uint64_t bytes;                         // size of the record area
+    uint64_t records;
+    uint64_t matches;
+};
+
+enum { QUERY_TASK_SIZE = 1024 * 1024 };
+
+// Runs a compiled query over a mapped record file. Consecutive blocks are grouped into tasks of
+// about QUERY_TASK_SIZE bytes and handed out to numThreads workers; the output of each task goes to
+// the sink in file order. With sink == nullptr matches are only counted.
+static bool runQuery(const Query& query, const uint8_t* data, size_t size, size_t recordsOffset,
+        unsigned numThreads, reflection::ITextSink* sink, QueryStats_t& stats_out) {
+    struct Task_t {
+        size_t begin, end;
+        std::string output;
+        uint64_t records, matches;
+        bool done, failed;
+    };
+
+    // only block headers are touched here
+    std::vector<Task_t> tasks;
+
+    for (size_t offset = recordsOffset; offset < size; ) {
+        reflection::RecordBlockHeader_t header;
+
+        if (!reflection::readRecordBlock(data, size, offset, header))
+            return err->errorf("RecordFileFormatError", "Truncated record block at offset %zu.", offset), false;
+
+        const size_t next = offset + sizeof(header) + header.size;
+
+        if (tasks.empty() || tasks.back().end - tasks.back().begin >= QUERY_TASK_SIZE)
+            tasks.push_back(Task_t { offset, next, std::string(), 0, 0, false, false });
+        else
+            tasks.back().end = next;
+
+        offset = next;
+    }
+
+    std::mutex mutex;
+    std::condition_variable taskDone;
+    std::atomic<size_t> nextTask(0);
+    std::atomic<bool> abort(false);
+
+    auto runTask = [&](Task_t& task) {
+        std::vector<Value_t> values(query.numValues());
+        char storage[4096];
+        reflection::StdStringTextSink taskSink(task.output);
+        StringBuilder_t out(storage, sizeof(storage), &taskSink);
+
+        for (size_t offset = task.begin; offset < task.end; ) {
+            reflection::RecordBlockHeader_t header;
+            memcpy(&header, data + offset, sizeof(header));
+
+            const uint8_t* p = data + offset + sizeof(header);
+            const uint8_t* end = p + header.size;
+
+            for (uint32_t i = 0; i < header.numRecords; i++) {
+                const uint8_t* record;
+                size_t recordSize;
+                bool match;
+
+                if (!reflection::nextRecord(p, end, record, recordSize)
+                        || !query.evaluate(record, recordSize, values.data(), match))
+                    return false;
+
+                task.records++;
+
+                if (match) {
+                    task.matches++;
+
+                    if (sink != nullptr && !query.project(out, values.data()))
+                        return false;
+                }
+            }
+
+            offset = end - data;
+        }
+
+        return reflection::stringBuilderFlush(err, out);
+    };
+
+    auto worker = [&]() {
+        for (;;) {
+            const size_t index = nextTask++;
+
+            if (index >= tasks.size() || abort)
+                return;
+
+            Task_t& task = tasks[index];
+            const bool ok = runTask(task);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            task.failed = !ok;
+            task.done = true;
+            taskDone.notify_one();
+        }
+    };
+
+    if (numThreads == 0)
+        numThreads = 1;
+
+    std::vector<std::thread> workers;
+
+    for (unsigned i = 0; i < numThreads && i < tasks.size(); i++)
+        workers.emplace_back(worker);
+
+    stats_out = QueryStats_t { size - recordsOffset, 0, 0 };
+    size_t failedAt = SIZE_MAX;
+    bool sinkOk = true;
+
+    // emit in order while the workers carry on
+    for (size_t i = 0; i < tasks.size(); i++) {
+        Task_t& task = tasks[i];
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskDone.wait(lock, [&]() { return task.done; });
+        }
+
+        if (task.failed) {
+            failedAt = task.begin;
+            abort = true;
+            break;
+        }
+
+        stats_out.records += task.records;
+        stats_out.matches += task.matches;
+
+        if (sink != nullptr && !task.output.empty() && sinkOk)
+            sinkOk = sink->flush(err, task.output.data(), task.output.size());
+
+        std::string().swap(task.output);
+    }
+
+    for (auto& thread : workers)
+        thread.join();
+
+    if (failedAt != SIZE_MAX)
+        return err->errorf("RecordFileFormatError", "Malformed record in the block at offset %zu.", failedAt), false;
+
+    return sinkOk;
+}
+}
@@ -0,0 +1,159 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <extras/basic_rpc_dispatcher.hpp>
+#include <utility/memory_reader_writer.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Implements the global rpc::beginRPC/invokeRPC/endRPC used by RPC_SERIALIZED calls on top of a channel.
+// channel_ is an expression yielding an rpc::IRpcChannel&, evaluated for every call (so it may name a
+// thread_local channel). Use once per program, outside of any namespace.
+#define DEFINE_RPC_GLOBAL_CHANNEL(channel_)\
+namespace rpc {\
+    bool beginRPC(const char* functionName, RpcMethodId_t methodId, bool returnsValue,\
+            IWriter*& writer_out, IReader*& reader_out) {\
+        return (channel_).beginCall(functionName, methodId, returnsValue, writer_out, reader_out);\
+    }\
+    bool invokeRPC() { return (channel_).invokeCall(); }\
+    void endRPC() { (channel_).endCall(); }\
+}\
+
+namespace rpc_channel {
+    // Channel with its own request and response buffers, reused from call to call.
+    // The request starts with the basic_rpc_dispatcher call header; subclasses deliver it in transact().
+    class BufferedRpcChannel : public rpc::IRpcChannel {
+    public:
+        BufferedRpcChannel() : err(reflection::err), returnsValue(false) {}
+
+        virtual bool beginCall(const char* functionName, rpc::RpcMethodId_t methodId, bool returnsValue,
+                serialization::IWriter*& writer_out, serialization::IReader*& reader_out) override {
+            request.reset();
+            response.reset();
+            this->returnsValue = returnsValue;
+
+            if (!basic_rpc_dispatcher::writeCallHeader(err, &request, methodId, functionName))
+                return false;
+
+            writer_out = &request;
+            reader_out = &response;
+            return true;
+        }
+
+        virtual bool invokeCall() override {
+            return transact(request, response);
+        }
+
+        virtual void endCall() override {
+        }
+
+        reflection::IErrorHandler* err;
+
+    protected:
+        // sends request (request.writePos bytes) and receives the response into response
+        virtual bool transact(utility::MemoryReaderWriter& request, utility::MemoryReaderWriter& response) = 0;
+
+        utility::MemoryReaderWriter request, response;
+        bool returnsValue;
+    };
+
+    // In-process channel, dispatches straight into an RPC table
+    template <const basic_rpc_dispatcher::RpcFunction_t* entries>
+    class LoopbackRpcChannel : public BufferedRpcChannel {
+    protected:
+        virtual bool transact(utility::MemoryReaderWriter& request, utility::MemoryReaderWriter& response) override {
+            return basic_rpc_dispatcher::dispatchCall<entries>(&request, &response);
+        }
+    };
+
+    // Channels for threads that do not keep their own; the lock is held only to take or return a channel,
+    // never during a call.
+    template <class Channel>
+    class RpcChannelPool {
+    public:
+        typedef std::unique_ptr<Channel> (*Factory_t)(void* context);
+
+        RpcChannelPool(Factory_t factory = &newChannel, void* context = nullptr) : factory(factory), context(context) {}
+
+        RpcChannelPool(const RpcChannelPool&) = delete;
+
+        // nullptr if a new channel could not be created
+        std::unique_ptr<Channel> acquire() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!idle.empty()) {
+                    std::unique_ptr<Channel> channel = std::move(idle.back());
+                    idle.pop_back();
+                    return channel;
+                }
+            }
+
+            return factory(context);
+        }
+
+        void release(std::unique_ptr<Channel> channel) {
+            if (channel == nullptr)
+                return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(std::move(channel));
+        }
+
+    private:
+        static std::unique_ptr<Channel> newChannel(void* context) {
+            return std::unique_ptr<Channel>(new Channel());
+        }
+
+        Factory_t factory;
+        void* context;
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Channel>> idle;
+    };
+
+    // returns a pooled channel to its pool when going out of scope
+    template <class Channel>
+    class PooledRpcChannel {
+    public:
+        explicit PooledRpcChannel(RpcChannelPool<Channel>& pool) : pool(pool), channel(pool.acquire()) {}
+        ~PooledRpcChannel() { pool.release(std::move(channel)); }
+
+        PooledRpcChannel(const PooledRpcChannel&) = delete;
+
+        explicit operator bool() const { return channel != nullptr; }
+        Channel& operator*() { return *channel; }
+        Channel* operator->() { return channel.get(); }
+
+    private:
+        RpcChannelPool<Channel>& pool;
+        std::unique_ptr<Channel> channel;
+    };
+}
@@ -0,0 +1,579 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// Multi-threaded request execution for rpc_socket::RpcServer: the I/O thread decodes frames and hands
+// them to a work-stealing pool of workers, each with its own reusable response buffer. Functions
+// registered with RPC_TABLE_ENTRY_INLINE skip the pool and run on the I/O thread. Linux only.
+//
+// Streaming functions (RPC_STREAM_TABLE_ENTRY) run on the pool as well and keep their worker while they
+// wait for the client to grant credit, so a pool meant to serve slow stream consumers needs workers to
+// spare for other requests.
+
+#include <extras/rpc_socket.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace rpc_executor {
+struct PoolOptions_t {
+    size_t numWorkers;      // 0: one per hardware thread
+    int firstCpu;           // < 0: no affinity, otherwise worker i is pinned to CPU (firstCpu + i) mod #CPUs
+
+    PoolOptions_t() : numWorkers(0), firstCpu(-1) {}
+};
+
+class WorkStealingPool;
+struct Worker_t;
+
+// A unit of work; run() is responsible for releasing the task
+class ITask {
+public:
+    virtual ~ITask() {}
+
+    virtual void run(Worker_t& worker) = 0;
+};
+
+struct Worker_t {
+    WorkStealingPool* pool;
+    size_t index;
+    utility::MemoryReaderWriter response;       // for tasks to reuse, instead of allocating their own
+
+    // tasks the worker submitted itself: it takes from the back, thieves from the front
+    std::mutex mutex;
+    std::deque<ITask*> tasks;
+    std::thread thread;
+};
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(const PoolOptions_t& options = PoolOptions_t())
+            : numQueued(0), numPending(0), numSleeping(0), stopping(false) {
+        size_t numWorkers = options.numWorkers;
+
+        if (numWorkers == 0)
+            numWorkers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+        for (size_t i = 0; i < numWorkers; i++) {
+            workers.emplace_back(new Worker_t());
+            workers.back()->pool = this;
+            workers.back()->index = i;
+        }
+
+        const long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        for (size_t i = 0; i < numWorkers; i++) {
+            Worker_t& worker = *workers[i];
+            worker.thread = std::thread(&WorkStealingPool::work, this, &worker);
+
+            if (options.firstCpu >= 0 && numCpus > 0) {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET((options.firstCpu + i) % numCpus, &cpus);
+                pthread_setaffinity_np(worker.thread.native_handle(), sizeof(cpus), &cpus);
+            }
+        }
+    }
+
+    // runs the tasks still queued, then joins the workers
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+
+        wakeup.notify_all();
+
+        for (auto& worker : workers)
+            worker->thread.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+
+    // May be called from any thread; tasks submitted by a worker go to its own queue, all others to the
+    // injection queue, which the workers drain in submission order
+    void submit(ITask* task) {
+        Worker_t* worker = currentWorker();
+
+        numPending++;
+
+        if (worker != nullptr && worker->pool == this) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->tasks.push_back(task);
+        }
+        else {
+            std::lock_guard<std::mutex> lock(injectedMutex);
+            injected.push_back(task);
+        }
+
+        numQueued++;
+
+        // a worker counts itself as sleeping before checking numQueued; the lock orders the
+        // notification after its wait
+        if (numSleeping > 0) {
+            { std::lock_guard<std::mutex> lock(sleepMutex); }
+            wakeup.notify_one();
+        }
+    }
+
+    size_t numWorkers() const {
+        return workers.size();
+    }
+
+    // waits until every task submitted so far has run
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+
+        while (numPending > 0)
+            idle.wait(lock);
+    }
+
+private:
+    static Worker_t*& currentWorkerSlot() {
+        static thread_local Worker_t* worker = nullptr;
+        return worker;
+    }
+
+    Worker_t* currentWorker() {
+        return currentWorkerSlot();
+    }
+
+    ITask* take(Worker_t& self) {
+        {
+            std::lock_guard<std::mutex> lock(self.mutex);
+
+            if (!self.tasks.empty()) {
+                ITask* task = self.tasks.back();
+                self.tasks.pop_back();
+                return task;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(injectedMutex);
+
+            if (!injected.empty()) {
+                ITask* task = injected.front();
+                injected.pop_front();
+                return task;
+            }
+        }
+
+        for (size_t i = 1; i < workers.size(); i++) {
+            Worker_t& victim = *workers[(self.index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            if (!victim.tasks.empty()) {
+                ITask* task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void work(Worker_t* self) {
+        currentWorkerSlot() = self;
+
+        for (;;) {
+            ITask* task = take(*self);
+
+            if (task != nullptr) {
+                numQueued--;
+                task->run(*self);
+
+                if (--numPending == 0) {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    idle.notify_all();
+                }
+
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            numSleeping++;
+
+            while (numQueued == 0 && !stopping)
+                wakeup.wait(lock);
+
+            numSleeping--;
+
+            if (numQueued == 0 && stopping)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker_t>> workers;
+
+    std::mutex injectedMutex;
+    std::deque<ITask*> injected;
+
+    std::atomic<size_t> numQueued, numPending, numSleeping;     // numPending: queued or running
+    std::mutex sleepMutex;
+    std::condition_variable wakeup, idle;
+    bool stopping;
+};
+
+// Request executor for RpcServer: runs RPC_TABLE_ENTRY_INLINE functions on the I/O thread and everything
+// else (including batches and calls by name) on the pool. Also serves streaming functions, with credit
+// requests handled on the I/O thread. Must outlive the server.
+template <const basic_rpc_dispatcher::RpcFunction_t* entries>
+class RpcExecutor : public rpc_socket::RpcServer::IRequestExecutor {
+public:
+    explicit RpcExecutor(const PoolOptions_t& options = PoolOptions_t()) : pool(options) {}
+
+    virtual bool execute(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection, const uint8_t* frame,
+            size_t size, utility::MemoryReaderWriter& response_out) override {
+        using namespace basic_rpc_dispatcher;
+
+        if (size < rpc_pipeline::FRAME_HEADER_SIZE)
+            return rpc_pipeline::dispatchRequestFrame<entries>(frame, size, response_out);
+
+        const rpc_pipeline::RpcRequestId_t requestId = rpc_pipeline::getUint32(frame + 4);
+        utility::SpanReader reader(frame + rpc_pipeline::FRAME_HEADER_SIZE, size - rpc_pipeline::FRAME_HEADER_SIZE);
+        rpc::RpcMethodId_t methodId;
+        char functionName[MAX_RPC_FUNCTION_NAME + 1];
+
+        if (!readCallHeader(reflection::err, &reader, methodId, functionName))
+            return writeFinalResponse(requestId, rpc_pipeline::RESPONSE_ERROR, response_out);
+
+        if (methodId == 0 && strcmp(functionName, rpc_pipeline::STREAM_CREDIT_FUNCTION) == 0)
+            return grantCredit(connection, requestId, reader);
+
+        const RpcFunction_t* entry = (methodId != 0) ? findRpcFunction(entries, rpcIndex<entries>(), methodId)
+                : findRpcFunction(entries, rpcIndex<entries>(), functionName);
+
+        if (entry != nullptr && entry->streamCallback != nullptr)
+            return startStream(server, connection, frame, size, entry,
+                    rpc_pipeline::FRAME_HEADER_SIZE + reader.pos, response_out);
+
+        if (entry != nullptr && entry->callback != nullptr && (entry->flags & RPC_FUNCTION_INLINE) != 0)
+            return rpc_pipeline::dispatchRequestFrame<entries>(frame, size, response_out);
+
+        RequestTask_* task = RequestTask_::create(server, connection, frame, size);
+
+        if (task == nullptr)
+            return reflection::err->allocationError("rpc_executor::RpcExecutor"), false;
+
+        pool.submit(task);
+        return true;
+    }
+
+    virtual void closed(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection) override {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+
+        for (auto it = streams.lower_bound(StreamKey_t(connection, 0)); it != streams.end() && it->first.first == connection;
+                ++it)
+            it->second->cancel();
+    }
+
+    virtual void drain() override {
+        // nobody will grant credit anymore
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+
+            for (const auto& stream : streams)
+                stream.second->cancel();
+        }
+
+        pool.waitIdle();
+    }
+
+    WorkStealingPool& getPool() {
+        return pool;
+    }
+
+private:
+    typedef std::pair<rpc_socket::ConnectionId_t, rpc_pipeline::RpcRequestId_t> StreamKey_t;
+
+    static bool writeFinalResponse(rpc_pipeline::RpcRequestId_t requestId, uint8_t status,
+            utility::MemoryReaderWriter& response_out) {
+        uint8_t header[rpc_pipeline::FRAME_HEADER_SIZE + 1];
+
+        rpc_pipeline::putUint32(header, (uint32_t)(sizeof(header) - 4));
+        rpc_pipeline::putUint32(header + 4, requestId);
+        header[rpc_pipeline::FRAME_HEADER_SIZE] = status;
+
+        return response_out.write(reflection::err, header, sizeof(header));
+    }
+
+    // the frame is stored right after the task, in the same allocation
+    class RequestTask_ : public ITask {
+    public:
+        static RequestTask_* create(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection,
+                const uint8_t* frame, size_t size) {
+            void* memory = malloc(sizeof(RequestTask_) + size);
+
+            if (memory == nullptr)
+                return nullptr;
+
+            RequestTask_* task = new (memory) RequestTask_(server, connection, size);
+            memcpy(static_cast<uint8_t*>(memory) + sizeof(RequestTask_), frame, size);
+            return task;
+        }
+
+        virtual void run(Worker_t& worker) override {
+            worker.response.reset();
+
+            if (rpc_pipeline::dispatchRequestFrame<entries>(frame(), size, worker.response))
+                server.postResponse(connection, (const uint8_t*) worker.response.storage.buf, worker.response.writePos);
+            else
+                server.postClose(connection);
+
+            this->~RequestTask_();
+            free(this);
+        }
+
+    private:
+        RequestTask_(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection, size_t size)
+                : server(server), connection(connection), size(size) {}
+
+        const uint8_t* frame() const {
+            return reinterpret_cast<const uint8_t*>(this) + sizeof(RequestTask_);
+        }
+
+        rpc_socket::RpcServer& server;
+        rpc_socket::ConnectionId_t connection;
+        size_t size;
+    };
+
+    // A running stream; items are built in the response buffer of the worker. Like RequestTask_, the
+    // frame follows the task.
+    class StreamTask_ : public ITask, public rpc::IRpcStreamSink {
+    public:
+        static StreamTask_* create(RpcExecutor& executor, rpc_socket::RpcServer& server,
+                rpc_socket::ConnectionId_t connection, const uint8_t* frame, size_t size,
+                const basic_rpc_dispatcher::RpcFunction_t* entry, size_t argumentsPos) {
+            void* memory = malloc(sizeof(StreamTask_) + size);
+
+            if (memory == nullptr)
+                return nullptr;
+
+            StreamTask_* task = new (memory) StreamTask_(executor, server, connection, size, entry, argumentsPos);
+            memcpy(static_cast<uint8_t*>(memory) + sizeof(StreamTask_), frame, size);
+            return task;
+        }
+
+        void destroy() {
+            this->~StreamTask_();
+            free(this);
+        }
+
+        rpc_pipeline::RpcRequestId_t requestId() const {
+            return rpc_pipeline::getUint32(frame() + 4);
+        }
+
+        StreamKey_t key() const {
+            return StreamKey_t(connection, requestId());
+        }
+
+        // 0 bytes: cancel
+        void addCredit(uint32_t bytes) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (bytes == 0)
+                cancelled = true;
+            else
+                credit += bytes;
+
+            creditGranted.notify_all();
+        }
+
+        void cancel() {
+            addCredit(0);
+        }
+
+        virtual void run(Worker_t& worker) override {
+            auto err = reflection::err;
+
+            item = &worker.response;
+
+            utility::SpanReader reader(frame() + argumentsPos, size - argumentsPos);
+            const bool ok = entry->streamCallback(err, &reader, *this);
+
+            bool succeeded;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                succeeded = (ok && !failed && !cancelled);
+            }
+
+            worker.response.reset();
+
+            if (writeFinalResponse(requestId(), succeeded ? rpc_pipeline::RESPONSE_OK : rpc_pipeline::RESPONSE_ERROR,
+                    worker.response))
+                server.postResponse(connection, (const uint8_t*) worker.response.storage.buf, worker.response.writePos);
+
+            executor.finishStream(this);
+        }
+
+        virtual bool beginItem(serialization::IWriter*& writer_out) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (cancelled)
+                    return false;
+            }
+
+            uint8_t header[rpc_pipeline::FRAME_HEADER_SIZE + 1];
+            rpc_pipeline::putUint32(header + 4, requestId());
+            header[rpc_pipeline::FRAME_HEADER_SIZE] = rpc_pipeline::RESPONSE_STREAM_ITEM;
+
+            item->reset();
+
+            if (!item->write(reflection::err, header, sizeof(header)))
+                return false;
+
+            writer_out = item;
+            return true;
+        }
+
+        virtual bool endItem() override {
+            const size_t frameSize = item->writePos;
+
+            if (frameSize > rpc_pipeline::MAX_FRAME_SIZE) {
+                fail();
+                return reflection::err->error("RpcFrameTooLarge", "RPC stream item exceeds the maximum frame size"),
+                        false;
+            }
+
+            rpc_pipeline::putUint32((uint8_t*) item->storage.buf, (uint32_t)(frameSize - 4));
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                while (credit <= 0 && !cancelled)
+                    creditGranted.wait(lock);
+
+                if (cancelled)
+                    return false;
+
+                credit -= (int64_t) frameSize;
+            }
+
+            server.postResponse(connection, (const uint8_t*) item->storage.buf, frameSize);
+            return true;
+        }
+
+        virtual void fail() override {
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = true;
+        }
+
+    private:
+        StreamTask_(RpcExecutor& executor, rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection,
+                size_t size, const basic_rpc_dispatcher::RpcFunction_t* entry, size_t argumentsPos)
+                : executor(executor), server(server), connection(connection), size(size), entry(entry),
+                argumentsPos(argumentsPos), item(nullptr), credit(0), cancelled(false), failed(false) {}
+
+        const uint8_t* frame() const {
+            return reinterpret_cast<const uint8_t*>(this) + sizeof(StreamTask_);
+        }
+
+        RpcExecutor& executor;
+        rpc_socket::RpcServer& server;
+        rpc_socket::ConnectionId_t connection;
+        size_t size;
+        const basic_rpc_dispatcher::RpcFunction_t* entry;
+        size_t argumentsPos;
+        utility::MemoryReaderWriter* item;
+
+        std::mutex mutex;
+        std::condition_variable creditGranted;
+        int64_t credit;                 // goes negative when an item overdraws it
+        bool cancelled, failed;
+    };
+
+    bool startStream(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection, const uint8_t* frame,
+            size_t size, const basic_rpc_dispatcher::RpcFunction_t* entry, size_t argumentsPos,
+            utility::MemoryReaderWriter& response_out) {
+        StreamTask_* task = StreamTask_::create(*this, server, connection, frame, size, entry, argumentsPos);
+
+        if (task == nullptr)
+            return reflection::err->allocationError("rpc_executor::RpcExecutor"), false;
+
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+
+            if (!streams.emplace(task->key(), task).second) {
+                const rpc_pipeline::RpcRequestId_t requestId = task->requestId();
+                task->destroy();
+
+                reflection::err->errorf("DuplicateRpcRequestId", "RPC request ID %u is already in use by a stream",
+                        (unsigned) requestId);
+                return writeFinalResponse(requestId, rpc_pipeline::RESPONSE_ERROR, response_out);
+            }
+        }
+
+        pool.submit(task);
+        return true;
+    }
+
+    bool grantCredit(rpc_socket::ConnectionId_t connection, rpc_pipeline::RpcRequestId_t requestId,
+            serialization::IReader& reader) {
+        uint8_t bytes[4];
+
+        if (!reader.read(reflection::err, bytes, sizeof(bytes)))
+            return false;
+
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        auto it = streams.find(StreamKey_t(connection, requestId));
+
+        // the stream may have ended already
+        if (it != streams.end())
+            it->second->addCredit(rpc_pipeline::getUint32(bytes));
+
+        return true;
+    }
+
+    void finishStream(StreamTask_* task) {
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            streams.erase(task->key());
+        }
+
+        task->destroy();
+    }
+
+    WorkStealingPool pool;
+
+    std::mutex streamsMutex;
+    std::map<StreamKey_t, StreamTask_*> streams;
+};
+}
@@ -0,0 +1,279 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// JSON-RPC over HTTP/1.1 (see rpc_json.hpp), served by rpc_socket::RpcServer:
+//
+//     rpc_http::JsonRpcHttpProtocol protocol(jsonTable);
+//     rpc_socket::RpcServer server(&protocol);
+//     server.listen("tcp:127.0.0.1:8080");
+//     server.run();
+//
+// A POST to any path carries one JSON-RPC request or batch. Connections are kept alive unless the
+// client asks otherwise, and pipelined requests are answered in order. Chunked request bodies are not
+// supported. Requests are handled on the server's I/O thread.
+
+#include <extras/rpc_json.hpp>
+#include <extras/rpc_socket.hpp>
+
+#include <string.h>
+
+namespace rpc_http {
+enum {
+    MAX_HEADER_SIZE = 16 * 1024,
+    DEFAULT_MAX_BODY_SIZE = 16 * 1024 * 1024,
+};
+
+struct HttpRequest_t {
+    const char* method;
+    size_t methodLength;
+    size_t headerSize;          // up to and including the empty line
+    uint64_t contentLength;
+    bool keepAlive;
+    bool expectContinue;
+    bool chunked;
+};
+
+inline bool headerNameIs(const char* name, size_t length, const char* lowercase) {
+    return reflection::numeric::equalsIgnoreCase(name, length, lowercase, strlen(lowercase));
+}
+
+// true if a comma-separated header value has the token (case-insensitive)
+inline bool headerHasToken(const char* value, size_t length, const char* lowercase) {
+    const char* p = value;
+    const char* end = value + length;
+
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ','))
+            p++;
+
+        const char* token = p;
+
+        while (p < end && *p != ',')
+            p++;
+
+        const char* tokenEnd = p;
+
+        while (tokenEnd > token && (tokenEnd[-1] == ' ' || tokenEnd[-1] == '\t'))
+            tokenEnd--;
+
+        if (headerNameIs(token, tokenEnd - token, lowercase))
+            return true;
+    }
+
+    return false;
+}
+
+// the "\r\n" ending the line that starts at line, before end; nullptr if there is none or a bare '\r' comes first
+inline const char* findLineEnd(const char* line, const char* end) {
+    const char* lineEnd = (const char*) memchr(line, '\r', end - line);
+
+    if (lineEnd == nullptr || end - lineEnd < 2 || lineEnd[1] != '\n')
+        return nullptr;
+
+    return lineEnd;
+}
+
+// Parses the request line and headers ending at headerEnd (the "\r\n\r\n"); false if malformed
+inline bool parseRequestHead(const char* head, const char* headerEnd, HttpRequest_t& request_out) {
+    const char* lineEnd = findLineEnd(head, headerEnd + 2);
+
+    if (lineEnd == nullptr)
+        return false;
+
+    const char* methodEnd = (const char*) memchr(head, ' ', lineEnd - head);
+
+    if (methodEnd == nullptr || methodEnd == head)
+        return false;
+
+    const char* versionStart = (const char*) memrchr(methodEnd + 1, ' ', lineEnd - (methodEnd + 1));
+
+    if (versionStart == nullptr || lineEnd - versionStart != 9 || memcmp(versionStart + 1, "HTTP/1.", 7) != 0)
+        return false;
+
+    request_out.method = head;
+    request_out.methodLength = methodEnd - head;
+    request_out.headerSize = headerEnd + 4 - head;
+    request_out.contentLength = 0;
+    request_out.keepAlive = (versionStart[8] != '0');
+    request_out.expectContinue = false;
+    request_out.chunked = false;
+
+    for (const char* line = lineEnd + 2; line < headerEnd + 2; line = lineEnd + 2) {
+        lineEnd = findLineEnd(line, headerEnd + 2);
+
+        if (lineEnd == nullptr)
+            return false;
+
+        const char* colon = (const char*) memchr(line, ':', lineEnd - line);
+
+        if (colon == nullptr || colon == line)
+            return false;
+
+        const char* value = colon + 1;
+
+        while (value < lineEnd && (*value == ' ' || *value == '\t'))
+            value++;
+
+        const size_t nameLength = colon - line;
+        const size_t valueLength = lineEnd - value;
+
+        if (headerNameIs(line, nameLength, "content-length")) {
+            if (reflection::parseInteger(value, valueLength, request_out.contentLength) != reflection::PARSE_OK)
+                return false;
+        }
+        else if (headerNameIs(line, nameLength, "connection")) {
+            if (headerHasToken(value, valueLength, "close"))
+                request_out.keepAlive = false;
+            else if (headerHasToken(value, valueLength, "keep-alive"))
+                request_out.keepAlive = true;
+        }
+        else if (headerNameIs(line, nameLength, "transfer-encoding"))
+            request_out.chunked = true;
+        else if (headerNameIs(line, nameLength, "expect"))
+            request_out.expectContinue = headerHasToken(value, valueLength, "100-continue");
+    }
+
+    return true;
+}
+
+class JsonRpcHttpProtocol : public rpc_socket::RpcServer::IStreamProtocol {
+public:
+    explicit JsonRpcHttpProtocol(const rpc_json::JsonRpcFunction_t* entries)
+            : err(reflection::err), allowOrigin(nullptr), maxBodySize(DEFAULT_MAX_BODY_SIZE), dispatcher(entries) {}
+
+    virtual ssize_t consume(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection,
+            const uint8_t* data, size_t size, utility::MemoryReaderWriter& output) override {
+        size_t used = 0;
+
+        // every complete request in the buffer, in order
+        while (used < size) {
+            const char* head = (const char*) data + used;
+            const size_t available = size - used;
+            const char* headerEnd = (const char*) memmem(head, available, "\r\n\r\n", 4);
+
+            if (headerEnd == nullptr) {
+                if (available > MAX_HEADER_SIZE)
+                    return fail(server, connection, output, size, "431 Request Header Fields Too Large");
+
+                break;
+            }
+
+            HttpRequest_t request;
+
+            if (!parseRequestHead(head, headerEnd, request))
+                return fail(server, connection, output, size, "400 Bad Request");
+
+            if (request.chunked)
+                return fail(server, connection, output, size, "501 Not Implemented");
+
+            if (request.contentLength > maxBodySize)
+                return fail(server, connection, output, size, "413 Payload Too Large");
+
+            if (available - request.headerSize < request.contentLength) {
+                // the client waits for this before sending the body
+                if (request.expectContinue && available == request.headerSize
+                        && !write(output, "HTTP/1.1 100 Continue\r\n\r\n", 25))
+                    return -1;
+
+                break;
+            }
+
+            if (!respond(request, head + request.headerSize, output))
+                return -1;
+
+            used += request.headerSize + (size_t) request.contentLength;
+
+            if (!request.keepAlive) {
+                server.postClose(connection);
+                return size;
+            }
+        }
+
+        return used;
+    }
+
+    reflection::IErrorHandler* err;
+
+    const char* allowOrigin;        // Access-Control-Allow-Origin for browsers on other origins; nullptr for none
+    size_t maxBodySize;
+
+private:
+    bool write(utility::MemoryReaderWriter& output, const char* text, size_t length) {
+        return output.write(err, text, length);
+    }
+
+    bool writeHead(utility::MemoryReaderWriter& output, const char* status, size_t contentLength, bool keepAlive,
+            const char* extraHeaders = "") {
+        char head[512];
+        int length = snprintf(head, sizeof(head), "HTTP/1.1 %s\r\n%s%s%s%sContent-Length: %u\r\n%s\r\n", status,
+                allowOrigin ? "Access-Control-Allow-Origin: " : "", allowOrigin ? allowOrigin : "", allowOrigin ? "\r\n" : "",
+                extraHeaders, unsigned(contentLength), keepAlive ? "" : "Connection: close\r\n");
+
+        if (length < 0 || (size_t) length >= sizeof(head))
+            return err->error("InvalidArgument", "HTTP response header too long"), false;
+
+        return write(output, head, (size_t) length);
+    }
+
+    bool respond(const HttpRequest_t& request, const char* body, utility::MemoryReaderWriter& output) {
+        if (headerNameIs(request.method, request.methodLength, "options")) {
+            // CORS preflight
+            return writeHead(output, "204 No Content", 0, request.keepAlive,
+                    "Allow: POST, OPTIONS\r\nAccess-Control-Allow-Methods: POST, OPTIONS\r\n"
+                    "Access-Control-Allow-Headers: Content-Type\r\n");
+        }
+
+        if (request.methodLength != 4 || memcmp(request.method, "POST", 4) != 0)
+            return writeHead(output, "405 Method Not Allowed", 0, request.keepAlive, "Allow: POST, OPTIONS\r\n");
+
+        response.length = 0;
+
+        if (!dispatcher.handle(body, (size_t) request.contentLength, response))
+            return false;
+
+        if (response.length == 0)
+            return writeHead(output, "204 No Content", 0, request.keepAlive);
+
+        return writeHead(output, "200 OK", response.length, request.keepAlive, "Content-Type: application/json\r\n")
+                && write(output, response.buf, response.length);
+    }
+
+    // answers with an error status and closes the connection; the rest of the input is dropped
+    ssize_t fail(rpc_socket::RpcServer& server, rpc_socket::ConnectionId_t connection,
+            utility::MemoryReaderWriter& output, size_t size, const char* status) {
+        if (!writeHead(output, status, 0, false))
+            return -1;
+
+        server.postClose(connection);
+        return size;
+    }
+
+    rpc_json::JsonRpcDispatcher dispatcher;
+    reflection::StringBuilder_t response;
+};
+}
@@ -0,0 +1,908 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// JSON-RPC 2.0 (https://www.jsonrpc.org/specification) for functions exported in a JSON RPC table.
+// Arguments and results are converted by JsonCodec according to their C++ types: numbers, bool,
+// std::string, std::vector and reflected classes (as objects keyed by field name). Parameters go by
+// position, or as an object for functions taking a single argument. Transport-independent; see
+// rpc_http.hpp for an HTTP server.
+
+#include <extras/basic_rpc_dispatcher.hpp>
+
+#include <reflection/dump.hpp>
+#include <reflection/numeric.hpp>
+
+#include <string>
+#include <vector>
+
+#define BEGIN_JSON_RPC_TABLE(rpcTable_) ::rpc_json::JsonRpcFunction_t rpcTable_[] = {\
+
+#define JSON_RPC_TABLE_ENTRY(name_, function_)\
+    {name_, GET_RPC_EXECUTE(::rpc_json::JsonCallHandler, function_), ::reflection::hashClassId(name_)},
+
+#define END_JSON_RPC_TABLE {}};\
+
+namespace rpc_json {
+using reflection::StringBuilder_t;
+
+enum JsonType_t : uint8_t {
+    JSON_NULL,
+    JSON_FALSE,
+    JSON_TRUE,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT,
+};
+
+enum {
+    JSON_RPC_PARSE_ERROR = -32700,
+    JSON_RPC_INVALID_REQUEST = -32600,
+    JSON_RPC_METHOD_NOT_FOUND = -32601,
+    JSON_RPC_INVALID_PARAMS = -32602,
+    JSON_RPC_INTERNAL_ERROR = -32603,
+
+    MAX_JSON_DEPTH = 64,
+};
+
+// One value of a parsed document. Nodes are stored in document order, so the contents of an array or
+// object directly follow it; an object member is a JSON_STRING key node followed by the value.
+struct JsonValue_t {
+    JsonType_t type;
+    uint32_t count;         // JSON_ARRAY: elements, JSON_OBJECT: members
+    uint32_t end;           // index of the first node after this value and its contents
+    const char* text;       // JSON_STRING: unescaped, nul-terminated; JSON_NUMBER: as written
+    size_t length;          // of text
+};
+
+// Parses into a flat node array. Both the node array and the text storage are kept between documents.
+class JsonDocument {
+public:
+    JsonDocument() : errorOffset(0), errorMessage(nullptr) {}
+
+    // Parses a copy of json; on failure, errorOffset and errorMessage tell what was wrong
+    bool parse(const char* json, size_t length) {
+        nodes.clear();
+        text.assign(json, json + length);
+        text.push_back(0);
+
+        const char* p = text.data();
+        const char* end = p + length;
+        errorMessage = nullptr;
+
+        if (!parseValue(p, end, 0))
+            return false;
+
+        skipSpace(p, end);
+
+        if (p != end)
+            return fail(p, "Trailing characters after the document");
+
+        return true;
+    }
+
+    const JsonValue_t& root() const { return nodes[0]; }
+
+    // index of a value, for stepping through its contents: the first element of an array (or the first
+    // key of an object) is at index + 1, and nodes[i].end is the index of whatever follows node i
+    size_t indexOf(const JsonValue_t& value) const { return &value - nodes.data(); }
+    const JsonValue_t& operator [](size_t index) const { return nodes[index]; }
+
+    // value of an object member, or nullptr
+    const JsonValue_t* member(const JsonValue_t& object, const char* name) const {
+        if (object.type != JSON_OBJECT)
+            return nullptr;
+
+        size_t index = indexOf(object) + 1;
+
+        for (uint32_t i = 0; i < object.count; i++) {
+            const JsonValue_t& key = nodes[index];
+
+            if (strcmp(key.text, name) == 0)
+                return &nodes[index + 1];
+
+            index = nodes[index + 1].end;
+        }
+
+        return nullptr;
+    }
+
+    size_t errorOffset;
+    const char* errorMessage;
+
+private:
+    static void skipSpace(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            p++;
+    }
+
+    bool fail(const char* p, const char* message) {
+        errorOffset = p - text.data();
+        errorMessage = message;
+        return false;
+    }
+
+    size_t addNode(JsonType_t type, const char* text, size_t length) {
+        JsonValue_t node = { type, 0, 0, text, length };
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+    bool parseLiteral(const char*& p, const char* end, const char* literal, size_t length, JsonType_t type) {
+        if ((size_t) (end - p) < length || memcmp(p, literal, length) != 0)
+            return fail(p, "Invalid literal");
+
+        nodes[addNode(type, nullptr, 0)].end = (uint32_t) nodes.size();
+        p += length;
+        return true;
+    }
+
+    bool parseValue(const char*& p, const char* end, int depth) {
+        skipSpace(p, end);
+
+        if (p == end)
+            return fail(p, "Unexpected end of document");
+
+        switch (*p) {
+            case '{':
+            case '[':
+                return parseContainer(p, end, depth);
+
+            case '"':
+                return parseString(p, end);
+
+            case 't': return parseLiteral(p, end, "true", 4, JSON_TRUE);
+            case 'f': return parseLiteral(p, end, "false", 5, JSON_FALSE);
+            case 'n': return parseLiteral(p, end, "null", 4, JSON_NULL);
+
+            default:
+                return parseNumber(p, end);
+        }
+    }
+
+    bool parseContainer(const char*& p, const char* end, int depth) {
+        if (depth >= MAX_JSON_DEPTH)
+            return fail(p, "Nested too deeply");
+
+        const bool isObject = (*p++ == '{');
+        const char close = isObject ? '}' : ']';
+        const size_t index = addNode(isObject ? JSON_OBJECT : JSON_ARRAY, nullptr, 0);
+        uint32_t count = 0;
+
+        skipSpace(p, end);
+
+        if (p < end && *p == close) {
+            p++;
+        }
+        else {
+            for (;;) {
+                if (isObject) {
+                    skipSpace(p, end);
+
+                    if (p == end || *p != '"')
+                        return fail(p, "Expected a member name");
+
+                    if (!parseString(p, end))
+                        return false;
+
+                    skipSpace(p, end);
+
+                    if (p == end || *p != ':')
+                        return fail(p, "Expected ':'");
+
+                    p++;
+                }
+
+                if (!parseValue(p, end, depth + 1))
+                    return false;
+
+                count++;
+                skipSpace(p, end);
+
+                if (p < end && *p == ',') {
+                    p++;
+                    continue;
+                }
+
+                if (p < end && *p == close) {
+                    p++;
+                    break;
+                }
+
+                return fail(p, isObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+            }
+        }
+
+        nodes[index].count = count;
+        nodes[index].end = (uint32_t) nodes.size();
+        return true;
+    }
+
+    static void putUtf8(char*& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            *out++ = (char) codePoint;
+        }
+        else if (codePoint < 0x800) {
+            *out++ = (char) (0xC0 | (codePoint >> 6));
+            *out++ = (char) (0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            *out++ = (char) (0xE0 | (codePoint >> 12));
+            *out++ = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+            *out++ = (char) (0x80 | (codePoint & 0x3F));
+        }
+        else {
+            *out++ = (char) (0xF0 | (codePoint >> 18));
+            *out++ = (char) (0x80 | ((codePoint >> 12) & 0x3F));
+            *out++ = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+            *out++ = (char) (0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    static bool parseHex4(const char* p, const char* end, uint32_t& value_out) {
+        if (end - p < 4)
+            return false;
+
+        value_out = 0;
+
+        for (int i = 0; i < 4; i++) {
+            const int digit = reflection::numeric::digitValue(p[i]);
+
+            if (digit > 15)
+                return false;
+
+            value_out = (value_out << 4) | (uint32_t) digit;
+        }
+
+        return true;
+    }
+
+    // unescapes in place: the result is never longer than the escaped form, and the closing quote
+    // becomes the terminating nul
+    bool parseString(const char*& p, const char* end) {
+        char* const start = const_cast<char*>(++p);
+        char* out = start;
+
+        for (;;) {
+            // copy plain characters in one go
+            const char* run = p;
+
+            while (p < end && *p != '"' && *p != '\\' && (unsigned char) *p >= 0x20)
+                p++;
+
+            if (out != run)
+                memmove(out, run, p - run);
+
+            out += p - run;
+
+            if (p == end)
+                return fail(p, "Unterminated string");
+
+            if (*p == '"')
+                break;
+
+            if (*p != '\\')
+                return fail(p, "Control character in string");
+
+            if (++p == end)
+                return fail(p, "Unterminated string");
+
+            switch (*p++) {
+                case '"':   *out++ = '"'; break;
+                case '\\':  *out++ = '\\'; break;
+                case '/':   *out++ = '/'; break;
+                case 'b':   *out++ = '\b'; break;
+                case 'f':   *out++ = '\f'; break;
+                case 'n':   *out++ = '\n'; break;
+                case 'r':   *out++ = '\r'; break;
+                case 't':   *out++ = '\t'; break;
+
+                case 'u': {
+                    uint32_t codePoint, low;
+
+                    if (!parseHex4(p, end, codePoint))
+                        return fail(p, "Invalid \\u escape");
+
+                    p += 4;
+
+                    // a surrogate pair encodes one code point
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u'
+                            && parseHex4(p + 2, end, low) && low >= 0xDC00 && low < 0xE000) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    else if (codePoint >= 0xD800 && codePoint < 0xE000)
+                        codePoint = 0xFFFD;
+
+                    putUtf8(out, codePoint);
+                    break;
+                }
+
+                default:
+                    return fail(p - 1, "Invalid escape");
+            }
+        }
+
+        *out = 0;
+        p++;
+        addNode(JSON_STRING, start, out - start);
+        nodes.back().end = (uint32_t) nodes.size();
+        return true;
+    }
+
+    bool parseNumber(const char*& p, const char* end) {
+        using reflection::numeric::isDigit;
+        const char* start = p;
+
+        if (p < end && *p == '-')
+            p++;
+
+        if (p < end && *p == '0')
+            p++;
+        else if (p < end && isDigit(*p)) {
+            while (p < end && isDigit(*p))
+                p++;
+        }
+        else
+            return fail(start, "Unexpected character");
+
+        if (p < end && *p == '.') {
+            if (++p == end || !isDigit(*p))
+                return fail(p, "Invalid number");
+
+            while (p < end && isDigit(*p))
+                p++;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+
+            if (p < end && (*p == '+' || *p == '-'))
+                p++;
+
+            if (p == end || !isDigit(*p))
+                return fail(p, "Invalid number");
+
+            while (p < end && isDigit(*p))
+                p++;
+        }
+
+        addNode(JSON_NUMBER, start, p - start);
+        nodes.back().end = (uint32_t) nodes.size();
+        return true;
+    }
+
+    std::vector<JsonValue_t> nodes;
+    std::vector<char> text;
+};
+
+// ====================================================================== //
+//  conversion of C++ values
+// ====================================================================== //
+
+inline bool appendJsonString(reflection::IErrorHandler* err, StringBuilder_t& out, const char* str, size_t length) {
+    return stringBuilderAppendChar(err, out, '"') && reflection::appendJsonStringBody(err, out, str, length)
+            && stringBuilderAppendChar(err, out, '"');
+}
+
+template <typename T, typename = void>
+struct IsReflectedClass_ : std::false_type {};
+
+template <typename T>
+struct IsReflectedClass_<T, decltype((void) T::template reflection_s_getFields<T>(REFL_MATCH))> : std::true_type {};
+
+template <typename T>
+struct DependentFalse_ : std::false_type {};
+
+// Converts between a C++ type and JSON. read() only fails on a value of the wrong kind.
+// Types not handled below don't compile; dependencies and resources of reflected classes are skipped.
+template <typename T, typename = void>
+struct JsonCodec {
+    typedef void Unsupported_;
+
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, T& value_out) {
+        static_assert(DependentFalse_<T>::value, "Type cannot be converted to JSON");
+        return false;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, const T& value) {
+        static_assert(DependentFalse_<T>::value, "Type cannot be converted to JSON");
+        return false;
+    }
+};
+
+template <>
+struct JsonCodec<bool> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, bool& value_out) {
+        if (value.type != JSON_TRUE && value.type != JSON_FALSE)
+            return false;
+
+        value_out = (value.type == JSON_TRUE);
+        return true;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, bool value) {
+        return value ? stringBuilderAppend(err, out, "true", 4) : stringBuilderAppend(err, out, "false", 5);
+    }
+};
+
+template <typename T>
+struct JsonCodec<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, T& value_out) {
+        return value.type == JSON_NUMBER && reflection::parseInteger(value.text, value.length, value_out) == reflection::PARSE_OK;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, T value) {
+        if (!stringBuilderReserve(err, out, reflection::MAX_INTEGER_CHARS))
+            return false;
+
+        out.length += reflection::formatInteger(out.buf + out.length, value);
+        out.buf[out.length] = 0;
+        return true;
+    }
+};
+
+template <typename T>
+struct JsonCodec<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, T& value_out) {
+        return value.type == JSON_NUMBER && reflection::parseFloat(value.text, value.length, value_out) == reflection::PARSE_OK;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, T value) {
+        // JSON has no representation for these
+        if (value != value || value - value != 0)
+            return stringBuilderAppend(err, out, "null", 4);
+
+        if (!stringBuilderReserve(err, out, reflection::MAX_FLOAT_CHARS))
+            return false;
+
+        out.length += reflection::formatFloat(out.buf + out.length, value);
+        out.buf[out.length] = 0;
+        return true;
+    }
+};
+
+template <>
+struct JsonCodec<std::string> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, std::string& value_out) {
+        if (value.type != JSON_STRING)
+            return false;
+
+        value_out.assign(value.text, value.length);
+        return true;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, const std::string& value) {
+        return appendJsonString(err, out, value.data(), value.length());
+    }
+};
+
+template <typename T>
+struct JsonCodec<std::vector<T>> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, std::vector<T>& value_out) {
+        if (value.type != JSON_ARRAY)
+            return false;
+
+        value_out.clear();
+        value_out.resize(value.count);
+        size_t index = doc.indexOf(value) + 1;
+
+        for (uint32_t i = 0; i < value.count; i++) {
+            if (!JsonCodec<T>::read(doc, doc[index], value_out[i]))
+                return false;
+
+            index = doc[index].end;
+        }
+
+        return true;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, const std::vector<T>& value) {
+        if (!stringBuilderAppendChar(err, out, '['))
+            return false;
+
+        for (size_t i = 0; i < value.size(); i++) {
+            if (i > 0 && !stringBuilderAppendChar(err, out, ','))
+                return false;
+
+            if (!JsonCodec<T>::write(err, out, value[i]))
+                return false;
+        }
+
+        return stringBuilderAppendChar(err, out, ']');
+    }
+};
+
+// state and configuration fields; the others are not part of a value
+inline bool isJsonField(uint32_t systemFlags) {
+    return (systemFlags & (reflection::FIELD_STATE | reflection::FIELD_CONFIG)) != 0;
+}
+
+template <typename T, typename = void>
+struct IsJsonConvertible_ : std::true_type {};
+
+template <typename T>
+struct IsJsonConvertible_<T, typename JsonCodec<T>::Unsupported_> : std::false_type {};
+
+template <typename T>
+struct IsJsonConvertible_<std::vector<T>> : IsJsonConvertible_<T> {};
+
+// Whether a field is part of a value is only known at run time, so fields of types without a
+// JsonCodec compile, and fail when they are state or configuration
+template <typename T, bool = IsJsonConvertible_<T>::value>
+struct JsonFieldCodec_ : JsonCodec<T> {};
+
+template <typename T>
+struct JsonFieldCodec_<T, false> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, T& value_out) { return false; }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, const T& value) {
+        return err->error("UnsupportedType", "Type cannot be converted to JSON"), false;
+    }
+};
+
+// members missing from the object keep their value, unknown members are ignored
+struct JsonFieldReader_ {
+    const JsonDocument& doc;
+    const JsonValue_t& object;
+    bool ok;
+
+    template <typename T>
+    void operator()(T& value, const char* name, uint32_t systemFlags, uint32_t flags) {
+        if (!ok || !isJsonField(systemFlags))
+            return;
+
+        const JsonValue_t* member = doc.member(object, name);
+
+        if (member != nullptr && !JsonFieldCodec_<T>::read(doc, *member, value))
+            ok = false;
+    }
+};
+
+struct JsonFieldWriter_ {
+    reflection::IErrorHandler* err;
+    StringBuilder_t& out;
+    bool first, ok;
+
+    template <typename T>
+    void operator()(const T& value, const char* name, uint32_t systemFlags, uint32_t flags) {
+        if (!ok || !isJsonField(systemFlags))
+            return;
+
+        ok = (first || stringBuilderAppendChar(err, out, ','))
+                && appendJsonString(err, out, name, strlen(name))
+                && stringBuilderAppendChar(err, out, ':')
+                && JsonFieldCodec_<T>::write(err, out, value);
+        first = false;
+    }
+};
+
+template <typename T>
+struct JsonCodec<T, typename std::enable_if<IsReflectedClass_<T>::value>::type> {
+    static bool read(const JsonDocument& doc, const JsonValue_t& value, T& value_out) {
+        if (value.type != JSON_OBJECT)
+            return false;
+
+        JsonFieldReader_ reader = { doc, value, true };
+        reflection::reflectVisit(value_out, reader);
+        return reader.ok;
+    }
+
+    static bool write(reflection::IErrorHandler* err, StringBuilder_t& out, const T& value) {
+        JsonFieldWriter_ writer = { err, out, true, true };
+
+        if (!stringBuilderAppendChar(err, out, '{'))
+            return false;
+
+        reflection::reflectVisit(value, writer);
+        return writer.ok && stringBuilderAppendChar(err, out, '}');
+    }
+};
+
+// ====================================================================== //
+//  calls
+// ====================================================================== //
+
+// Passed to the functions generated by GET_RPC_EXECUTE: takes the arguments from the "params" of a
+// request and writes the "result" member of the response
+class JsonCallHandler {
+public:
+    JsonCallHandler(const JsonDocument& doc, const JsonValue_t* params, StringBuilder_t& out)
+            : err(reflection::err), errorCode(0), errorMessage(nullptr),
+            doc(doc), params(params), out(out), numTaken(0), nextIndex(params ? doc.indexOf(*params) + 1 : 0) {}
+
+    bool begin() {
+        return true;
+    }
+
+    template <typename T>
+    bool getArgument(T& value_out) {
+        const JsonValue_t* argument = nextArgument();
+
+        if (argument == nullptr)
+            return fail(JSON_RPC_INVALID_PARAMS, "Invalid params: too few parameters");
+
+        if (!JsonCodec<T>::read(doc, *argument, value_out))
+            return fail(JSON_RPC_INVALID_PARAMS, "Invalid params: parameter of the wrong type");
+
+        return true;
+    }
+
+    template <typename T>
+    bool end(const T& result) {
+        if (!checkAllTaken())
+            return false;
+
+        if (!stringBuilderAppend(err, out, "\"result\":", 9) || !JsonCodec<T>::write(err, out, result))
+            return fail(JSON_RPC_INTERNAL_ERROR, "Internal error: result cannot be converted");
+
+        return true;
+    }
+
+    bool end() {
+        return checkAllTaken() && stringBuilderAppend(err, out, "\"result\":null", 13);
+    }
+
+    reflection::IErrorHandler* err;
+
+    int errorCode;                  // JSON_RPC_* when the call failed
+    const char* errorMessage;
+
+private:
+    bool fail(int code, const char* message) {
+        errorCode = code;
+        errorMessage = message;
+        return false;
+    }
+
+    // by position from an array; an object is the single argument
+    const JsonValue_t* nextArgument() {
+        if (params == nullptr)
+            return nullptr;
+
+        if (params->type == JSON_OBJECT)
+            return (numTaken++ == 0) ? params : nullptr;
+
+        if (numTaken >= params->count)
+            return nullptr;
+
+        const JsonValue_t* argument = &doc[nextIndex];
+        nextIndex = argument->end;
+        numTaken++;
+        return argument;
+    }
+
+    bool checkAllTaken() {
+        bool allTaken = true;
+
+        if (params != nullptr && params->type == JSON_OBJECT)
+            allTaken = (numTaken == 1 || params->count == 0);
+        else if (params != nullptr)
+            allTaken = (numTaken == params->count);
+
+        return allTaken || fail(JSON_RPC_INVALID_PARAMS, "Invalid params: too many parameters");
+    }
+
+    const JsonDocument& doc;
+    const JsonValue_t* params;
+    StringBuilder_t& out;
+    uint32_t numTaken;
+    size_t nextIndex;
+};
+
+struct JsonRpcFunction_t {
+    const char* functionName;
+    bool (*callback)(JsonCallHandler& handler);
+    uint64_t nameHash;
+};
+
+// Handles request documents for one table. Not thread-safe (it keeps its parsing buffers); use one per thread.
+class JsonRpcDispatcher {
+public:
+    explicit JsonRpcDispatcher(const JsonRpcFunction_t* entries) : err(reflection::err), entries(entries) {
+        size_t count = 0;
+
+        while (entries[count].functionName != nullptr)
+            count++;
+
+        size_t capacity = 16;
+
+        while (capacity < count * 2)
+            capacity *= 2;
+
+        slots.assign(capacity, nullptr);
+        mask = capacity - 1;
+
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = (size_t) entries[i].nameHash & mask;
+
+            // the first of duplicate names wins
+            while (slots[slot] != nullptr && strcmp(slots[slot]->functionName, entries[i].functionName) != 0)
+                slot = (slot + 1) & mask;
+
+            if (slots[slot] == nullptr)
+                slots[slot] = &entries[i];
+        }
+    }
+
+    JsonRpcDispatcher(const JsonRpcDispatcher&) = delete;
+
+    const JsonRpcFunction_t* find(const char* functionName) const {
+        size_t slot = (size_t) basic_rpc_dispatcher::hashFunctionName(functionName) & mask;
+
+        for (; slots[slot] != nullptr; slot = (slot + 1) & mask) {
+            if (strcmp(slots[slot]->functionName, functionName) == 0)
+                return slots[slot];
+        }
+
+        return nullptr;
+    }
+
+    // Handles a request or a batch and appends the response to out, which must not have a sink
+    // (responses are rolled back on failure). Appends nothing if the request only held notifications.
+    // Returns false only if out could not be written.
+    bool handle(const char* request, size_t length, StringBuilder_t& out) {
+        if (!doc.parse(request, length))
+            return writeError(out, nullptr, JSON_RPC_PARSE_ERROR, "Parse error");
+
+        const JsonValue_t& root = doc.root();
+
+        if (root.type != JSON_ARRAY)
+            return handleCall(root, out, false);
+
+        if (root.count == 0)
+            return writeError(out, nullptr, JSON_RPC_INVALID_REQUEST, "Invalid Request: empty batch");
+
+        const size_t start = out.length;
+
+        if (!stringBuilderAppendChar(err, out, '['))
+            return false;
+
+        const size_t empty = out.length;
+        size_t index = doc.indexOf(root) + 1;
+
+        for (uint32_t i = 0; i < root.count; i++) {
+            if (!handleCall(doc[index], out, out.length != empty))
+                return false;
+
+            index = doc[index].end;
+        }
+
+        if (out.length == empty) {
+            // notifications only
+            truncate(out, start);
+            return true;
+        }
+
+        return stringBuilderAppendChar(err, out, ']');
+    }
+
+    reflection::IErrorHandler* err;
+
+private:
+    static void truncate(StringBuilder_t& out, size_t length) {
+        out.length = length;
+
+        if (out.buf != nullptr)
+            out.buf[length] = 0;
+    }
+
+    bool handleCall(const JsonValue_t& call, StringBuilder_t& out, bool separator) {
+        const size_t rollback = out.length;
+
+        if (separator && !stringBuilderAppendChar(err, out, ','))
+            return false;
+
+        const JsonValue_t* version = doc.member(call, "jsonrpc");
+        const JsonValue_t* method = doc.member(call, "method");
+        const JsonValue_t* params = doc.member(call, "params");
+        const JsonValue_t* id = doc.member(call, "id");
+
+        if (call.type != JSON_OBJECT || version == nullptr || version->type != JSON_STRING
+                || strcmp(version->text, "2.0") != 0 || method == nullptr || method->type != JSON_STRING
+                || (params != nullptr && params->type != JSON_ARRAY && params->type != JSON_OBJECT)
+                || (id != nullptr && id->type != JSON_STRING && id->type != JSON_NUMBER && id->type != JSON_NULL))
+            return writeError(out, isValidId(id) ? id : nullptr, JSON_RPC_INVALID_REQUEST, "Invalid Request");
+
+        const JsonRpcFunction_t* function = find(method->text);
+
+        if (function == nullptr) {
+            if (id == nullptr)
+                return truncate(out, rollback), true;
+
+            return writeError(out, id, JSON_RPC_METHOD_NOT_FOUND, "Method not found");
+        }
+
+        if (!stringBuilderAppend(err, out, "{\"jsonrpc\":\"2.0\",", 17))
+            return false;
+
+        const size_t resultStart = out.length;
+        JsonCallHandler handler(doc, params, out);
+
+        if (!function->callback(handler)) {
+            truncate(out, resultStart);
+
+            if (id == nullptr)
+                return truncate(out, rollback), true;
+
+            const int code = (handler.errorCode != 0) ? handler.errorCode : JSON_RPC_INTERNAL_ERROR;
+            return writeErrorMember(out, code, handler.errorMessage ? handler.errorMessage : "Internal error")
+                    && writeIdMember(out, id);
+        }
+
+        // notifications are executed, but not answered
+        if (id == nullptr)
+            return truncate(out, rollback), true;
+
+        return writeIdMember(out, id);
+    }
+
+    static bool isValidId(const JsonValue_t* id) {
+        return id != nullptr && (id->type == JSON_STRING || id->type == JSON_NUMBER);
+    }
+
+    bool writeError(StringBuilder_t& out, const JsonValue_t* id, int code, const char* message) {
+        return stringBuilderAppend(err, out, "{\"jsonrpc\":\"2.0\",", 17)
+                && writeErrorMember(out, code, message)
+                && writeIdMember(out, id);
+    }
+
+    bool writeErrorMember(StringBuilder_t& out, int code, const char* message) {
+        return stringBuilderAppend(err, out, "\"error\":{\"code\":", 16)
+                && JsonCodec<int>::write(err, out, code)
+                && stringBuilderAppend(err, out, ",\"message\":", 11)
+                && appendJsonString(err, out, message, strlen(message))
+                && stringBuilderAppendChar(err, out, '}');
+    }
+
+    // ",id}" with the id as the client sent it
+    bool writeIdMember(StringBuilder_t& out, const JsonValue_t* id) {
+        if (!stringBuilderAppend(err, out, ",\"id\":", 6))
+            return false;
+
+        if (id == nullptr || id->type == JSON_NULL) {
+            if (!stringBuilderAppend(err, out, "null", 4))
+                return false;
+        }
+        else if (id->type == JSON_STRING) {
+            if (!appendJsonString(err, out, id->text, id->length))
+                return false;
+        }
+        else if (!stringBuilderAppend(err, out, id->text, id->length))
+            return false;
+
+        return stringBuilderAppendChar(err, out, '}');
+    }
+
+    const JsonRpcFunction_t* entries;
+    std::vector<const JsonRpcFunction_t*> slots;
+    size_t mask;
+
+    JsonDocument doc;
+};
+}
@@ -0,0 +1,561 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <reflection/rpc_stream.hpp>
+
+#include <extras/basic_rpc_dispatcher.hpp>
+#include <utility/memory_reader_writer.hpp>
+#include <utility/span_reader.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rpc_pipeline {
+// Framing for pipelined calls over one connection; all integers are little-endian.
+//
+//   request:   uint32 length, uint32 request ID, call header (see basic_rpc_dispatcher), arguments
+//   response:  uint32 length, uint32 request ID, uint8 status, result (if the function returns one)
+//
+// length counts the bytes that follow it. Every request gets a response, in any order; the request ID
+// pairs them up.
+//
+// A batch is a request whose call header names the empty function (method ID 0, name length 0):
+//
+//   batch request:     uint32 count, count x (uint32 length, call header, arguments)
+//   batch response:    count x (uint8 status, uint32 length, result)
+//
+// with the entries answered in order, in a single response frame.
+//
+// A call to a streaming function (see rpc_stream.hpp) is answered with any number of item responses, then
+// a final RESPONSE_OK response without a result, or RESPONSE_ERROR:
+//
+//   item response:     uint32 length, uint32 request ID, uint8 RESPONSE_STREAM_ITEM, item
+//
+// The server only sends items while the client has credit for them, counted in bytes of whole item
+// frames. The client grants credit with control requests, which get no response:
+//
+//   credit request:    uint32 length, uint32 request ID of the stream, STREAM_CREDIT_CALL_HEADER, uint32 bytes
+//
+// A grant of 0 bytes cancels the stream. An item may overdraw the credit left, so an item larger than
+// the whole window still goes through.
+
+typedef uint32_t RpcRequestId_t;
+
+enum {
+    FRAME_HEADER_SIZE = 8,
+    MAX_FRAME_SIZE = 64 * 1024 * 1024,
+};
+
+enum {
+    RESPONSE_OK = 0,
+    RESPONSE_ERROR = 1,
+    RESPONSE_STREAM_ITEM = 2,
+};
+
+enum {
+    DEFAULT_STREAM_WINDOW = 256 * 1024,
+};
+
+// call header of a batch
+static const uint8_t BATCH_CALL_HEADER[5] = { 0, 0, 0, 0, 0 };
+
+// call header of a credit request: the reserved function name "#credit", which no C++ function can have
+static const char STREAM_CREDIT_FUNCTION[] = "#credit";
+static const uint8_t STREAM_CREDIT_CALL_HEADER[12] = { 0, 0, 0, 0, 7, '#', 'c', 'r', 'e', 'd', 'i', 't' };
+
+inline void putUint32(uint8_t* p, uint32_t value) {
+    for (size_t i = 0; i < 4; i++)
+        p[i] = (uint8_t)(value >> (i * 8));
+}
+
+inline uint32_t getUint32(const uint8_t* p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+// Runs every entry of a batch body and appends the entry responses to response_out.
+// false if the batch is malformed; failed calls are answered with RESPONSE_ERROR.
+template <const basic_rpc_dispatcher::RpcFunction_t* entries>
+bool dispatchBatch(const uint8_t* body, size_t size, utility::MemoryReaderWriter& response_out) {
+    auto err = reflection::err;
+
+    if (size < 4)
+        return err->error("InvalidRpcFrame", "Malformed RPC batch"), false;
+
+    const uint32_t count = getUint32(body);
+    size_t pos = 4;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (size - pos < 4 || getUint32(body + pos) > size - pos - 4)
+            return err->error("InvalidRpcFrame", "Malformed RPC batch"), false;
+
+        const size_t length = getUint32(body + pos);
+        utility::SpanReader request(body + pos + 4, length);
+        pos += 4 + length;
+
+        const size_t start = response_out.writePos;
+        uint8_t header[5] = { RESPONSE_OK };
+
+        if (!response_out.write(err, header, sizeof(header)))
+            return false;
+
+        if (!basic_rpc_dispatcher::dispatchCall<entries>(&request, &response_out)) {
+            response_out.writePos = start + sizeof(header);
+            response_out.storage.buf[start] = RESPONSE_ERROR;
+        }
+
+        putUint32((uint8_t*) response_out.storage.buf + start + 1, (uint32_t)(response_out.writePos - start - 5));
+    }
+
+    return true;
+}
+
+// Server side: runs the call (or batch) in a complete request frame and appends the response frame to
+// response_out. Returns false only for a malformed frame; a failed call is answered with RESPONSE_ERROR.
+template <const basic_rpc_dispatcher::RpcFunction_t* entries>
+bool dispatchRequestFrame(const uint8_t* frame, size_t size, utility::MemoryReaderWriter& response_out) {
+    auto err = reflection::err;
+
+    if (size < FRAME_HEADER_SIZE || getUint32(frame) != size - 4)
+        return err->error("InvalidRpcFrame", "Malformed RPC request frame"), false;
+
+    // streams are not served here (their calls fail), so there is nothing to grant credit to
+    if (size - FRAME_HEADER_SIZE >= sizeof(STREAM_CREDIT_CALL_HEADER)
+            && memcmp(frame + FRAME_HEADER_SIZE, STREAM_CREDIT_CALL_HEADER, sizeof(STREAM_CREDIT_CALL_HEADER)) == 0)
+        return true;
+
+    const size_t start = response_out.writePos;
+    uint8_t header[FRAME_HEADER_SIZE + 1];
+
+    memcpy(header + 4, frame + 4, 4);
+    header[FRAME_HEADER_SIZE] = RESPONSE_OK;
+
+    if (!response_out.write(err, header, sizeof(header)))
+        return false;
+
+    const uint8_t* body = frame + FRAME_HEADER_SIZE;
+    const size_t bodySize = size - FRAME_HEADER_SIZE;
+
+    if (bodySize >= sizeof(BATCH_CALL_HEADER) && memcmp(body, BATCH_CALL_HEADER, sizeof(BATCH_CALL_HEADER)) == 0) {
+        if (!dispatchBatch<entries>(body + sizeof(BATCH_CALL_HEADER), bodySize - sizeof(BATCH_CALL_HEADER),
+                response_out)) {
+            response_out.writePos = start;
+            return false;
+        }
+    }
+    else {
+        utility::SpanReader request(body, bodySize);
+
+        if (!basic_rpc_dispatcher::dispatchCall<entries>(&request, &response_out)) {
+            response_out.writePos = start + sizeof(header);
+            response_out.storage.buf[start + FRAME_HEADER_SIZE] = RESPONSE_ERROR;
+        }
+    }
+
+    putUint32((uint8_t*) response_out.storage.buf + start, (uint32_t)(response_out.writePos - start - 4));
+    return true;
+}
+
+// Splits a byte stream into frames
+class FrameAssembler {
+public:
+    FrameAssembler() : readPos(0), corrupt(false) {}
+
+    void append(const void* data, size_t size) {
+        if (readPos > 0 && readPos == buffer.size()) {
+            buffer.clear();
+            readPos = 0;
+        }
+
+        buffer.insert(buffer.end(), (const uint8_t*) data, (const uint8_t*) data + size);
+    }
+
+    // Returns true and the next complete frame (including its length), or false if more data is needed
+    // or the stream is corrupt (see error()). The frame stays valid until the next call to append() or next().
+    bool next(const uint8_t*& frame_out, size_t& size_out) {
+        if (buffer.size() - readPos < 4)
+            return compact(), false;
+
+        const uint32_t length = getUint32(&buffer[readPos]);
+
+        if (length < FRAME_HEADER_SIZE - 4 || length > MAX_FRAME_SIZE) {
+            corrupt = true;
+            return false;
+        }
+
+        if (buffer.size() - readPos < 4 + (size_t) length)
+            return compact(), false;
+
+        frame_out = &buffer[readPos];
+        size_out = 4 + (size_t) length;
+        readPos += size_out;
+        return true;
+    }
+
+    bool error() const { return corrupt; }
+
+    // buffered bytes not taken by next() yet, for streams with framing of their own
+    const uint8_t* data() const { return buffer.data() + readPos; }
+    size_t size() const { return buffer.size() - readPos; }
+
+    void skip(size_t count) {
+        readPos += count;
+        compact();
+    }
+
+private:
+    void compact() {
+        if (readPos > 0) {
+            buffer.erase(buffer.begin(), buffer.begin() + readPos);
+            readPos = 0;
+        }
+    }
+
+    std::vector<uint8_t> buffer;
+    size_t readPos;
+    bool corrupt;
+};
+
+// Client side of a pipelined connection. Threads may share one channel: building a request is
+// serialized, waiting for the response is not. Transports implement sendFrame() and pass every
+// response frame they receive to receiveFrame().
+class PipelinedRpcChannel : public rpc::IStreamRpcChannel {
+public:
+    PipelinedRpcChannel() : err(reflection::err), streamWindow(DEFAULT_STREAM_WINDOW), nextRequestId(1) {}
+
+    virtual ~PipelinedRpcChannel() {
+        failPending();
+    }
+
+    virtual bool beginAsyncCall(const char* functionName, rpc::RpcMethodId_t methodId, bool returnsValue,
+            serialization::IWriter*& writer_out) override {
+        buildMutex.lock();
+
+        const uint8_t placeholder[FRAME_HEADER_SIZE] = {};
+        request.reset();
+
+        if (!request.write(err, placeholder, sizeof(placeholder))
+                || !basic_rpc_dispatcher::writeCallHeader(err, &request, methodId, functionName)) {
+            buildMutex.unlock();
+            return false;
+        }
+
+        writer_out = &request;
+        return true;
+    }
+
+    virtual bool submitAsyncCall(rpc::IRpcCompletion* completion) override {
+        const Pending_t entry = { completion, nullptr };
+        return submit(entry);
+    }
+
+    virtual bool submitStreamCall(rpc::IRpcStreamCompletion* completion) override {
+        const Pending_t entry = { completion, completion };
+        return submit(entry);
+    }
+
+    virtual void grantCredit(rpc::RpcStreamId_t stream, size_t bytes) override {
+        // a grant of 0 would cancel
+        if (bytes > 0)
+            sendCredit(stream, (uint32_t) std::min<size_t>(bytes, UINT32_MAX));
+    }
+
+    virtual void cancelStream(rpc::RpcStreamId_t stream) override {
+        sendCredit(stream, 0);
+    }
+
+    virtual void cancelAsyncCall() override {
+        buildMutex.unlock();
+    }
+
+    // Hands a response frame to the completion of its request
+    bool receiveFrame(const uint8_t* frame, size_t size) {
+        if (size < FRAME_HEADER_SIZE + 1 || getUint32(frame) != size - 4)
+            return err->error("InvalidRpcFrame", "Malformed RPC response frame"), false;
+
+        const RpcRequestId_t requestId = getUint32(frame + 4);
+        const uint8_t status = frame[FRAME_HEADER_SIZE];
+        Pending_t entry;
+
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            auto it = pending.find(requestId);
+
+            if (it == pending.end() || (status == RESPONSE_STREAM_ITEM && it->second.stream == nullptr))
+                return err->errorf("UnknownRpcRequestId", "Response to unknown RPC request %u", (unsigned) requestId),
+                        false;
+
+            entry = it->second;
+
+            // a stream stays pending until its final response
+            if (status != RESPONSE_STREAM_ITEM)
+                pending.erase(it);
+        }
+
+        utility::SpanReader response(frame + FRAME_HEADER_SIZE + 1, size - FRAME_HEADER_SIZE - 1);
+
+        if (status == RESPONSE_STREAM_ITEM)
+            entry.stream->item(err, &response, size);
+        else if (status == RESPONSE_OK)
+            entry.completion->complete(err, &response);
+        else
+            entry.completion->complete(err, nullptr);
+
+        return true;
+    }
+
+    // Fails all outstanding calls, e.g. when the connection is lost
+    void failPending() {
+        std::unordered_map<RpcRequestId_t, Pending_t> failed;
+
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            failed.swap(pending);
+        }
+
+        for (const auto& entry : failed)
+            entry.second.completion->complete(err, nullptr);
+    }
+
+    size_t numPending() {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        return pending.size();
+    }
+
+    reflection::IErrorHandler* err;
+    size_t streamWindow;                // bytes of items a stream may have in flight; set before starting streams
+
+protected:
+    // Sends one complete request frame; called for one frame at a time. Must not deliver the response
+    // from within the call, since completions may start new calls on this channel.
+    virtual bool sendFrame(const uint8_t* frame, size_t size) = 0;
+
+private:
+    struct Pending_t {
+        rpc::IRpcCompletion* completion;
+        rpc::IRpcStreamCompletion* stream;      // the same object for streaming calls, otherwise nullptr
+    };
+
+    bool submit(const Pending_t& entry) {
+        if (request.writePos > MAX_FRAME_SIZE) {
+            buildMutex.unlock();
+            return err->error("RpcFrameTooLarge", "RPC request exceeds the maximum frame size"), false;
+        }
+
+        const RpcRequestId_t requestId = nextRequestId++;
+
+        uint8_t* frame = (uint8_t*) request.storage.buf;
+        putUint32(frame, (uint32_t)(request.writePos - 4));
+        putUint32(frame + 4, requestId);
+
+        if (entry.stream != nullptr)
+            entry.stream->attach(this, requestId, streamWindow);
+
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            pending[requestId] = entry;
+        }
+
+        // still under buildMutex, so that frames go out whole and in order; the initial credit of a
+        // stream right behind its request
+        bool sent = sendFrame(frame, request.writePos);
+
+        if (sent && entry.stream != nullptr)
+            sent = sendCreditFrame(requestId, (uint32_t) std::min<size_t>(std::max<size_t>(streamWindow, 1), UINT32_MAX));
+
+        buildMutex.unlock();
+
+        if (!sent) {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+
+            // unless the transport has already failed it
+            if (pending.erase(requestId) > 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    void sendCredit(rpc::RpcStreamId_t stream, uint32_t bytes) {
+        std::lock_guard<std::mutex> lock(buildMutex);
+        sendCreditFrame(stream, bytes);
+    }
+
+    bool sendCreditFrame(RpcRequestId_t requestId, uint32_t bytes) {
+        uint8_t frame[FRAME_HEADER_SIZE + sizeof(STREAM_CREDIT_CALL_HEADER) + 4];
+
+        putUint32(frame, (uint32_t)(sizeof(frame) - 4));
+        putUint32(frame + 4, requestId);
+        memcpy(frame + FRAME_HEADER_SIZE, STREAM_CREDIT_CALL_HEADER, sizeof(STREAM_CREDIT_CALL_HEADER));
+        putUint32(frame + FRAME_HEADER_SIZE + sizeof(STREAM_CREDIT_CALL_HEADER), bytes);
+
+        return sendFrame(frame, sizeof(frame));
+    }
+
+    std::mutex buildMutex;
+    utility::MemoryReaderWriter request;
+    RpcRequestId_t nextRequestId;
+
+    std::mutex pendingMutex;
+    std::unordered_map<RpcRequestId_t, Pending_t> pending;
+};
+
+// Queues calls made through RPC_ASYNC / RPC_ASYNC_CALLBACK stubs on the batch and sends them to the
+// server in one request frame; their completions run in call order once the response arrives.
+// A batch is built by one thread at a time and can be reused after send().
+class RpcBatch : public rpc::IAsyncRpcChannel {
+public:
+    RpcBatch() : err(reflection::err), entryStart(0) {
+        reset();
+    }
+
+    ~RpcBatch() {
+        failQueued();
+    }
+
+    RpcBatch(const RpcBatch&) = delete;
+
+    virtual bool beginAsyncCall(const char* functionName, rpc::RpcMethodId_t methodId, bool returnsValue,
+            serialization::IWriter*& writer_out) override {
+        const uint8_t placeholder[4] = {};
+        entryStart = buffer.writePos;
+
+        if (!buffer.write(err, placeholder, sizeof(placeholder))
+                || !basic_rpc_dispatcher::writeCallHeader(err, &buffer, methodId, functionName)) {
+            buffer.writePos = entryStart;
+            return false;
+        }
+
+        writer_out = &buffer;
+        return true;
+    }
+
+    virtual bool submitAsyncCall(rpc::IRpcCompletion* completion) override {
+        putUint32((uint8_t*) buffer.storage.buf + entryStart, (uint32_t)(buffer.writePos - entryStart - 4));
+        completions.push_back(completion);
+        return true;
+    }
+
+    virtual void cancelAsyncCall() override {
+        buffer.writePos = entryStart;
+    }
+
+    size_t size() const { return completions.size(); }
+
+    // Sends the queued calls as one request on channel and empties the batch. If this fails, the queued
+    // calls are failed as well.
+    bool send(rpc::IAsyncRpcChannel& channel) {
+        if (completions.empty())
+            return true;
+
+        serialization::IWriter* writer;
+
+        if (!channel.beginAsyncCall("", 0, true, writer)) {
+            failQueued();
+            return false;
+        }
+
+        putUint32((uint8_t*) buffer.storage.buf, (uint32_t) completions.size());
+
+        if (!writer->write(err, buffer.storage.buf, buffer.writePos)) {
+            channel.cancelAsyncCall();
+            failQueued();
+            return false;
+        }
+
+        auto completion = new BatchCompletion_();
+        completion->completions.swap(completions);
+        reset();
+
+        if (!channel.submitAsyncCall(completion)) {
+            completion->complete(err, nullptr);
+            return false;
+        }
+
+        return true;
+    }
+
+    // fails and drops the queued calls
+    void failQueued() {
+        std::vector<rpc::IRpcCompletion*> failed;
+        failed.swap(completions);
+        reset();
+
+        for (auto completion : failed)
+            completion->complete(err, nullptr);
+    }
+
+    reflection::IErrorHandler* err;
+
+private:
+    // splits the batch response among the completions of its calls
+    class BatchCompletion_ : public rpc::IRpcCompletion {
+    public:
+        virtual void complete(reflection::IErrorHandler* err, serialization::IReader* response) override {
+            size_t i = 0;
+
+            for (; response != nullptr && i < completions.size(); i++) {
+                uint8_t header[5];
+
+                if (!response->read(err, header, sizeof(header)))
+                    break;
+
+                // each completion gets a reader bounded to its own result
+                const size_t length = getUint32(header + 1);
+                entry.resize(length);
+
+                if (length > 0 && !response->read(err, &entry[0], length))
+                    break;
+
+                utility::SpanReader entryReader(entry.data(), length);
+                completions[i]->complete(err, header[0] == RESPONSE_OK ? &entryReader : nullptr);
+            }
+
+            for (; i < completions.size(); i++)
+                completions[i]->complete(err, nullptr);
+
+            delete this;
+        }
+
+        std::vector<rpc::IRpcCompletion*> completions;
+        std::vector<uint8_t> entry;
+    };
+
+    void reset() {
+        const uint8_t count[4] = {};
+
+        buffer.reset();
+        buffer.write(err, count, sizeof(count));
+    }
+
+    utility::MemoryReaderWriter buffer;         // uint32 count (set by send), entries
+    size_t entryStart;
+    std::vector<rpc::IRpcCompletion*> completions;
+};
+}
@@ -0,0 +1,589 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// Shared-memory transport for RPC between processes on one host, Linux only.
+//
+// A named segment (shm_open) holds two single-producer, single-consumer rings: requests from the client
+// and responses from the server. They carry the frames of rpc_pipeline.hpp, so servers dispatch with
+// rpc_pipeline::dispatchRequestFrame<rpcTable>. A waiting side busy-polls, then yields, then sleeps on a
+// futex in the segment; the other side only makes a system call to wake it if it actually sleeps.
+// One client per segment.
+
+#include <extras/rpc_channel.hpp>
+#include <extras/rpc_pipeline.hpp>
+
+#include <atomic>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace rpc_shm {
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "shared-memory rings need lock-free atomics");
+
+enum {
+    SHM_VERSION = 2,
+    DEFAULT_RING_SIZE = 256 * 1024,
+};
+
+static const char SHM_MAGIC[8] = {'R', 'F', 'L', 'S', 'H', 'M', 'R', 0};
+
+static const uint32_t WRAP_MARKER = 0xFFFFFFFF;
+
+// how long a waiting side polls before sleeping
+struct Backoff_t {
+    unsigned spins;         // iterations of a CPU pause; spinning only helps if the peer has a core of its own
+    unsigned yields;        // sched_yield() calls
+
+    Backoff_t() : spins(sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 4000 : 0), yields(64) {}
+};
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+inline void futexWait(std::atomic<uint32_t>* word, uint32_t expected, long timeoutNs) {
+    timespec timeout = { 0, timeoutNs };
+    syscall(SYS_futex, (uint32_t*) word, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+inline void futexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, (uint32_t*) word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+// A waitable event: a futex sequence word, and a flag telling the signalling side that someone sleeps
+struct Event_t {
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> sleeping;
+
+    void signal() {
+        // pairs with the store to `sleeping` in wait(): either the waiter sees the caller's update
+        // before sleeping, or the caller sees it sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (sleeping.load() != 0) {
+            sequence.fetch_add(1);
+            futexWake(&sequence);
+        }
+    }
+
+    // Waits until ready() holds; gives up and returns false when alive() fails
+    template <typename Ready, typename Alive>
+    bool wait(const Backoff_t& backoff, Ready ready, Alive alive) {
+        for (unsigned i = 0; i < backoff.spins; i++) {
+            if (ready())
+                return true;
+
+            cpuRelax();
+        }
+
+        for (unsigned i = 0; i < backoff.yields; i++) {
+            if (ready())
+                return true;
+
+            sched_yield();
+        }
+
+        for (;;) {
+            const uint32_t observed = sequence.load();
+            sleeping.store(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (ready()) {
+                sleeping.store(0);
+                return true;
+            }
+
+            // the timeout lets a peer that died or a stop request be noticed
+            futexWait(&sequence, observed, 50 * 1000 * 1000);
+            sleeping.store(0);
+
+            if (ready())
+                return true;
+
+            if (!alive())
+                return false;
+        }
+    }
+};
+
+struct alignas(64) RingControl_t {
+    alignas(64) std::atomic<uint64_t> head;         // bytes published by the producer
+    Event_t dataEvent;                              // consumer waits for data
+    alignas(64) std::atomic<uint64_t> tail;         // bytes released by the consumer
+    Event_t spaceEvent;                             // producer waits for space
+};
+
+struct SegmentHeader_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t ringSize;                              // bytes of data per ring, a power of two
+    std::atomic<int32_t> serverPid;                 // 0 once the server has gone
+    std::atomic<int32_t> clientPid;                 // 0 while no client is attached
+    std::atomic<uint32_t> nextRequestId;            // kept across clients, so a new one never reuses an ID
+    RingControl_t requests, responses;
+    // request ring data, response ring data
+};
+
+// ring positions are masked with ringSize - 1
+inline bool validRingSize(size_t ringSize) {
+    return ringSize >= 4096 && (ringSize & (ringSize - 1)) == 0;
+}
+
+inline size_t segmentSize(size_t ringSize) {
+    return sizeof(SegmentHeader_t) + 2 * ringSize;
+}
+
+inline bool processAlive(int32_t pid) {
+    return pid != 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+// One side of a ring. Records are whole frames (which start with their own length), padded to 8 bytes;
+// a frame that would not fit before the end of the data is preceded by WRAP_MARKER and starts over at 0.
+class RingEnd_t {
+public:
+    RingEnd_t() : control(nullptr), data(nullptr), size(0), cachedHead(0), cachedTail(0), corrupt(false) {}
+
+    void attach(RingControl_t* control, uint8_t* data, size_t size) {
+        this->control = control;
+        this->data = data;
+        this->size = size;
+        cachedHead = control->head.load();
+        cachedTail = control->tail.load();
+        corrupt = false;
+    }
+
+    static size_t recordSize(size_t frameSize) {
+        return (frameSize + 7) & ~(size_t) 7;
+    }
+
+    // Producer: space for a frame of frameSize bytes, contiguous; nullptr if the consumer went away.
+    template <typename Alive>
+    uint8_t* reserve(size_t frameSize, const Backoff_t& backoff, Alive alive) {
+        const size_t need = recordSize(frameSize);
+        const uint64_t head = control->head.load(std::memory_order_relaxed);
+        const size_t pos = head & (size - 1);
+        const size_t padding = (size - pos < need) ? size - pos : 0;
+
+        auto ready = [&] {
+            cachedTail = control->tail.load(std::memory_order_acquire);
+            return size - (head - cachedTail) >= padding + need;
+        };
+
+        if (size - (head - cachedTail) < padding + need && !control->spaceEvent.wait(backoff, ready, alive))
+            return nullptr;
+
+        if (padding > 0) {
+            memcpy(data + pos, &WRAP_MARKER, sizeof(WRAP_MARKER));
+            reservedPadding = padding;
+            return data;
+        }
+
+        reservedPadding = 0;
+        return data + pos;
+    }
+
+    // Producer: makes the frame written to the reserved space visible
+    void publish(size_t frameSize) {
+        const uint64_t head = control->head.load(std::memory_order_relaxed);
+        control->head.store(head + reservedPadding + recordSize(frameSize), std::memory_order_release);
+        control->dataEvent.signal();
+    }
+
+    // Consumer: the next frame, in place; false if the producer went away or wrote a frame that doesn't
+    // fit what it published (see corrupted())
+    template <typename Alive>
+    bool peek(const uint8_t*& frame_out, size_t& size_out, const Backoff_t& backoff, Alive alive) {
+        const uint64_t tail = control->tail.load(std::memory_order_relaxed);
+
+        auto ready = [&] {
+            cachedHead = control->head.load(std::memory_order_acquire);
+            return cachedHead != tail;
+        };
+
+        if (cachedHead == tail && !control->dataEvent.wait(backoff, ready, alive))
+            return false;
+
+        size_t pos = tail & (size - 1);
+        uint32_t length;
+        memcpy(&length, data + pos, sizeof(length));
+
+        peekPadding = 0;
+
+        if (length == WRAP_MARKER) {
+            peekPadding = size - pos;
+            pos = 0;
+            memcpy(&length, data, sizeof(length));
+        }
+
+        // the length comes from the peer; a frame must lie within the ring and within what was published
+        if ((size_t) length > size - pos - 4 || peekPadding + recordSize(4 + (size_t) length) > cachedHead - tail) {
+            corrupt = true;
+            return false;
+        }
+
+        frame_out = data + pos;
+        size_out = 4 + (size_t) length;
+        return true;
+    }
+
+    // Consumer: hands the space of the frame returned by peek() back to the producer
+    void release(size_t frameSize) {
+        const uint64_t tail = control->tail.load(std::memory_order_relaxed);
+        control->tail.store(tail + peekPadding + recordSize(frameSize), std::memory_order_release);
+        control->spaceEvent.signal();
+    }
+
+    bool fits(size_t frameSize) const {
+        return recordSize(frameSize) <= size;
+    }
+
+    // the producer can't be trusted anymore
+    bool corrupted() const {
+        return corrupt;
+    }
+
+    RingControl_t* control;
+
+private:
+    uint8_t* data;
+    size_t size;
+    uint64_t cachedHead, cachedTail;
+    size_t reservedPadding = 0, peekPadding = 0;
+    bool corrupt;
+};
+
+class Segment_t {
+public:
+    Segment_t() : header(nullptr), mappedSize(0) {}
+    ~Segment_t() { unmap(); }
+
+    Segment_t(const Segment_t&) = delete;
+
+    bool create(reflection::IErrorHandler* err, const char* name, size_t ringSize) {
+        unmap();
+
+        if (!validRingSize(ringSize))
+            return err->errorf("InvalidArgument", "Ring size must be a power of two >= 4096, got %u",
+                    unsigned(ringSize)), false;
+
+        // replaces a segment left by an earlier run
+        shm_unlink(name);
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+
+        if (fd < 0)
+            return err->errorf("IOError", "shm_open `%s`: %s", name, strerror(errno)), false;
+
+        if (ftruncate(fd, (off_t) segmentSize(ringSize)) != 0 || !map(fd, segmentSize(ringSize))) {
+            err->errorf("IOError", "Failed to set up `%s`: %s", name, strerror(errno));
+            close(fd);
+            shm_unlink(name);
+            return false;
+        }
+
+        close(fd);
+
+        new (header) SegmentHeader_t();
+        header->version = SHM_VERSION;
+        header->ringSize = (uint32_t) ringSize;
+        header->serverPid = (int32_t) getpid();
+        header->clientPid = 0;
+        header->nextRequestId = 1;
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(header->magic, SHM_MAGIC, sizeof(SHM_MAGIC));
+        return true;
+    }
+
+    bool open(reflection::IErrorHandler* err, const char* name) {
+        unmap();
+
+        int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+
+        if (fd < 0)
+            return err->errorf("IOError", "shm_open `%s`: %s", name, strerror(errno)), false;
+
+        struct stat st;
+
+        if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(SegmentHeader_t) || !map(fd, (size_t) st.st_size)) {
+            close(fd);
+            return err->errorf("IOError", "Failed to map `%s`", name), false;
+        }
+
+        close(fd);
+
+        // the header is written by the server, which the client doesn't trust any more than the frames
+        if (memcmp(header->magic, SHM_MAGIC, sizeof(SHM_MAGIC)) != 0 || header->version != SHM_VERSION
+                || !validRingSize(header->ringSize) || segmentSize(header->ringSize) > mappedSize) {
+            unmap();
+            return err->errorf("InvalidSegment", "`%s` is not an RPC segment", name), false;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    uint8_t* ringData(size_t i) {
+        return (uint8_t*) (header + 1) + i * header->ringSize;
+    }
+
+    void unmap() {
+        if (header != nullptr)
+            munmap(header, mappedSize);
+
+        header = nullptr;
+        mappedSize = 0;
+    }
+
+    SegmentHeader_t* header;
+
+private:
+    bool map(int fd, size_t size) {
+        void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (view == MAP_FAILED)
+            return false;
+
+        header = (SegmentHeader_t*) view;
+        mappedSize = size;
+        return true;
+    }
+
+    size_t mappedSize;
+};
+
+// Serves one client at a time over a segment it creates and removes
+class ShmRpcServer {
+public:
+    typedef bool (*FrameHandler_t)(const uint8_t* frame, size_t size, utility::MemoryReaderWriter& response_out);
+
+    explicit ShmRpcServer(FrameHandler_t handler) : err(reflection::err), handler(handler), stopping(false) {}
+
+    ~ShmRpcServer() {
+        if (segment.header != nullptr) {
+            segment.header->serverPid = 0;
+            segment.header->requests.dataEvent.signal();
+            segment.header->responses.dataEvent.signal();
+            shm_unlink(name.c_str());
+        }
+    }
+
+    ShmRpcServer(const ShmRpcServer&) = delete;
+
+    // name as for shm_open, e.g. "/my_service"
+    bool create(const char* name, size_t ringSize = DEFAULT_RING_SIZE) {
+        if (!segment.create(err, name, ringSize))
+            return false;
+
+        this->name = name;
+        requests.attach(&segment.header->requests, segment.ringData(0), ringSize);
+        responses.attach(&segment.header->responses, segment.ringData(1), ringSize);
+        return true;
+    }
+
+    // Serves until stop() is called
+    bool run() {
+        auto alive = [this] { return !stopping; };
+
+        while (!stopping) {
+            const uint8_t* frame;
+            size_t size;
+
+            if (!requests.peek(frame, size, backoff, alive)) {
+                if (requests.corrupted())
+                    return err->error("InvalidRpcFrame", "Malformed frame in the request ring"), false;
+
+                break;
+            }
+
+            response.reset();
+            const bool ok = handler(frame, size, response);
+            requests.release(size);
+
+            if (!ok)
+                return false;
+
+            if (!responses.fits(response.writePos))
+                return err->error("RpcFrameTooLarge", "RPC response does not fit the ring"), false;
+
+            uint8_t* out = responses.reserve(response.writePos, backoff, alive);
+
+            if (out == nullptr)
+                break;
+
+            memcpy(out, response.storage.buf, response.writePos);
+            responses.publish(response.writePos);
+        }
+
+        return true;
+    }
+
+    // May be called from any thread
+    void stop() {
+        stopping = true;
+
+        if (segment.header != nullptr) {
+            // make a sleeping run() look again
+            segment.header->requests.dataEvent.sequence.fetch_add(1);
+            futexWake(&segment.header->requests.dataEvent.sequence);
+        }
+    }
+
+    reflection::IErrorHandler* err;
+    Backoff_t backoff;
+
+private:
+    FrameHandler_t handler;
+    std::atomic<bool> stopping;
+
+    std::string name;
+    Segment_t segment;
+    RingEnd_t requests, responses;
+    utility::MemoryReaderWriter response;
+};
+
+// Client for synchronous RPC_CHANNEL calls, or for RPC_SERIALIZED ones through DEFINE_RPC_GLOBAL_CHANNEL
+class ShmRpcChannel : public rpc_channel::BufferedRpcChannel {
+public:
+    ShmRpcChannel() {}
+
+    ~ShmRpcChannel() {
+        disconnect();
+    }
+
+    ShmRpcChannel(const ShmRpcChannel&) = delete;
+
+    bool connect(const char* name) {
+        disconnect();
+
+        if (!segment.open(err, name))
+            return false;
+
+        // takes over from a client that died, unless another process gets there first; responses to the
+        // calls of the dead client may still arrive and are skipped
+        int32_t expected = 0;
+
+        while (!segment.header->clientPid.compare_exchange_strong(expected, (int32_t) getpid())) {
+            if (processAlive(expected)) {
+                segment.unmap();
+                return err->errorf("SegmentInUse", "`%s` already has a client (pid %d)", name, (int) expected), false;
+            }
+        }
+
+        const size_t ringSize = segment.header->ringSize;
+        requests.attach(&segment.header->requests, segment.ringData(0), ringSize);
+        responses.attach(&segment.header->responses, segment.ringData(1), ringSize);
+        return true;
+    }
+
+    void disconnect() {
+        if (segment.header != nullptr)
+            segment.header->clientPid = 0;
+
+        segment.unmap();
+    }
+
+    Backoff_t backoff;
+
+protected:
+    virtual bool transact(utility::MemoryReaderWriter& request, utility::MemoryReaderWriter& response) override {
+        if (segment.header == nullptr)
+            return err->error("IOError", "Not connected"), false;
+
+        SegmentHeader_t* header = segment.header;
+        auto alive = [header] { return processAlive(header->serverPid.load()); };
+
+        const size_t frameSize = rpc_pipeline::FRAME_HEADER_SIZE + request.writePos;
+
+        if (!requests.fits(frameSize))
+            return err->error("RpcFrameTooLarge", "RPC request does not fit the ring"), false;
+
+        uint8_t* frame = requests.reserve(frameSize, backoff, alive);
+
+        if (frame == nullptr)
+            return err->error("IOError", "RPC server went away"), false;
+
+        const rpc_pipeline::RpcRequestId_t requestId = header->nextRequestId.fetch_add(1);
+        rpc_pipeline::putUint32(frame, (uint32_t)(frameSize - 4));
+        rpc_pipeline::putUint32(frame + 4, requestId);
+        memcpy(frame + rpc_pipeline::FRAME_HEADER_SIZE, request.storage.buf, request.writePos);
+        requests.publish(frameSize);
+
+        const uint8_t* responseFrame;
+        size_t responseSize;
+
+        for (;;) {
+            if (!responses.peek(responseFrame, responseSize, backoff, alive)) {
+                if (responses.corrupted()) {
+                    disconnect();
+                    return err->error("InvalidRpcFrame", "Malformed frame in the response ring"), false;
+                }
+
+                return err->error("IOError", "RPC server went away"), false;
+            }
+
+            // left over from a client this one took over from
+            if (responseSize >= rpc_pipeline::FRAME_HEADER_SIZE && rpc_pipeline::getUint32(responseFrame + 4) != requestId) {
+                responses.release(responseSize);
+                continue;
+            }
+
+            break;
+        }
+
+        bool ok = true;
+
+        if (responseSize < rpc_pipeline::FRAME_HEADER_SIZE + 1)
+            ok = (err->error("InvalidRpcFrame", "Unexpected RPC response"), false);
+        else if (responseFrame[rpc_pipeline::FRAME_HEADER_SIZE] != rpc_pipeline::RESPONSE_OK)
+            ok = (err->error("RpcCallFailed", "Remote call failed"), false);
+        else {
+            response.reset();
+            ok = response.write(err, responseFrame + rpc_pipeline::FRAME_HEADER_SIZE + 1,
+                    responseSize - rpc_pipeline::FRAME_HEADER_SIZE - 1);
+        }
+
+        responses.release(responseSize);
+        return ok;
+    }
+
+private:
+    Segment_t segment;
+    RingEnd_t requests, responses;
+};
+}
@@ -0,0 +1,902 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// Socket transport for pipelined RPC frames (see rpc_pipeline.hpp), Linux only.
+// Addresses are "unix:<path>" or "tcp:<host>:<port>"; a TCP port of 0 binds an ephemeral port,
+// see RpcServer::address().
+
+#include <extras/rpc_channel.hpp>
+#include <extras/rpc_pipeline.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace rpc_socket {
+struct SocketAddress_t {
+    sockaddr_storage storage;
+    socklen_t length;
+    bool isUnix;
+};
+
+inline bool socketError(reflection::IErrorHandler* err, const char* what) {
+    err->errorf("IOError", "%s: %s", what, strerror(errno));
+    return false;
+}
+
+inline bool parseAddress(reflection::IErrorHandler* err, const char* address, SocketAddress_t& address_out) {
+    memset(&address_out, 0, sizeof(address_out));
+
+    if (strncmp(address, "unix:", 5) == 0) {
+        sockaddr_un* un = (sockaddr_un*) &address_out.storage;
+        const char* path = address + 5;
+
+        if (*path == 0 || strlen(path) >= sizeof(un->sun_path))
+            return err->errorf("InvalidAddress", "Invalid Unix socket path in `%s`", address), false;
+
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, path);
+        address_out.length = sizeof(sockaddr_un);
+        address_out.isUnix = true;
+        return true;
+    }
+
+    if (strncmp(address, "tcp:", 4) == 0) {
+        const char* host = address + 4;
+        const char* colon = strrchr(host, ':');
+
+        if (colon == nullptr || colon == host || colon[1] == 0)
+            return err->errorf("InvalidAddress", "Expected tcp:<host>:<port>, got `%s`", address), false;
+
+        const std::string hostName(host, colon - host);
+
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* result;
+        int status = getaddrinfo(hostName.c_str(), colon + 1, &hints, &result);
+
+        if (status != 0)
+            return err->errorf("InvalidAddress", "Failed to resolve `%s`: %s", address, gai_strerror(status)), false;
+
+        memcpy(&address_out.storage, result->ai_addr, result->ai_addrlen);
+        address_out.length = result->ai_addrlen;
+        address_out.isUnix = false;
+        freeaddrinfo(result);
+        return true;
+    }
+
+    return err->errorf("InvalidAddress", "Unknown address `%s`, expected unix:<path> or tcp:<host>:<port>", address),
+            false;
+}
+
+inline void setNoDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// blocking connection to an RpcServer; -1 on failure
+inline int connectTo(reflection::IErrorHandler* err, const char* address) {
+    SocketAddress_t addr;
+
+    if (!parseAddress(err, address, addr))
+        return -1;
+
+    int fd = socket(addr.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (fd < 0)
+        return socketError(err, "socket"), -1;
+
+    if (connect(fd, (const sockaddr*) &addr.storage, addr.length) != 0) {
+        socketError(err, address);
+        close(fd);
+        return -1;
+    }
+
+    if (!addr.isUnix)
+        setNoDelay(fd);
+
+    return fd;
+}
+
+inline bool writeAll(reflection::IErrorHandler* err, int fd, const iovec* iov, int iovcnt) {
+    std::vector<iovec> remaining(iov, iov + iovcnt);
+    size_t first = 0;
+
+    while (first < remaining.size()) {
+        msghdr message = {};
+        message.msg_iov = &remaining[first];
+        message.msg_iovlen = remaining.size() - first;
+
+        // a peer that has gone away is reported as EPIPE instead of raising SIGPIPE
+        ssize_t written = sendmsg(fd, &message, MSG_NOSIGNAL);
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return socketError(err, "write");
+        }
+
+        while (first < remaining.size() && (size_t) written >= remaining[first].iov_len) {
+            written -= remaining[first].iov_len;
+            first++;
+        }
+
+        if (first < remaining.size()) {
+            remaining[first].iov_base = (uint8_t*) remaining[first].iov_base + written;
+            remaining[first].iov_len -= written;
+        }
+    }
+
+    return true;
+}
+
+// Reads from fd into assembler until it holds a complete frame
+inline bool readFrame(reflection::IErrorHandler* err, int fd, rpc_pipeline::FrameAssembler& assembler,
+        const uint8_t*& frame_out, size_t& size_out) {
+    uint8_t buffer[16 * 1024];
+
+    while (!assembler.next(frame_out, size_out)) {
+        if (assembler.error())
+            return err->error("InvalidRpcFrame", "Corrupt RPC frame stream"), false;
+
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        if (got < 0)
+            return socketError(err, "read");
+
+        if (got == 0)
+            return err->error("IOError", "Connection closed"), false;
+
+        assembler.append(buffer, (size_t) got);
+    }
+
+    return true;
+}
+
+typedef uint64_t ConnectionId_t;
+
+enum {
+    DEFAULT_MAX_PENDING_OUTPUT = 4 * 1024 * 1024,
+};
+
+// Non-blocking epoll server; all socket I/O happens on the thread calling run(). Every complete
+// request frame read from a connection is passed to the frame handler (normally
+// rpc_pipeline::dispatchRequestFrame<rpcTable>) or to a request executor; responses to all frames
+// from one read go out together. A connection whose peer doesn't read its responses isn't read
+// from either (see maxPendingOutput).
+class RpcServer {
+public:
+    typedef bool (*FrameHandler_t)(const uint8_t* frame, size_t size, utility::MemoryReaderWriter& response_out);
+
+    // Runs requests elsewhere: execute() either answers inline into response_out, or keeps its own copy
+    // of the frame and answers later, from any thread, with postResponse().
+    // Returns false for a malformed frame, which closes the connection.
+    class IRequestExecutor {
+    public:
+        virtual ~IRequestExecutor() {}
+
+        virtual bool execute(RpcServer& server, ConnectionId_t connection, const uint8_t* frame, size_t size,
+                utility::MemoryReaderWriter& response_out) = 0;
+
+        // a connection is gone; requests still running for it may stop early
+        virtual void closed(RpcServer& server, ConnectionId_t connection) {}
+
+        // waits for deferred requests, which may still post responses; called when the server is destroyed
+        virtual void drain() {}
+    };
+
+    // Speaks something other than rpc_pipeline frames (see rpc_http.hpp). consume() gets all bytes
+    // received on a connection and not consumed yet, writes any responses to output, and returns how many
+    // bytes it used, or -1 to close the connection right away.
+    class IStreamProtocol {
+    public:
+        virtual ~IStreamProtocol() {}
+
+        virtual ssize_t consume(RpcServer& server, ConnectionId_t connection, const uint8_t* data, size_t size,
+                utility::MemoryReaderWriter& output) = 0;
+    };
+
+    explicit RpcServer(FrameHandler_t handler)
+            : err(reflection::err), maxPendingOutput(DEFAULT_MAX_PENDING_OUTPUT), handler(handler), executor(nullptr),
+            protocol(nullptr), epollFd(-1), wakeFd(-1), stopRequested(false), nextConnectionId(1) {}
+
+    explicit RpcServer(IRequestExecutor* executor)
+            : err(reflection::err), maxPendingOutput(DEFAULT_MAX_PENDING_OUTPUT), handler(nullptr), executor(executor),
+            protocol(nullptr), epollFd(-1), wakeFd(-1), stopRequested(false), nextConnectionId(1) {}
+
+    explicit RpcServer(IStreamProtocol* protocol)
+            : err(reflection::err), maxPendingOutput(DEFAULT_MAX_PENDING_OUTPUT), handler(nullptr), executor(nullptr),
+            protocol(protocol), epollFd(-1), wakeFd(-1), stopRequested(false), nextConnectionId(1) {}
+
+    ~RpcServer() {
+        if (executor != nullptr)
+            executor->drain();
+
+        while (!connections.empty())
+            closeConnection(connections.back());
+
+        releaseClosed();
+
+        for (auto listener : listeners) {
+            close(listener->fd);
+
+            if (!listener->path.empty())
+                unlink(listener->path.c_str());
+
+            delete listener;
+        }
+
+        if (wakeFd >= 0)
+            close(wakeFd);
+
+        if (epollFd >= 0)
+            close(epollFd);
+    }
+
+    RpcServer(const RpcServer&) = delete;
+
+    // May be called several times to serve on more than one address
+    bool listen(const char* address) {
+        if (!init())
+            return false;
+
+        SocketAddress_t addr;
+
+        if (!parseAddress(err, address, addr))
+            return false;
+
+        int fd = socket(addr.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        if (fd < 0)
+            return socketError(err, "socket");
+
+        std::unique_ptr<Listener_t> listener(new Listener_t());
+        listener->fd = fd;
+        listener->tag.listener = listener.get();
+        listener->tag.connection = nullptr;
+
+        if (addr.isUnix) {
+            // replace a stale socket left by an earlier run, but nothing else
+            const char* path = ((const sockaddr_un*) &addr.storage)->sun_path;
+            struct stat st;
+
+            if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+                unlink(path);
+
+            listener->path = path;
+        }
+        else {
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        }
+
+        if (bind(fd, (const sockaddr*) &addr.storage, addr.length) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+            socketError(err, address);
+            close(fd);
+            return false;
+        }
+
+        if (addr.isUnix) {
+            listener->address = address;
+        }
+        else {
+            sockaddr_storage bound;
+            socklen_t boundLength = sizeof(bound);
+            char host[NI_MAXHOST], port[NI_MAXSERV];
+
+            if (getsockname(fd, (sockaddr*) &bound, &boundLength) != 0
+                    || getnameinfo((const sockaddr*) &bound, boundLength, host, sizeof(host), port, sizeof(port),
+                            NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+                socketError(err, "getsockname");
+                close(fd);
+                return false;
+            }
+
+            listener->address = std::string("tcp:") + host + ":" + port;
+        }
+
+        if (!watch(fd, EPOLLIN, &listener->tag)) {
+            close(fd);
+            return false;
+        }
+
+        listeners.push_back(listener.release());
+        return true;
+    }
+
+    // bound address of the i-th listen() call, with the actual port for tcp:<host>:0
+    const char* address(size_t i = 0) const {
+        return (i < listeners.size()) ? listeners[i]->address.c_str() : nullptr;
+    }
+
+    size_t numConnections() const {
+        return connections.size();
+    }
+
+    // Queues a response frame for a connection; may be called from any thread. Responses for connections
+    // closed meanwhile are dropped.
+    void postResponse(ConnectionId_t connection, const uint8_t* frame, size_t size) {
+        post(connection, frame, size, false);
+    }
+
+    // closes a connection from any thread, after the responses posted before
+    void postClose(ConnectionId_t connection) {
+        post(connection, nullptr, 0, true);
+    }
+
+    // Serves until stop() is called
+    bool run() {
+        if (!init())
+            return false;
+
+        epoll_event events[64];
+
+        while (!stopRequested) {
+            int count = epoll_wait(epollFd, events, 64, -1);
+
+            if (count < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                return socketError(err, "epoll_wait");
+            }
+
+            for (int i = 0; i < count; i++) {
+                Tag_t* tag = (Tag_t*) events[i].data.ptr;
+
+                if (tag == &wakeTag) {
+                    uint64_t value;
+                    ssize_t got = read(wakeFd, &value, sizeof(value));
+                    (void) got;
+                    deliverPosted();
+                }
+                else if (tag->listener != nullptr)
+                    accept(*tag->listener);
+                else if (tag->connection->fd >= 0)
+                    serve(tag->connection, events[i].events);
+            }
+
+            // not before now, since later events of the batch may refer to them
+            releaseClosed();
+        }
+
+        return true;
+    }
+
+    // May be called from any thread
+    void stop() {
+        if (!init())
+            return;
+
+        stopRequested = true;
+        wake();
+    }
+
+    reflection::IErrorHandler* err;
+
+    // a connection isn't read from while more output than this waits for its peer
+    size_t maxPendingOutput;
+
+private:
+    struct Connection_t;
+    struct Listener_t;
+
+    // what an epoll event refers to
+    struct Tag_t {
+        Listener_t* listener;
+        Connection_t* connection;
+    };
+
+    struct Listener_t {
+        int fd;
+        Tag_t tag;
+        std::string address, path;      // path: Unix socket to remove on destruction
+    };
+
+    struct Connection_t {
+        int fd;                     // -1 once closed
+        ConnectionId_t id;
+        Tag_t tag;
+        rpc_pipeline::FrameAssembler input;
+        utility::MemoryReaderWriter output;
+        size_t outputPos;
+        bool wantWrite;
+        bool readPaused;            // too much output pending, see maxPendingOutput
+        bool inputClosed;           // the peer shut down its side; only responses remain to be written
+        bool closeWhenFlushed;      // postClose() arrived, or the input ended, while output was still pending
+    };
+
+    bool init() {
+        if (epollFd >= 0)
+            return true;
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (epollFd < 0)
+            return socketError(err, "epoll_create1");
+
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (wakeFd < 0)
+            return socketError(err, "eventfd");
+
+        wakeTag.listener = nullptr;
+        wakeTag.connection = nullptr;
+        return watch(wakeFd, EPOLLIN, &wakeTag);
+    }
+
+    bool watch(int fd, uint32_t events, Tag_t* tag) {
+        epoll_event event;
+        event.events = events;
+        event.data.ptr = tag;
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+            return socketError(err, "epoll_ctl");
+
+        return true;
+    }
+
+    void accept(Listener_t& listener) {
+        for (;;) {
+            int fd = accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+            if (fd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    socketError(err, "accept");
+
+                return;
+            }
+
+            if (listener.path.empty())
+                setNoDelay(fd);
+
+            auto connection = new Connection_t();
+            connection->fd = fd;
+            connection->id = nextConnectionId++;
+            connection->tag.listener = nullptr;
+            connection->tag.connection = connection;
+            connection->outputPos = 0;
+            connection->wantWrite = false;
+            connection->readPaused = false;
+            connection->inputClosed = false;
+            connection->closeWhenFlushed = false;
+
+            if (!watch(fd, EPOLLIN | EPOLLRDHUP, &connection->tag)) {
+                close(fd);
+                delete connection;
+                continue;
+            }
+
+            connections.push_back(connection);
+            connectionsById[connection->id] = connection;
+        }
+    }
+
+    void serve(Connection_t* connection, uint32_t events) {
+        if (events & EPOLLIN) {
+            uint8_t buffer[64 * 1024];
+
+            for (;;) {
+                // leave the rest to the kernel until the peer reads its responses
+                if (pendingOutput(connection) > maxPendingOutput)
+                    break;
+
+                ssize_t got = read(connection->fd, buffer, sizeof(buffer));
+
+                if (got < 0 && errno == EINTR)
+                    continue;
+
+                if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    break;
+
+                if (got < 0)
+                    return closeConnection(connection);
+
+                // the peer may still read: answer what it sent, then close
+                if (got == 0) {
+                    connection->inputClosed = true;
+                    connection->closeWhenFlushed = true;
+                    setEvents(connection, connection->wantWrite, true);
+                    break;
+                }
+
+                connection->input.append(buffer, (size_t) got);
+
+                if (protocol != nullptr) {
+                    const ssize_t used = protocol->consume(*this, connection->id, connection->input.data(),
+                            connection->input.size(), connection->output);
+
+                    if (used < 0)
+                        return closeConnection(connection);
+
+                    connection->input.skip((size_t) used);
+
+                    if ((size_t) got < sizeof(buffer))
+                        break;
+
+                    continue;
+                }
+
+                const uint8_t* frame;
+                size_t size;
+
+                while (connection->input.next(frame, size)) {
+                    const bool ok = (executor != nullptr)
+                            ? executor->execute(*this, connection->id, frame, size, connection->output)
+                            : handler(frame, size, connection->output);
+
+                    if (!ok)
+                        return closeConnection(connection);
+                }
+
+                if (connection->input.error())
+                    return closeConnection(connection);
+
+                if ((size_t) got < sizeof(buffer))
+                    break;
+            }
+        }
+        else if (events & (EPOLLHUP | EPOLLERR)) {
+            return closeConnection(connection);
+        }
+
+        flush(connection);
+    }
+
+    void flush(Connection_t* connection) {
+        utility::MemoryReaderWriter& output = connection->output;
+
+        while (connection->outputPos < output.writePos) {
+            ssize_t written = send(connection->fd, output.storage.buf + connection->outputPos,
+                    output.writePos - connection->outputPos, MSG_NOSIGNAL);
+
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return setEvents(connection, true, pendingOutput(connection) > maxPendingOutput);
+
+            if (written < 0)
+                return closeConnection(connection);
+
+            connection->outputPos += written;
+        }
+
+        output.reset();
+        connection->outputPos = 0;
+        setEvents(connection, false, false);
+
+        if (connection->closeWhenFlushed)
+            closeConnection(connection);
+    }
+
+    static size_t pendingOutput(const Connection_t* connection) {
+        return connection->output.writePos - connection->outputPos;
+    }
+
+    void setEvents(Connection_t* connection, bool wantWrite, bool readPaused) {
+        readPaused = readPaused || connection->inputClosed;
+
+        if (connection->wantWrite == wantWrite && connection->readPaused == readPaused)
+            return;
+
+        epoll_event event;
+        event.events = (readPaused ? 0 : EPOLLIN | EPOLLRDHUP) | (wantWrite ? EPOLLOUT : 0);
+        event.data.ptr = &connection->tag;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->wantWrite = wantWrite;
+        connection->readPaused = readPaused;
+    }
+
+    void closeConnection(Connection_t* connection) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+        close(connection->fd);
+        connection->fd = -1;
+
+        for (size_t i = 0; i < connections.size(); i++) {
+            if (connections[i] == connection) {
+                connections[i] = connections.back();
+                connections.pop_back();
+                break;
+            }
+        }
+
+        connectionsById.erase(connection->id);
+        closed.push_back(connection);
+
+        if (executor != nullptr)
+            executor->closed(*this, connection->id);
+    }
+
+    void releaseClosed() {
+        for (auto connection : closed)
+            delete connection;
+
+        closed.clear();
+    }
+
+    struct Posted_t {
+        ConnectionId_t connection;
+        size_t offset, size;
+        bool close;
+    };
+
+    void post(ConnectionId_t connection, const uint8_t* frame, size_t size, bool close) {
+        bool wasEmpty;
+
+        {
+            std::lock_guard<std::mutex> lock(postMutex);
+            wasEmpty = posted.empty();
+
+            Posted_t entry = { connection, postedData.writePos, size, close };
+
+            if (size > 0 && !postedData.write(err, frame, size))
+                return;
+
+            posted.push_back(entry);
+        }
+
+        // one wakeup per batch of posts
+        if (wasEmpty)
+            wake();
+    }
+
+    void wake() {
+        const uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void) written;
+    }
+
+    void deliverPosted() {
+        {
+            std::lock_guard<std::mutex> lock(postMutex);
+            delivering.swap(posted);
+
+            // BufString_t is not copyable; exchange the buffers themselves
+            std::swap(deliveringData.storage.buf, postedData.storage.buf);
+            std::swap(deliveringData.storage.bufSize, postedData.storage.bufSize);
+            std::swap(deliveringData.writePos, postedData.writePos);
+        }
+
+        std::vector<Connection_t*> touched;
+
+        for (const auto& entry : delivering) {
+            auto it = connectionsById.find(entry.connection);
+
+            if (it == connectionsById.end())
+                continue;
+
+            Connection_t* connection = it->second;
+
+            if (entry.close) {
+                // closes once everything queued so far has been written
+                connection->closeWhenFlushed = true;
+                flush(connection);
+                continue;
+            }
+
+            if (!connection->output.write(err, deliveringData.storage.buf + entry.offset, entry.size))
+                continue;
+
+            if (touched.empty() || touched.back() != connection)
+                touched.push_back(connection);
+        }
+
+        for (auto connection : touched) {
+            if (connection->fd >= 0)
+                flush(connection);
+        }
+
+        delivering.clear();
+        deliveringData.reset();
+    }
+
+    FrameHandler_t handler;
+    IRequestExecutor* executor;
+    IStreamProtocol* protocol;
+
+    int epollFd, wakeFd;
+    Tag_t wakeTag;
+    std::atomic<bool> stopRequested;
+
+    std::vector<Listener_t*> listeners;
+    std::vector<Connection_t*> connections, closed;
+    std::unordered_map<ConnectionId_t, Connection_t*> connectionsById;
+    ConnectionId_t nextConnectionId;
+
+    std::mutex postMutex;
+    std::vector<Posted_t> posted, delivering;
+    utility::MemoryReaderWriter postedData, deliveringData;
+};
+
+// Blocking client for synchronous RPC_CHANNEL calls; one call at a time, so give each thread its own
+// (see rpc_channel::RpcChannelPool). Also suits implementing the global beginRPC/invokeRPC/endRPC.
+class SocketRpcChannel : public rpc_channel::BufferedRpcChannel {
+public:
+    SocketRpcChannel() : fd(-1), nextRequestId(1) {}
+    ~SocketRpcChannel() { disconnect(); }
+
+    SocketRpcChannel(const SocketRpcChannel&) = delete;
+
+    bool connect(const char* address) {
+        disconnect();
+        fd = connectTo(err, address);
+        return fd >= 0;
+    }
+
+    void disconnect() {
+        if (fd >= 0)
+            close(fd);
+
+        fd = -1;
+        input = rpc_pipeline::FrameAssembler();
+    }
+
+protected:
+    virtual bool transact(utility::MemoryReaderWriter& request, utility::MemoryReaderWriter& response) override {
+        if (fd < 0)
+            return err->error("IOError", "Not connected"), false;
+
+        const rpc_pipeline::RpcRequestId_t requestId = nextRequestId++;
+
+        uint8_t header[rpc_pipeline::FRAME_HEADER_SIZE];
+        rpc_pipeline::putUint32(header, (uint32_t)(4 + request.writePos));
+        rpc_pipeline::putUint32(header + 4, requestId);
+
+        const iovec iov[2] = {
+            {header, sizeof(header)},
+            {request.storage.buf, request.writePos},
+        };
+
+        const uint8_t* frame;
+        size_t size;
+
+        if (!writeAll(err, fd, iov, 2) || !readFrame(err, fd, input, frame, size)) {
+            disconnect();
+            return false;
+        }
+
+        if (size < rpc_pipeline::FRAME_HEADER_SIZE + 1 || rpc_pipeline::getUint32(frame + 4) != requestId) {
+            disconnect();
+            return err->error("InvalidRpcFrame", "Unexpected RPC response"), false;
+        }
+
+        if (frame[rpc_pipeline::FRAME_HEADER_SIZE] != rpc_pipeline::RESPONSE_OK)
+            return err->error("RpcCallFailed", "Remote call failed"), false;
+
+        response.reset();
+        return response.write(err, frame + rpc_pipeline::FRAME_HEADER_SIZE + 1, size - rpc_pipeline::FRAME_HEADER_SIZE - 1);
+    }
+
+private:
+    int fd;
+    rpc_pipeline::FrameAssembler input;
+    rpc_pipeline::RpcRequestId_t nextRequestId;
+};
+
+// Pipelined client for RPC_ASYNC calls, batches and RPC_STREAM calls; may be shared by threads.
+// Responses are read and completed on a receiver thread.
+class AsyncSocketRpcChannel : public rpc_pipeline::PipelinedRpcChannel {
+public:
+    AsyncSocketRpcChannel() : fd(-1), closed(true) {}
+    ~AsyncSocketRpcChannel() { disconnect(); }
+
+    AsyncSocketRpcChannel(const AsyncSocketRpcChannel&) = delete;
+
+    bool connect(const char* address) {
+        disconnect();
+        fd = connectTo(err, address);
+
+        if (fd < 0)
+            return false;
+
+        closed = false;
+        receiver = std::thread(&AsyncSocketRpcChannel::receive, this);
+        return true;
+    }
+
+    // fails the calls still outstanding
+    void disconnect() {
+        if (fd < 0)
+            return;
+
+        shutdown(fd, SHUT_RDWR);
+        receiver.join();
+        close(fd);
+        fd = -1;
+    }
+
+protected:
+    virtual bool sendFrame(const uint8_t* frame, size_t size) override {
+        if (closed)
+            return err->error("IOError", "Not connected"), false;
+
+        const iovec iov = {(void*) frame, size};
+        return writeAll(err, fd, &iov, 1);
+    }
+
+private:
+    void receive() {
+        rpc_pipeline::FrameAssembler input;
+        uint8_t buffer[64 * 1024];
+
+        for (;;) {
+            ssize_t got = read(fd, buffer, sizeof(buffer));
+
+            if (got < 0 && errno == EINTR)
+                continue;
+
+            if (got <= 0)
+                break;
+
+            input.append(buffer, (size_t) got);
+
+            const uint8_t* frame;
+            size_t size;
+
+            while (input.next(frame, size))
+                receiveFrame(frame, size);
+
+            if (input.error())
+                break;
+        }
+
+        // calls submitted from now on fail in sendFrame
+        closed = true;
+        failPending();
+    }
+
+    int fd;
+    std::atomic<bool> closed;
+    std::thread receiver;
+};
+}
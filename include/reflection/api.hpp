@@ -28,6 +28,7 @@
 
 #include "bufstring.hpp"
 #include "base.hpp"
+#include "text_sink.hpp"
 
 #include <type_traits>
 
@@ -37,8 +38,6 @@
 
 namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
 
-extern IErrorHandler* err;
-
 template <typename From, typename To>
 struct copy_const {
     typedef To type;
@@ -49,6 +48,37 @@ struct copy_const<const From, To> {
     typedef std::add_const<To> type;
 };
 
+// compares a statically allocated field name with a name which doesn't need to be null-terminated
+inline int compareFieldName(const char* fieldName, const char* name, size_t nameLen) {
+    int diff = strncmp(fieldName, name, nameLen);
+
+    if (diff != 0)
+        return diff;
+
+    return (fieldName[nameLen] != 0) ? 1 : 0;
+}
+
+// binary search in the name index; if a derived class shadows a base class field name, the derived one is found
+inline bool findFlatField(FlatFieldTable_t const* table, const char* name, size_t nameLen, size_t& index_out) {
+    size_t low = 0, high = table->numFields;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+
+        if (compareFieldName(table->fields[table->byName[mid]].field->name, name, nameLen) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low < table->numFields && compareFieldName(table->fields[table->byName[low]].field->name, name, nameLen) == 0) {
+        index_out = table->byName[low];
+        return true;
+    }
+
+    return false;
+}
+
 template <typename Ptr_t>
 class ReflectedFields {
 public:
@@ -74,8 +104,8 @@ public:
         bool isPolymorphic() const { return refl->isPolymorphic(); }
         template <typename T> bool isType() const { return refl == reflectionForType2<T>(); }
         const char* staticTypeName() const { return refl->staticTypeName(); }
-        bool toString(char*& buf, size_t& bufSize) const { return refl->toString(err, buf, bufSize, FIELD_STATE, field); }
-        bool toString(IErrorHandler* err, char*& buf, size_t& bufSize) const { return refl->toString(err, buf, bufSize, FIELD_STATE, field); }
+        bool toString(StringBuilder_t& out) const { return refl->toString(err, out, FIELD_STATE, field); }
+        bool toString(IErrorHandler* err, StringBuilder_t& out) const { return refl->toString(err, out, FIELD_STATE, field); }
         const char* typeName() const { return refl->typeName(field); }
         bool setFromString(IErrorHandler* err, const char* str) { return refl->setFromString(err, str, strlen(str), field); }
 
@@ -83,20 +113,26 @@ public:
         bool setFromString(const std::string& str) { return refl->setFromString(err, str.c_str(), str.length(), field); }
 
         std::string toString() const {
-            char* buf = nullptr;
-            size_t bufSize = 0;
-            AllocGuard guard(buf);
+            std::string str;
+            char storage[64];
+            StdStringTextSink sink(str);
+            StringBuilder_t out(storage, sizeof(storage), &sink);
 
-            if (!refl->toString(err, buf, bufSize, FIELD_STATE, field))
+            if (!refl->toString(err, out, FIELD_STATE, field) || !stringBuilderFlush(err, out))
                 return "";
 
-            return buf;
+            return str;
         }
 #endif
     };
 
     ReflectedFields(Ptr_t inst, FieldSet_t const* fieldSet)
-            : inst(inst), fieldSet(fieldSet) {
+            : inst(inst), fieldSet(fieldSet), flatFields(fieldSet->flatFields) {
+        if (flatFields != nullptr) {
+            numFields = flatFields->numFields;
+            return;
+        }
+
         // count all fields including base class(es)
         numFields = 0;
         for (FieldSet_t const* p_fieldSet = fieldSet; p_fieldSet != nullptr; p_fieldSet = p_fieldSet->baseClassFields) {
@@ -105,6 +141,14 @@ public:
     }
 
     typename copy_const<Ptr_t, Field>::type operator [] (size_t index) const {
+        if (flatFields != nullptr) {
+            const FlatField_t& flat = flatFields->fields[index];
+            Ptr_t p_inst = (inst != nullptr) ? (Ptr_t) ((const char*) inst + flat.baseOffset) : inst;
+
+            return Field(*flat.field, flat.className, p_inst);
+        }
+
+        // no flattened table; walk the base class chain
         FieldSet_t const* p_fieldSet = fieldSet;
         Ptr_t p_inst = inst;
 
@@ -124,8 +168,27 @@ public:
         return numFields;
     }
 
+    bool find(const char* name, size_t nameLen, size_t& index_out) const {
+        if (flatFields != nullptr)
+            return findFlatField(flatFields, name, nameLen, index_out);
+
+        for (size_t i = 0; i < numFields; i++) {
+            if (compareFieldName((*this)[i].name, name, nameLen) == 0) {
+                index_out = i;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool find(const char* name, size_t& index_out) const {
+        return find(name, strlen(name), index_out);
+    }
+
     Ptr_t inst;
     FieldSet_t const* fieldSet;
+    FlatFieldTable_t const* flatFields;
     size_t numFields;
 };
 
@@ -149,10 +212,36 @@ ReflectedFields<void*> reflectFieldsStatic() {
     return ReflectedFields<void*>(nullptr, C::template reflection_s_getFields<C>(REFL_MATCH));
 }
 
+// finds a field by name in O(log n); index_out is an index into reflectFields(inst)
 template <typename T>
-void reflectPrint(T& instance, uint32_t fieldMask = FIELD_STATE | FIELD_CONFIG) {
+bool reflectFindField(const T& inst, const char* name, size_t nameLen, size_t& index_out) {
+    return reflectFields(inst).find(name, nameLen, index_out);
+}
+
+template <typename T>
+bool reflectFindField(const T& inst, const char* name, size_t& index_out) {
+    return reflectFields(inst).find(name, strlen(name), index_out);
+}
+
+// Calls visitor(value, name, systemFlags, flags) for every field of inst's static type, including base
+// classes, with value being a reference to the field's actual type. The traversal is resolved at compile
+// time, so with a generic lambda or a functor with a templated operator() it inlines completely.
+template <typename T, typename Visitor>
+void reflectVisit(T& inst, Visitor&& visitor) {
+    inst.reflection_visit(visitor);
+}
+
+// size of the on-stack buffer used when streaming text into a sink
+enum { TEXT_STREAM_BUFFER_SIZE = 512 };
+
+template <typename T>
+bool reflectPrint(StringBuilder_t& out, T& instance, uint32_t fieldMask = FIELD_STATE | FIELD_CONFIG) {
     const char* className = reflectClassName(instance);
-    printf("Instance of class %s:\n", className);
+
+    if (!stringBuilderAppend(err, out, "Instance of class ", 18)
+            || !stringBuilderAppend(err, out, className, strlen(className))
+            || !stringBuilderAppend(err, out, ":\n", 2))
+        return false;
 
     auto fields = reflectFields(instance);
 
@@ -162,13 +251,53 @@ void reflectPrint(T& instance, uint32_t fieldMask = FIELD_STATE | FIELD_CONFIG)
         if (!(field.systemFlags & fieldMask))
             continue;
 
-        printf("%-15s %s::%s = %s\n", field.typeName(), field.className, field.name, field.toString().c_str());
+        const char* typeName = field.typeName();
+        const size_t typeNameLength = strlen(typeName);
+
+        if (!stringBuilderAppend(err, out, typeName, typeNameLength))
+            return false;
+
+        // "%-15s "
+        for (size_t pad = typeNameLength; pad < 15; pad++)
+            if (!stringBuilderAppendChar(err, out, ' '))
+                return false;
 
-        if (field.isPolymorphic())
-            printf("\t(declared field type: %s)\n", field.staticTypeName());
+        if (!stringBuilderAppendChar(err, out, ' '))
+            return false;
+
+        if (!stringBuilderAppend(err, out, field.className, strlen(field.className))
+                || !stringBuilderAppend(err, out, "::", 2)
+                || !stringBuilderAppend(err, out, field.name, strlen(field.name))
+                || !stringBuilderAppend(err, out, " = ", 3)
+                || !field.toString(err, out)
+                || !stringBuilderAppendChar(err, out, '\n'))
+            return false;
+
+        if (field.isPolymorphic()) {
+            const char* staticTypeName = field.staticTypeName();
+
+            if (!stringBuilderAppend(err, out, "\t(declared field type: ", 23)
+                    || !stringBuilderAppend(err, out, staticTypeName, strlen(staticTypeName))
+                    || !stringBuilderAppend(err, out, ")\n", 2))
+                return false;
+        }
     }
 
-    printf("\n");
+    return stringBuilderAppendChar(err, out, '\n');
+}
+
+template <typename T>
+bool reflectPrint(FILE* file, T& instance, uint32_t fieldMask = FIELD_STATE | FIELD_CONFIG) {
+    char storage[TEXT_STREAM_BUFFER_SIZE];
+    FileTextSink sink(file);
+    StringBuilder_t out(storage, sizeof(storage), &sink);
+
+    return reflectPrint(out, instance, fieldMask) && stringBuilderFlush(err, out);
+}
+
+template <typename T>
+void reflectPrint(T& instance, uint32_t fieldMask = FIELD_STATE | FIELD_CONFIG) {
+    reflectPrint(stdout, instance, fieldMask);
 }
 
 // ====================================================================== //
@@ -193,21 +322,85 @@ bool reflectDeserialize(T& value_out, serialization::IReader* reader) {
     return refl->deserialize(err, reader, reinterpret_cast<void*>(&value_out));
 }
 
+// ====================================================================== //
+//  reflectSerializeFixed / reflectDeserializeFixed
+// ====================================================================== //
+
+// Fixed-width profile: arithmetic fields are stored in host representation and runs of adjacent ones
+// are copied with a single write/read, so a class made only of such fields takes one copy.
+// Strings, vectors etc. keep their regular encoding. Serialization hooks are not invoked.
+// Only suitable for peers with the same byte order and type sizes.
+
+template <typename T>
+bool reflectSerializeFixed(const T& inst, serialization::IWriter* writer) {
+    ITypeReflection* refl = reflectionForType2<T>();
+
+    return refl->serializeFixed(err, writer, reinterpret_cast<const void*>(&inst));
+}
+
+template <typename T>
+bool reflectDeserializeFixed(T& value_out, serialization::IReader* reader) {
+    ITypeReflection* refl = reflectionForType2<T>();
+
+    return refl->deserializeFixed(err, reader, reinterpret_cast<void*>(&value_out));
+}
+
 // ====================================================================== //
 //  reflectToString
 // ====================================================================== //
 
+// appends to `out`, which may be backed by a sink
+template <typename T>
+bool reflectToString(const T& inst, StringBuilder_t& out, uint32_t fieldMask = FIELD_STATE) {
+    ITypeReflection* refl = reflectionForType2<T>();
+
+    return refl->toString(err, out, fieldMask, reinterpret_cast<const void*>(&inst));
+}
+
+// streams through an on-stack buffer; nothing is allocated on the heap
+template <typename T>
+bool reflectToSink(const T& inst, ITextSink* sink, uint32_t fieldMask = FIELD_STATE) {
+    char storage[TEXT_STREAM_BUFFER_SIZE];
+    StringBuilder_t out(storage, sizeof(storage), sink);
+
+    return reflectToString(inst, out, fieldMask) && stringBuilderFlush(err, out);
+}
+
+template <typename T>
+bool reflectToFile(const T& inst, FILE* file, uint32_t fieldMask = FIELD_STATE) {
+    FileTextSink sink(file);
+    return reflectToSink(inst, &sink, fieldMask);
+}
+
+template <typename T>
+bool reflectToWriter(const T& inst, serialization::IWriter* writer, uint32_t fieldMask = FIELD_STATE) {
+    WriterTextSink sink(writer);
+    return reflectToSink(inst, &sink, fieldMask);
+}
+
+// Writes at most bufSize - 1 characters and a terminator. Like snprintf, returns the length
+// of the full representation, so a result >= bufSize means the output was truncated.
+template <typename T>
+size_t reflectToBuffer(const T& inst, char* buf, size_t bufSize, uint32_t fieldMask = FIELD_STATE) {
+    FixedBufferTextSink sink(buf, bufSize);
+
+    if (!reflectToSink(inst, &sink, fieldMask))
+        return 0;
+
+    return sink.totalLength;
+}
+
 #ifndef REFLECTOR_AVOID_STL
 inline std::string reflectToString(const ReflectedValue_t& val, uint32_t fieldMask = FIELD_STATE) {
-    char* buf = nullptr;
-    size_t bufSize = 0;
+    std::string str;
+    char storage[TEXT_STREAM_BUFFER_SIZE];
+    StdStringTextSink sink(str);
+    StringBuilder_t out(storage, sizeof(storage), &sink);
 
-    if (!val.refl->toString(err, buf, bufSize, fieldMask, val.p_value))
+    if (!val.refl->toString(err, out, fieldMask, val.p_value) || !stringBuilderFlush(err, out))
         return "";
 
-    std::string str(buf);
-    free(buf);
-    return std::move(str);
+    return str;
 }
 
 template <typename T>
@@ -219,17 +412,13 @@ std::string reflectToString(const T inst[], uint32_t fieldMask = FIELD_STATE) {
 
 template <typename T>
 std::string reflectToString(const T& inst, uint32_t fieldMask = FIELD_STATE) {
-    ITypeReflection* refl = reflectionForType(inst);
-
-    char* buf = nullptr;
-    size_t bufSize = 0;
+    std::string str;
+    StdStringTextSink sink(str);
 
-    if (!refl->toString(err, buf, bufSize, fieldMask, reinterpret_cast<const void*>(&inst)))
+    if (!reflectToSink(inst, &sink, fieldMask))
         return "";
 
-    std::string str(buf);
-    free(buf);
-    return std::move(str);
+    return str;
 }
 #endif
 
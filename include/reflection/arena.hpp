@@ -0,0 +1,138 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.hpp"
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+// Bump allocator for short-lived object graphs: individual allocations are never freed,
+// everything goes at once on reset() or destruction.
+class Arena {
+public:
+    explicit Arena(size_t chunkSize = 64 * 1024) : head(nullptr), pos(nullptr), end(nullptr), chunkSize(chunkSize) {}
+
+    ~Arena() {
+        freeChunks(head);
+    }
+
+    Arena(const Arena& other) = delete;
+    Arena& operator =(const Arena& other) = delete;
+
+    // nullptr (with an allocation error reported) on failure; align must be a power of two
+    void* alloc(size_t size, size_t align = alignof(std::max_align_t)) {
+        char* p = (char*) (((uintptr_t) pos + (align - 1)) & ~(uintptr_t) (align - 1));
+
+        if (pos != nullptr && p + size <= end) {
+            pos = p + size;
+            return p;
+        }
+
+        return allocSlow(size, align);
+    }
+
+    template <typename T>
+    T* allocArray(size_t count) {
+        if (count > SIZE_MAX / sizeof(T))
+            return err->allocationError("reflection::Arena::allocArray"), nullptr;
+
+        return (T*) alloc(count * sizeof(T), alignof(T));
+    }
+
+    // copy of str with a terminating nul
+    char* copyString(const char* str, size_t length) {
+        char* copy = (char*) alloc(length + 1, 1);
+
+        if (copy == nullptr)
+            return nullptr;
+
+        memcpy(copy, str, length);
+        copy[length] = 0;
+        return copy;
+    }
+
+    // releases everything but the current chunk, which is reused
+    void reset() {
+        if (head == nullptr)
+            return;
+
+        freeChunks(head->next);
+        head->next = nullptr;
+        pos = reinterpret_cast<char*>(head + 1);
+    }
+
+private:
+    struct Chunk_t {
+        Chunk_t* next;
+        size_t size;
+    };
+
+    void* allocSlow(size_t size, size_t align) {
+        const size_t needed = size + align;
+
+        if (needed < size)
+            return err->allocationError("reflection::Arena::alloc"), nullptr;
+
+        // large allocations get a chunk of their own, behind the current one, so that it stays usable
+        const bool dedicated = (needed > chunkSize / 4) && head != nullptr;
+        const size_t dataSize = (needed > chunkSize) ? needed : chunkSize;
+
+        Chunk_t* chunk = (Chunk_t*) malloc(sizeof(Chunk_t) + dataSize);
+
+        if (chunk == nullptr)
+            return err->allocationError("reflection::Arena::alloc"), nullptr;
+
+        chunk->size = dataSize;
+        char* data = reinterpret_cast<char*>(chunk + 1);
+        char* p = (char*) (((uintptr_t) data + (align - 1)) & ~(uintptr_t) (align - 1));
+
+        if (dedicated) {
+            chunk->next = head->next;
+            head->next = chunk;
+            return p;
+        }
+
+        chunk->next = head;
+        head = chunk;
+        pos = p + size;
+        end = data + dataSize;
+        return p;
+    }
+
+    static void freeChunks(Chunk_t* chunk) {
+        while (chunk != nullptr) {
+            Chunk_t* next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+    }
+
+    Chunk_t* head;
+    char* pos;
+    char* end;
+    size_t chunkSize;
+};
+}
@@ -86,6 +86,52 @@ struct UUID_t {
     }
 };
 
+// compact class identifier: 64-bit FNV-1a hash of the versioned class name ("ClassName,version")
+typedef uint64_t ClassIdHash_t;
+
+constexpr ClassIdHash_t hashClassId(const char* classId, ClassIdHash_t hash = 0xcbf29ce484222325ULL) {
+    return (*classId == 0) ? hash : hashClassId(classId + 1, (hash ^ (uint8_t) *classId) * 0x100000001b3ULL);
+}
+
+// Structural hash of a serialized layout: field names and tags, with class-typed fields contributing
+// their own fingerprint. Computed the same way from compiled types (ITypeReflection::fingerprint) and
+// from parsed schemas (SchemaCache::fingerprint), so one compare tells whether data can be read as is.
+// Only what a schema records is covered; e.g. the element type of an array is not.
+typedef uint64_t Fingerprint_t;
+
+inline Fingerprint_t fingerprintMix(Fingerprint_t hash, const void* data, size_t size) {
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ ((const uint8_t*) data)[i]) * 0x100000001b3ULL;
+
+    return hash;
+}
+
+inline Fingerprint_t fingerprintMix(Fingerprint_t hash, uint64_t value) {
+    for (size_t i = 0; i < 8; i++)
+        hash = (hash ^ (uint8_t)(value >> (i * 8))) * 0x100000001b3ULL;
+
+    return hash;
+}
+
+// any type but a class
+inline Fingerprint_t fingerprintOfTag(uint8_t tag) {
+    return fingerprintMix(0xcbf29ce484222325ULL, &tag, 1);
+}
+
+// a class: fingerprintClassBegin, fingerprintClassField for each field in serialization order, fingerprintClassEnd
+inline Fingerprint_t fingerprintClassBegin(size_t numFields) {
+    return fingerprintMix(hashClassId("class"), (uint64_t) numFields);
+}
+
+inline Fingerprint_t fingerprintClassField(Fingerprint_t hash, const char* name, Fingerprint_t fieldFingerprint) {
+    return fingerprintMix(fingerprintMix(hash, name, strlen(name) + 1), fieldFingerprint);
+}
+
+// never 0, which stands for "no fingerprint"
+inline Fingerprint_t fingerprintClassEnd(Fingerprint_t hash) {
+    return (hash != 0) ? hash : 1;
+}
+
 class IErrorHandler {
 public:
     virtual void error(const char* errorCode, const char* description) = 0;
@@ -121,6 +167,8 @@ public:
     void notImplemented(const char* functionName) { this->errorf("NotImplemented", "Function `%s` is not implemented.", functionName); }
 };
 
+extern IErrorHandler* err;
+
 // general class for type reflection
 class ITypeReflection {
 public:
@@ -133,10 +181,16 @@ public:
     virtual bool deserialize(IErrorHandler* err, serialization::IReader* reader, void* p_value) = 0;
     virtual bool serializeTypeInformation(IErrorHandler* err, serialization::IWriter* writer, const void* p_value) = 0;
     virtual bool verifyTypeInformation(IErrorHandler* err, serialization::IReader* reader, void* p_value) = 0;
+    virtual Fingerprint_t fingerprint() = 0;
+
+    // fixed-width profile: arithmetic values in host representation, adjacent ones copied in one go
+    virtual bool serializeFixed(IErrorHandler* err, serialization::IWriter* writer, const void* p_value) = 0;
+    virtual bool deserializeFixed(IErrorHandler* err, serialization::IReader* reader, void* p_value) = 0;
 
     virtual bool setFromString(IErrorHandler* err, const char* str, size_t strLen,
             void* p_value) = 0;
-    virtual bool toString(IErrorHandler* err, char*& buf, size_t& bufSize, uint32_t fieldMask,
+    // appends to `out` (doesn't reset it)
+    virtual bool toString(IErrorHandler* err, StringBuilder_t& out, uint32_t fieldMask,
             const void* p_value) = 0;
 };
 
@@ -152,6 +206,35 @@ struct Field_t {
         ITypeReflection* refl;              // field type information
         const UUID_t* uuid;                 // dependency uuid
     };
+
+    size_t offset;                          // offset in the declaring class, valid if fixedSize != 0
+    size_t fixedSize;                       // size of an arithmetic field of a standard-layout class, otherwise 0
+};
+
+// reflectable field of a class or any of its base classes, addressed relative to the most derived class
+struct FlatField_t {
+    Field_t const* field;
+    const char* className;                  // class which declares the field
+    ptrdiff_t baseOffset;                   // derived* -> base* adjustment for the declaring class
+};
+
+// either a run of fixed-size fields adjacent in memory (size != 0) or a single other field
+struct FixedRun_t {
+    size_t offset;                          // relative to the most derived class
+    size_t size;
+    uint32_t firstField;                    // index into FlatFieldTable_t::fields
+    uint32_t numFields;
+};
+
+// all reflectable fields of a class including base class(es), built along with its FieldSet_t
+struct FlatFieldTable_t {
+    FlatField_t const* fields;
+    size_t numFields;
+
+    uint32_t const* byName;                 // field indices sorted by name (ties keep declaration order)
+
+    FixedRun_t const* fixedRuns;            // fields in serialization order, adjacent fixed-size ones merged
+    size_t numFixedRuns;
 };
 
 // set of all reflectable fields in a class not including base class(es)
@@ -162,6 +245,8 @@ struct FieldSet_t {
 
     FieldSet_t const* baseClassFields;      // base class fields
     void* (*derivedPtrToBasePtr)(void*);    // helper to convert derived* to base* (which may or may not differ)
+
+    FlatFieldTable_t const* flatFields;     // flattened table incl. base classes, nullptr if it couldn't be built
 };
 
 template <class C>
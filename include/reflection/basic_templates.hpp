@@ -34,33 +34,81 @@ namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
 template <typename T>
 class StdVectorReflectionTemplate {
 public:
+    static void skipSpaces(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+    }
+
+    static void trimEnd(const char* p, const char*& end) {
+        while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+            end--;
+    }
+
+    // "1, 2, 3" or "[1, 2, 3]"; elements are parsed in place, without copying them out
     static bool fromString(IErrorHandler* err, const char* str, size_t strLen, std::vector<T>& value_out) {
-        return err->notImplemented("reflection::StdVectorReflectionTemplate::fromString"), false;
+        const char* p = str;
+        const char* end = str + strLen;
+
+        skipSpaces(p, end);
+
+        if (p < end && *p == '[') {
+            p++;
+            trimEnd(p, end);
+
+            if (p == end || end[-1] != ']')
+                return err->error("ListFormatError", "Unterminated list."), false;
+
+            end--;
+        }
+
+        ITypeReflection* refl = reflectionForType2<T>();
+        std::vector<T> values;
+
+        skipSpaces(p, end);
+
+        while (p < end) {
+            const char* element = p;
+
+            while (p < end && *p != ',')
+                p++;
+
+            const char* elementEnd = p;
+            trimEnd(element, elementEnd);
+
+            values.emplace_back();
+
+            if (!refl->setFromString(err, element, elementEnd - element, reinterpret_cast<void*>(&values.back())))
+                return false;
+
+            if (p < end) {
+                p++;
+                skipSpaces(p, end);
+
+                if (p == end)
+                    return err->error("ListFormatError", "Trailing comma in list."), false;
+            }
+        }
+
+        value_out = std::move(values);
+        return true;
     }
 
-    static bool toString(IErrorHandler* err, char*& buf, size_t& bufSize, const std::vector<T>& value) {
-        if (!bufStringSet(err, buf, bufSize, "[", 1))
+    static bool toString(IErrorHandler* err, StringBuilder_t& out, const std::vector<T>& value) {
+        if (!stringBuilderAppendChar(err, out, '['))
             return false;
 
         ITypeReflection* refl = reflectionForType2<T>();
-        char* ourBuf = nullptr;
-        size_t ourBufSize = 0;
 
         for (size_t i = 0; i < value.size(); i++)
         {
-            if (i > 0 && !bufStringAppend(err, buf, bufSize, ", ", 2))
+            if (i > 0 && !stringBuilderAppend(err, out, ", ", 2))
                 return false;
 
-            if (!refl->toString(err, ourBuf, ourBufSize, FIELD_STATE,
-                    reinterpret_cast<const void*>(&value[i]))
-                    || !bufStringAppend(err, buf, bufSize, ourBuf, ourBufSize))
-            {
-                free(ourBuf);
+            if (!refl->toString(err, out, FIELD_STATE, reinterpret_cast<const void*>(&value[i])))
                 return false;
-            }
         }
 
-        return bufStringAppend(err, buf, bufSize, "]", 1);
+        return stringBuilderAppendChar(err, out, ']');
     }
 };
 #endif
@@ -61,6 +61,9 @@ struct BufString_t {
 template <typename IErrorHandler>
 bool ensureSize(IErrorHandler* err, char*& buf, size_t& bufSize, size_t newBufSize) {
     if (newBufSize > bufSize) {
+        if (newBufSize < bufSize * 2)
+            newBufSize = bufSize * 2;               // grow geometrically to keep repeated appends linear
+
         newBufSize = (newBufSize + 31) & ~31;     // align to 32 bytes
 
         char* newBuf = (char*) realloc(buf, newBufSize);
@@ -124,4 +127,131 @@ bool bufStringPrintf(IErrorHandler* err, char*& buf, size_t& bufSize, const char
 
     return true;
 }
+
+class IErrorHandler;
+
+// receives the contents of a StringBuilder_t whenever it fills up, instead of the buffer growing
+class ITextSink {
+public:
+    virtual bool flush(IErrorHandler* err, const char* text, size_t length) = 0;
+};
+
+// length-tracking string builder; unlike bufStringAppend, appending never rescans the buffer
+struct StringBuilder_t {
+    char* buf;
+    size_t bufSize;
+    size_t length;
+    ITextSink* sink;    // nullptr: grow to hold everything
+    bool ownsBuf;
+
+    StringBuilder_t() : buf(nullptr), bufSize(0), length(0), sink(nullptr), ownsBuf(true) {}
+
+    // streams through `storage` (typically a stack buffer) into `sink`; call stringBuilderFlush when done
+    StringBuilder_t(char* storage, size_t storageSize, ITextSink* sink)
+            : buf(storage), bufSize(storageSize), length(0), sink(sink), ownsBuf(false) {
+        if (bufSize > 0)
+            buf[0] = 0;
+    }
+
+    ~StringBuilder_t() { if (ownsBuf) free(buf); }
+
+    StringBuilder_t(const StringBuilder_t& other) = delete;
+    StringBuilder_t& operator =(const StringBuilder_t& other) = delete;
+
+    const char* c_str() const { return buf != nullptr ? buf : ""; }
+};
+
+// hands everything buffered so far to the sink (no-op without one)
+template <typename IErrorHandler>
+bool stringBuilderFlush(IErrorHandler* err, StringBuilder_t& sb) {
+    if (sb.sink == nullptr || sb.length == 0)
+        return true;
+
+    if (!sb.sink->flush(err, sb.buf, sb.length))
+        return false;
+
+    sb.length = 0;
+    sb.buf[0] = 0;
+    return true;
+}
+
+// make room for `count` more characters plus the terminator
+template <typename IErrorHandler>
+bool stringBuilderReserve(IErrorHandler* err, StringBuilder_t& sb, size_t count) {
+    if (sb.length + count + 1 <= sb.bufSize)
+        return true;
+
+    if (!stringBuilderFlush(err, sb))
+        return false;
+
+    if (!sb.ownsBuf && sb.length + count + 1 > sb.bufSize) {
+        // outgrew the external storage; continue on the heap
+        char* newBuf = (char*) malloc(sb.length + count + 1);
+
+        if (newBuf == nullptr)
+            return err->allocationError("reflection::stringBuilderReserve"), false;
+
+        memcpy(newBuf, sb.buf, sb.length);
+        sb.buf = newBuf;
+        sb.bufSize = sb.length + count + 1;
+        sb.ownsBuf = true;
+    }
+
+    return ensureSize(err, sb.buf, sb.bufSize, sb.length + count + 1);
+}
+
+template <typename IErrorHandler>
+bool stringBuilderAppend(IErrorHandler* err, StringBuilder_t& sb, const char* str, size_t strLen) {
+    // bypass the buffer for anything that wouldn't fit it anyway
+    if (sb.sink != nullptr && strLen >= sb.bufSize)
+        return stringBuilderFlush(err, sb) && sb.sink->flush(err, str, strLen);
+
+    if (!stringBuilderReserve(err, sb, strLen))
+        return false;
+
+    memcpy(sb.buf + sb.length, str, strLen);
+    sb.length += strLen;
+    sb.buf[sb.length] = 0;
+    return true;
+}
+
+template <typename IErrorHandler>
+bool stringBuilderAppendChar(IErrorHandler* err, StringBuilder_t& sb, char c) {
+    if (!stringBuilderReserve(err, sb, 1))
+        return false;
+
+    sb.buf[sb.length++] = c;
+    sb.buf[sb.length] = 0;
+    return true;
+}
+
+template <typename IErrorHandler>
+bool stringBuilderPrintf(IErrorHandler* err, StringBuilder_t& sb, const char* format, ...) {
+    va_list args;
+
+    // format straight into the spare capacity, only measure first if it doesn't fit
+    size_t avail = (sb.buf != nullptr) ? sb.bufSize - sb.length : 0;
+
+    va_start(args, format);
+    int length = vsnprintf(avail ? sb.buf + sb.length : nullptr, avail, format, args);
+    va_end(args);
+
+    if (length < 0)
+        return err->error("PrintfError", "An error occured in `vsnprintf`."), false;
+
+    if ((size_t) length >= avail) {
+        if (!stringBuilderReserve(err, sb, length))
+            return false;
+
+        va_start(args, format);
+        length = vsnprintf(sb.buf + sb.length, sb.bufSize - sb.length, format, args);
+        va_end(args);
+
+        if (length < 0)
+            return err->error("PrintfError", "An error occured in `vsnprintf`."), false;
+    }
+
+    sb.length += length;
+    return true;
+}
 }
@@ -27,19 +27,16 @@
 #pragma once
 
 #include "api.hpp"
+#include "class_registry.hpp"
 #include "serialization_manager.hpp"
 
 namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
 
 template <typename Fields>
-bool fieldsToBufString(IErrorHandler* err, char*& buf, size_t& bufSize, const Fields& fields, uint32_t fieldMask) {
-    if (!bufStringSet(err, buf, bufSize, "{", 1))
+bool fieldsToString(IErrorHandler* err, StringBuilder_t& out, const Fields& fields, uint32_t fieldMask) {
+    if (!stringBuilderAppendChar(err, out, '{'))
         return false;
 
-    char* fieldAsString = nullptr;
-    size_t fieldAsStringSize = 0;
-
-    AllocGuard guard(fieldAsString);
     bool first = true;
 
     for (size_t i = 0; i < fields.count(); i++) {
@@ -49,31 +46,124 @@ bool fieldsToBufString(IErrorHandler* err, char*& buf, size_t& bufSize, const Fi
             continue;
 
         if (!first) {
-            if (!bufStringAppend(err, buf, bufSize, ", ", 2))
+            if (!stringBuilderAppend(err, out, ", ", 2))
                 return false;
         }
         else
             first = false;
 
-        if (!field.toString(err, fieldAsString, fieldAsStringSize))
+        if (!stringBuilderAppend(err, out, field.name, strlen(field.name))
+                || !stringBuilderAppend(err, out, "=\"", 2)
+                || !field.toString(err, out)
+                || !stringBuilderAppendChar(err, out, '"'))
             return false;
+    }
 
-        if (!bufStringAppend(err, buf, bufSize, field.name, strlen(field.name))
-                || !bufStringAppend(err, buf, bufSize, "=\"", 2)
-                || !bufStringAppend(err, buf, bufSize, fieldAsString, strlen(fieldAsString))
-                || !bufStringAppend(err, buf, bufSize, "\"", 1))
-            return false;
+    return stringBuilderAppendChar(err, out, '}');
+}
+
+template <typename Fields>
+bool serializeFieldsFixed(IErrorHandler* err, serialization::IWriter* writer, const Fields& fields) {
+    FlatFieldTable_t const* table = fields.flatFields;
+
+    if (table == nullptr) {
+        for (size_t i = 0; i < fields.count(); i++) {
+            const auto& field = fields[i];
+
+            if (!(field.systemFlags & FIELD_DEPENDENCY) && !field.refl->serializeFixed(err, writer, field.ptr()))
+                return false;
+        }
 
+        return true;
     }
 
-    if (!bufStringAppend(err, buf, bufSize, "}", 1))
-        return false;
+    for (size_t i = 0; i < table->numFixedRuns; i++) {
+        const FixedRun_t& run = table->fixedRuns[i];
+
+        if (run.size != 0) {
+            if (!writer->write(err, (const char*) fields.inst + run.offset, run.size))
+                return false;
+        }
+        else {
+            const auto& field = fields[run.firstField];
+
+            if (!(field.systemFlags & FIELD_DEPENDENCY) && !field.refl->serializeFixed(err, writer, field.ptr()))
+                return false;
+        }
+    }
 
     return true;
 }
 
+template <typename Fields>
+bool deserializeFieldsFixed(IErrorHandler* err, serialization::IReader* reader, const Fields& fields) {
+    FlatFieldTable_t const* table = fields.flatFields;
+
+    if (table == nullptr) {
+        for (size_t i = 0; i < fields.count(); i++) {
+            auto field = fields[i];
+
+            if (!(field.systemFlags & FIELD_DEPENDENCY) && !field.refl->deserializeFixed(err, reader, field.ptr()))
+                return false;
+        }
+
+        return true;
+    }
+
+    for (size_t i = 0; i < table->numFixedRuns; i++) {
+        const FixedRun_t& run = table->fixedRuns[i];
+
+        if (run.size != 0) {
+            if (!reader->read(err, (char*) fields.inst + run.offset, run.size))
+                return false;
+        }
+        else {
+            auto field = fields[run.firstField];
+
+            if (!(field.systemFlags & FIELD_DEPENDENCY) && !field.refl->deserializeFixed(err, reader, field.ptr()))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// see Fingerprint_t; dependencies aren't serialized and don't count
+template <typename Fields>
+Fingerprint_t fingerprintFields(const Fields& fields) {
+    size_t numFields = 0;
+
+    for (size_t i = 0; i < fields.count(); i++)
+        if (!(fields[i].systemFlags & FIELD_DEPENDENCY))
+            numFields++;
+
+    Fingerprint_t hash = fingerprintClassBegin(numFields);
+
+    for (size_t i = 0; i < fields.count(); i++) {
+        const auto& field = fields[i];
+
+        if (!(field.systemFlags & FIELD_DEPENDENCY))
+            hash = fingerprintClassField(hash, field.name, field.refl->fingerprint());
+    }
+
+    return fingerprintClassEnd(hash);
+}
+
+// registered alongside each class so that schemas can be generated without naming the class
+template <class C>
+bool writeClassSchema(IErrorHandler* err, serialization::IWriter* writer) {
+    auto fields = reflectFieldsStatic<C>();
+    return serialization::InstanceSerializer<C>::serializeSchema(err, writer, C::reflection_s_classId(REFL_MATCH), fields);
+}
+
 template <class C>
 class ClassReflection : public ITypeReflection {
+public:
+    ClassReflection() {
+        registerClass<C>(err, &writeClassSchema<C>);
+    }
+
+private:
     virtual bool isPolymorphic() override {
         return false;
     }
@@ -111,6 +201,18 @@ class ClassReflection : public ITypeReflection {
                 err, reader, instance.reflection_classId(REFL_MATCH), fields);
     }
 
+    virtual bool serializeFixed(IErrorHandler* err, serialization::IWriter* writer, const void* p_value) override {
+        const C& instance = *reinterpret_cast<const C*>(p_value);
+
+        return serializeFieldsFixed(err, writer, reflectFields(instance));
+    }
+
+    virtual bool deserializeFixed(IErrorHandler* err, serialization::IReader* reader, void* p_value) override {
+        C& instance = *reinterpret_cast<C*>(p_value);
+
+        return deserializeFieldsFixed(err, reader, reflectFields(instance));
+    }
+
     virtual bool serializeTypeInformation(IErrorHandler* err, serialization::IWriter* writer, const void* p_value) override {
         if (p_value != nullptr) {
             const C& instance = *reinterpret_cast<const C*>(p_value);
@@ -127,17 +229,23 @@ class ClassReflection : public ITypeReflection {
         return serialization::SerializationManager<C>::verifyInstanceTypeInformation(err, reader, instance);
     }
 
+    virtual Fingerprint_t fingerprint() override {
+        // computed once per class
+        static const Fingerprint_t value = fingerprintFields(reflectFieldsStatic<C>());
+        return value;
+    }
+
     virtual bool setFromString(IErrorHandler* err, const char* str, size_t strLen,
             void* p_value) override {
         return err->notImplemented("reflection::ClassReflection::setFromString"), false;
     }
 
-    virtual bool toString(IErrorHandler* err, char*& buffer, size_t& bufferSize, uint32_t fieldMask,
+    virtual bool toString(IErrorHandler* err, StringBuilder_t& out, uint32_t fieldMask,
             const void* p_value) override {
         const C& instance = *reinterpret_cast<const C*>(p_value);
 
         const auto fields = reflectFields(instance);
-        return fieldsToBufString(err, buffer, bufferSize, fields, fieldMask);
+        return fieldsToString(err, out, fields, fieldMask);
     }
 };
 
@@ -155,4 +263,16 @@ struct ReflectionForType2
         return &reflection;
     }
 };
+
+// registers C up front instead of on first use of its reflection (e.g. ahead of writeSchemaBundle)
+template <class C>
+void reflectRegister() {
+    ReflectionForType2<C>::reflectionForType2();
+}
+
+// layout fingerprint of C, equal to SchemaCache::fingerprint of its schema
+template <class C>
+Fingerprint_t reflectFingerprint() {
+    return ReflectionForType2<C>::reflectionForType2()->fingerprint();
+}
 }
@@ -0,0 +1,140 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+
+// writes the schema of a registered class (see InstanceSerializer::serializeSchema)
+typedef bool (*ClassSchemaWriter_t)(IErrorHandler* err, serialization::IWriter* writer);
+
+// maps compact class identifiers back to versioned class names
+// every reflected class is registered when its ClassReflection is first instantiated
+struct ClassIdEntry_t {
+    ClassIdHash_t hash;
+    const char* classId;                    // statically allocated versioned class name
+    ClassSchemaWriter_t writeSchema;        // may be nullptr
+};
+
+struct ClassIdTable_t {
+    ClassIdEntry_t* entries;                // sorted by hash
+    size_t numEntries;
+    size_t capacity;
+};
+
+// classes register lazily, possibly on several threads at once; every access to the table holds this
+inline std::mutex& classIdMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline ClassIdTable_t& classIdTable() {
+    static ClassIdTable_t table = {nullptr, 0, 0};
+    return table;
+}
+
+inline size_t classIdLowerBound(const ClassIdTable_t& table, ClassIdHash_t hash) {
+    size_t low = 0, high = table.numEntries;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+
+        if (table.entries[mid].hash < hash)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+inline bool registerClassId(IErrorHandler* err, const char* classId, ClassIdHash_t hash,
+        ClassSchemaWriter_t writeSchema = nullptr) {
+    std::lock_guard<std::mutex> lock(classIdMutex());
+    ClassIdTable_t& table = classIdTable();
+    size_t index = classIdLowerBound(table, hash);
+
+    if (index < table.numEntries && table.entries[index].hash == hash) {
+        if (strcmp(table.entries[index].classId, classId) == 0) {
+            if (table.entries[index].writeSchema == nullptr)
+                table.entries[index].writeSchema = writeSchema;
+
+            return true;
+        }
+
+        return err->errorf("ClassIdCollision", "Classes `%s` and `%s` have the same class id hash %016llx.",
+                table.entries[index].classId, classId, (unsigned long long) hash), false;
+    }
+
+    if (table.numEntries == table.capacity) {
+        size_t newCapacity = (table.capacity > 0) ? table.capacity * 2 : 32;
+        auto newEntries = (ClassIdEntry_t*) realloc(table.entries, newCapacity * sizeof(ClassIdEntry_t));
+
+        if (newEntries == nullptr)
+            return err->allocationError("reflection::registerClassId"), false;
+
+        table.entries = newEntries;
+        table.capacity = newCapacity;
+    }
+
+    memmove(&table.entries[index + 1], &table.entries[index], (table.numEntries - index) * sizeof(ClassIdEntry_t));
+    table.entries[index].hash = hash;
+    table.entries[index].classId = classId;
+    table.entries[index].writeSchema = writeSchema;
+    table.numEntries++;
+    return true;
+}
+
+inline const char* classIdForHashOrNull(ClassIdHash_t hash) {
+    std::lock_guard<std::mutex> lock(classIdMutex());
+    const ClassIdTable_t& table = classIdTable();
+    size_t index = classIdLowerBound(table, hash);
+
+    if (index < table.numEntries && table.entries[index].hash == hash)
+        return table.entries[index].classId;
+
+    return nullptr;
+}
+
+// a copy of the entries registered so far, for callers that may register further classes while iterating
+inline std::vector<ClassIdEntry_t> registeredClassIds() {
+    std::lock_guard<std::mutex> lock(classIdMutex());
+    const ClassIdTable_t& table = classIdTable();
+
+    return std::vector<ClassIdEntry_t>(table.entries, table.entries + table.numEntries);
+}
+
+template <class C>
+bool registerClass(IErrorHandler* err, ClassSchemaWriter_t writeSchema = nullptr) {
+    return registerClassId(err, C::reflection_s_classId(REFL_MATCH), C::reflection_s_classIdHash(REFL_MATCH),
+            writeSchema);
+}
+}
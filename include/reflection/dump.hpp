@@ -28,6 +28,9 @@
 
 #include "api.hpp"
 #include "basic_types.hpp"
+#include "class_registry.hpp"
+#include "numeric.hpp"
+#include "schema.hpp"
 #include "serializer.hpp"
 
 namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
@@ -38,15 +41,6 @@ public:
     virtual void seekBack(long amount) = 0;
 };
 
-class ISchemaProvider {
-public:
-    virtual IReader* openClassSchemaOrNull(const char* className) = 0;
-    virtual void closeClassSchema(IReader* reader) = 0;
-};
-
-static bool dumpValue(Tag_t tag, IReader* reader, ISeekBack* sb, ISchemaProvider* sp = nullptr, int offset = 0);
-static bool dumpTaggedValue(IReader* reader, ISeekBack* sb, ISchemaProvider* sp = nullptr, int offset = 0);
-
 static const char* getTypeName(Tag_t tag) {
     switch (tag) {
         case TAG_VOID:          return "void";
@@ -62,251 +56,583 @@ static const char* getTypeName(Tag_t tag) {
 
         case TAG_CLASS:         return "class";
         case TAG_CLASS_SCHEMA:  return "class_schema";
+        case TAG_CLASS_HASH:    return "class_hash";
 
         default:                return nullptr;
     }
 }
 
-static void doOffset(int offset) {
-    for (int i = 0; i < offset; i++)
-        printf("    ");
-}
+// ====================================================================== //
+//  visitors
+// ====================================================================== //
 
-template <typename T>
-bool dumpDeserialized(IReader* reader) {
-    T value;
+// Receives the structure of a serialized stream as the Dumper decodes it.
+// For classes: beginClass, [schemaUnavailable], beginFields, { field, [valueType], <value>, endField }..., endClass
+class IDumpVisitor {
+public:
+    virtual bool beginClass(IErrorHandler* err, const char* classId) = 0;
+    virtual bool schemaUnavailable(IErrorHandler* err, bool fatal) = 0;
+    virtual bool beginFields(IErrorHandler* err) = 0;
+    virtual bool field(IErrorHandler* err, size_t index, const char* className, const char* name) = 0;
+    virtual bool valueType(IErrorHandler* err, const char* typeName) = 0;
+    virtual bool endField(IErrorHandler* err) = 0;
+    virtual bool endClass(IErrorHandler* err) = 0;
+
+    virtual bool voidValue(IErrorHandler* err) = 0;
+    virtual bool boolValue(IErrorHandler* err, bool value) = 0;
+    virtual bool charValue(IErrorHandler* err, unsigned char value) = 0;
+    virtual bool intValue(IErrorHandler* err, int64_t value) = 0;
+    virtual bool floatValue(IErrorHandler* err, float value) = 0;
+    virtual bool doubleValue(IErrorHandler* err, double value) = 0;
+    virtual bool stringValue(IErrorHandler* err, const char* str, size_t length) = 0;
+
+    virtual bool beginSchema(IErrorHandler* err) = 0;
+    virtual bool schemaField(IErrorHandler* err, const SchemaField_t& field) = 0;
+    virtual bool endSchema(IErrorHandler* err) = 0;
+
+    // called before anything else may write to the same output (e.g. a schema provider)
+    virtual bool flush(IErrorHandler* err) = 0;
+};
 
-    if (!reflectDeserialize(value, reader))
-        return false;
+// common output plumbing for the text visitors
+class TextDumpVisitorBase : public IDumpVisitor {
+public:
+    TextDumpVisitorBase(StringBuilder_t& out, int depth, const char* indentString)
+            : out(out), depth(depth), indentString(indentString), indentLength(strlen(indentString)) {}
 
-    std::string s = reflectToString(value);
-    printf("\"%s\"", s.c_str());
+    virtual bool flush(IErrorHandler* err) override {
+        return stringBuilderFlush(err, out);
+    }
 
-    return true;
-}
+protected:
+    bool append(IErrorHandler* err, const char* str, size_t length) { return stringBuilderAppend(err, out, str, length); }
+    bool append(IErrorHandler* err, const char* str) { return stringBuilderAppend(err, out, str, strlen(str)); }
+    bool append(IErrorHandler* err, char c) { return stringBuilderAppendChar(err, out, c); }
 
-static bool dumpString(IReader* reader) {
-    BufString_t value;
+    bool indent(IErrorHandler* err) {
+        for (int i = 0; i < depth; i++)
+            if (!append(err, indentString, indentLength))
+                return false;
 
-    if (!Serializer<BufString_t>::deserialize(err, reader, value))
-        return false;
+        return true;
+    }
 
-    printf("\"%s\"", value.buf);
+    template <typename Int_t>
+    bool appendInteger(IErrorHandler* err, Int_t value) {
+        if (!stringBuilderReserve(err, out, MAX_INTEGER_CHARS))
+            return false;
 
-    return true;
-}
+        out.length += formatInteger(out.buf + out.length, value);
+        out.buf[out.length] = 0;
+        return true;
+    }
 
-static bool dumpTaggedClass(IReader* reader, ISeekBack* sb, ISchemaProvider* sp = nullptr, int offset = 0) {
-    BufString_t className, str;
-    uint32_t numFields;
+    template <typename Float_t>
+    bool appendFloat(IErrorHandler* err, Float_t value) {
+        if (!stringBuilderReserve(err, out, MAX_FLOAT_CHARS))
+            return false;
 
-    if (!Serializer<BufString_t>::deserialize(err, reader, className)
-            || !Serializer<uint32_t>::deserialize(err, reader, numFields))
-        return false;
+        out.length += formatFloat(out.buf + out.length, value);
+        out.buf[out.length] = 0;
+        return true;
+    }
 
-    printf("`%s`", className.buf);
+    StringBuilder_t& out;
+    int depth;
+    const char* indentString;
+    size_t indentLength;
+};
+
+// the traditional human-readable format
+class PrettyDumpVisitor : public TextDumpVisitorBase {
+public:
+    PrettyDumpVisitor(StringBuilder_t& out, int depth = 0) : TextDumpVisitorBase(out, depth, "    ") {}
 
-    IReader* schemaReader = (sp == nullptr) ? nullptr : sp->openClassSchemaOrNull(className.buf);
+    virtual bool beginClass(IErrorHandler* err, const char* classId) override {
+        return append(err, '`') && append(err, classId) && append(err, '`');
+    }
 
-    if (schemaReader == nullptr)
-        printf(" (schema not available)");
+    virtual bool schemaUnavailable(IErrorHandler* err, bool fatal) override {
+        return append(err, fatal ? " (schema not available)\n" : " (schema not available)");
+    }
 
-    printf(" {\n");
-    offset++;
+    virtual bool beginFields(IErrorHandler* err) override {
+        depth++;
+        return append(err, " {\n", 3);
+    }
 
-    if (schemaReader != nullptr) {
-        if (!checkTag(err, schemaReader, TAG_CLASS_SCHEMA))
+    virtual bool field(IErrorHandler* err, size_t index, const char* className, const char* name) override {
+        if (!indent(err))
             return false;
 
-        if (/*!Serializer<BufString_t>::deserialize(err, schemaReader, className)
-                ||*/ !Serializer<uint32_t>::deserialize(err, schemaReader, numFields))
-            return false;
+        if (className == nullptr)
+            return true;
+
+        return append(err, '`') && append(err, className) && append(err, "::", 2) && append(err, name)
+                && append(err, "` => ", 5);
+    }
 
-        // TODO: check if values as expected
+    virtual bool valueType(IErrorHandler* err, const char* typeName) override {
+        return append(err, typeName) && append(err, '\t');
     }
 
-    for (uint32_t i = 0; i < numFields; i++) {
-        doOffset(offset);
+    virtual bool endField(IErrorHandler* err) override {
+        return append(err, '\n');
+    }
+
+    virtual bool endClass(IErrorHandler* err) override {
+        depth--;
+        return indent(err) && append(err, '}');
+    }
+
+    virtual bool voidValue(IErrorHandler* err) override { return append(err, "\"void\"", 6); }
+    virtual bool boolValue(IErrorHandler* err, bool value) override { return value ? append(err, "\"true\"", 6) : append(err, "\"false\"", 7); }
+    virtual bool charValue(IErrorHandler* err, unsigned char value) override { return quoted(err, value); }
+    virtual bool intValue(IErrorHandler* err, int64_t value) override { return quoted(err, value); }
+
+    virtual bool floatValue(IErrorHandler* err, float value) override {
+        return append(err, '"') && appendFloat(err, value) && append(err, '"');
+    }
 
-        if (schemaReader != nullptr) {
-            Tag_t tag;
+    virtual bool doubleValue(IErrorHandler* err, double value) override {
+        return append(err, '"') && appendFloat(err, value) && append(err, '"');
+    }
+
+    virtual bool stringValue(IErrorHandler* err, const char* str, size_t length) override {
+        return append(err, '"') && append(err, str, length) && append(err, '"');
+    }
 
-            if (!Serializer<BufString_t>::deserialize(err, schemaReader, className)
-                    || !Serializer<BufString_t>::deserialize(err, schemaReader, str)
-                    || !schemaReader->read(err, &tag, sizeof(tag)))
+    virtual bool beginSchema(IErrorHandler* err) override {
+        depth++;
+        return append(err, "{\n", 2);
+    }
+
+    virtual bool schemaField(IErrorHandler* err, const SchemaField_t& field) override {
+        if (!indent(err) || !append(err, '`') || !append(err, field.className) || !append(err, "::", 2)
+                || !append(err, field.name) || !append(err, '`'))
+            return false;
+
+        if (field.classId != nullptr) {
+            if (!append(err, "\t=> class `", 11) || !append(err, field.classId) || !append(err, '`'))
                 return false;
+        }
+        else {
+            const char* typeName = getTypeName(field.tag);
 
-            printf("`%s::%s` => ", className.buf, str.buf);
+            if (typeName != nullptr && (!append(err, "\t=> ", 4) || !append(err, typeName)))
+                return false;
+        }
 
-            if (tag == TAG_CLASS) {
-                if (!Serializer<BufString_t>::deserialize(err, schemaReader, className))
-                    return false;
+        return append(err, '\n');
+    }
 
-                //printf("(class `%s`) ", className.buf);
-            }
+    virtual bool endSchema(IErrorHandler* err) override {
+        depth--;
+        return indent(err) && append(err, '}');
+    }
+
+private:
+    template <typename Int_t>
+    bool quoted(IErrorHandler* err, Int_t value) {
+        return append(err, '"') && appendInteger(err, value) && append(err, '"');
+    }
+};
+
+// JSON string contents (without the quotes); copies runs of plain characters in one go, escaping the rest
+inline bool appendJsonStringBody(IErrorHandler* err, StringBuilder_t& out, const char* str, size_t length) {
+    static const char HEX[] = "0123456789abcdef";
+    size_t runStart = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        const unsigned char c = (unsigned char) str[i];
+
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        if (!stringBuilderAppend(err, out, str + runStart, i - runStart))
+            return false;
+
+        runStart = i + 1;
+        char escape[6] = { '\\', 0 };
+        size_t escapeLength = 2;
+
+        switch (c) {
+            case '"': escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            default:
+                memcpy(escape + 1, "u00", 3);
+                escape[4] = HEX[c >> 4];
+                escape[5] = HEX[c & 15];
+                escapeLength = 6;
         }
 
-        if (!dumpTaggedValue(reader, sb, sp, offset))
+        if (!stringBuilderAppend(err, out, escape, escapeLength))
             return false;
+    }
+
+    return stringBuilderAppend(err, out, str + runStart, length - runStart);
+}
 
-        printf("\n");
+// JSON: a class becomes {"$class": classId, "Class::field": value, ...}
+class JsonDumpVisitor : public TextDumpVisitorBase {
+public:
+    JsonDumpVisitor(StringBuilder_t& out, int depth = 0) : TextDumpVisitorBase(out, depth, "  "), first(true) {}
+
+    virtual bool beginClass(IErrorHandler* err, const char* classId) override {
+        return append(err, "{\"$class\": ", 11) && jsonString(err, classId, strlen(classId));
     }
 
-    if (schemaReader != nullptr)
-        sp->closeClassSchema(schemaReader);
+    virtual bool schemaUnavailable(IErrorHandler* err, bool fatal) override {
+        if (!append(err, ", \"$schema\": null", 17))
+            return false;
 
-    offset--;
-    doOffset(offset);
-    printf("}");
+        return !fatal || append(err, "}\n", 2);
+    }
 
-    return true;
-}
+    virtual bool beginFields(IErrorHandler* err) override {
+        depth++;
+        return true;
+    }
 
-static bool dumpClass(IReader* reader, ISeekBack* sb, const char* className_, ISchemaProvider* sp, int offset = 0) {
-    BufString_t className, str;
-    uint32_t numFields;
+    virtual bool field(IErrorHandler* err, size_t index, const char* className, const char* name) override {
+        if (!append(err, ",\n", 2) || !indent(err))
+            return false;
 
-    bufStringSet(err, className.buf, className.bufSize, className_, strlen(className_));
+        if (className == nullptr) {
+            // no schema: fall back to positional keys
+            return append(err, '"') && appendInteger(err, index) && append(err, "\": ", 3);
+        }
 
-    printf("`%s`", className.buf);
+        return append(err, '"') && jsonStringBody(err, className, strlen(className)) && append(err, "::", 2)
+                && jsonStringBody(err, name, strlen(name)) && append(err, "\": ", 3);
+    }
 
-    IReader* schemaReader = (sp == nullptr) ? nullptr : sp->openClassSchemaOrNull(className.buf);
+    virtual bool valueType(IErrorHandler* err, const char* typeName) override { return true; }
+    virtual bool endField(IErrorHandler* err) override { return true; }
 
-    if (schemaReader == nullptr) {
-        printf(" (schema not available)\n");
-        return false;
+    virtual bool endClass(IErrorHandler* err) override {
+        depth--;
+        return append(err, '\n') && indent(err) && append(err, '}');
     }
 
-    printf(" {\n");
-    offset++;
+    virtual bool voidValue(IErrorHandler* err) override { return append(err, "null", 4); }
+    virtual bool boolValue(IErrorHandler* err, bool value) override { return value ? append(err, "true", 4) : append(err, "false", 5); }
+    virtual bool charValue(IErrorHandler* err, unsigned char value) override { return appendInteger(err, value); }
+    virtual bool intValue(IErrorHandler* err, int64_t value) override { return appendInteger(err, value); }
+    virtual bool floatValue(IErrorHandler* err, float value) override { return jsonNumber(err, value); }
+    virtual bool doubleValue(IErrorHandler* err, double value) override { return jsonNumber(err, value); }
 
-    if (!Serializer<uint32_t>::deserialize(err, schemaReader, numFields))
-        return false;
+    virtual bool stringValue(IErrorHandler* err, const char* str, size_t length) override {
+        return jsonString(err, str, length);
+    }
 
-    // TODO: check if values as expected
+    virtual bool beginSchema(IErrorHandler* err) override {
+        depth++;
+        first = true;
+        return append(err, '{');
+    }
 
-    for (uint32_t i = 0; i < numFields; i++) {
-        doOffset(offset);
+    virtual bool schemaField(IErrorHandler* err, const SchemaField_t& field) override {
+        if (!append(err, first ? "\n" : ",\n") || !indent(err))
+            return false;
 
-        Tag_t tag;
+        first = false;
 
-        if (!Serializer<BufString_t>::deserialize(err, schemaReader, className)
-                || !Serializer<BufString_t>::deserialize(err, schemaReader, str)
-                || !schemaReader->read(err, &tag, sizeof(tag)))
+        if (!append(err, '"') || !jsonStringBody(err, field.className, strlen(field.className)) || !append(err, "::", 2)
+                || !jsonStringBody(err, field.name, strlen(field.name)) || !append(err, "\": ", 3))
             return false;
 
-        printf("`%s::%s` => ", className.buf, str.buf);
+        if (field.classId != nullptr)
+            return append(err, "{\"$class\": ", 11) && jsonString(err, field.classId, strlen(field.classId)) && append(err, '}');
 
-        if (tag == TAG_CLASS) {
-            if (!Serializer<BufString_t>::deserialize(err, schemaReader, className))
-                return false;
+        const char* typeName = getTypeName(field.tag);
+        return (typeName != nullptr) ? jsonString(err, typeName, strlen(typeName)) : append(err, "null", 4);
+    }
+
+    virtual bool endSchema(IErrorHandler* err) override {
+        depth--;
+        return append(err, '\n') && indent(err) && append(err, '}');
+    }
+
+private:
+    template <typename Float_t>
+    bool jsonNumber(IErrorHandler* err, Float_t value) {
+        // JSON has no representation for these
+        if (value != value || value - value != 0)
+            return append(err, "null", 4);
+
+        return appendFloat(err, value);
+    }
+
+    bool jsonString(IErrorHandler* err, const char* str, size_t length) {
+        return append(err, '"') && jsonStringBody(err, str, length) && append(err, '"');
+    }
+
+    bool jsonStringBody(IErrorHandler* err, const char* str, size_t length) {
+        return appendJsonStringBody(err, out, str, length);
+    }
 
-            if (!dumpClass(reader, sb, className.buf, sp, offset))
+    bool first;
+};
+
+// ====================================================================== //
+//  Dumper
+// ====================================================================== //
+
+// Decodes serialized data and reports it to an IDumpVisitor. Schemas come from a SchemaCache, either
+// shared or private to this Dumper, so each class's schema is loaded only once; string scratch space
+// is reused throughout.
+class Dumper {
+public:
+    Dumper(IDumpVisitor* visitor, ISchemaProvider* sp)
+            : visitor(visitor), ownCache(sp), cache(&ownCache) {}
+
+    Dumper(IDumpVisitor* visitor, SchemaCache* cache)
+            : visitor(visitor), ownCache(nullptr), cache(cache) {}
+
+    Dumper(const Dumper& other) = delete;
+    Dumper& operator =(const Dumper& other) = delete;
+
+    // untagged instance of classId, laid out according to its schema
+    bool dumpClass(IReader* reader, const char* classId) {
+        return visitor->beginClass(err, classId) && dumpFields(reader, schemaFor(classId));
+    }
+
+    // class name and field count, followed by tagged field values
+    bool dumpTaggedClass(IReader* reader) {
+        uint32_t numFields;
+
+        if (!Serializer<BufString_t>::deserialize(err, reader, scratch)
+                || !Serializer<uint32_t>::deserialize(err, reader, numFields))
+            return false;
+
+        if (!visitor->beginClass(err, scratch.buf))
+            return false;
+
+        const ClassSchema_t* schema = schemaFor(scratch.buf);
+
+        if (schema == nullptr && !visitor->schemaUnavailable(err, false))
+            return false;
+
+        if (!visitor->beginFields(err))
+            return false;
+
+        for (uint32_t i = 0; i < numFields; i++) {
+            const SchemaField_t* field = (schema != nullptr && i < schema->numFields) ? &schema->fields[i] : nullptr;
+
+            if (!visitor->field(err, i, field ? field->className : nullptr, field ? field->name : nullptr)
+                    || !dumpTaggedValue(reader)
+                    || !visitor->endField(err))
                 return false;
         }
-        else if (!dumpValue(tag, reader, sb, sp, offset))
+
+        return visitor->endClass(err);
+    }
+
+    bool dumpTaggedValue(IReader* reader) {
+        Tag_t tag;
+
+        if (!reader->read(err, &tag, sizeof(tag)))
             return false;
 
-        printf("\n");
+        const char* typeName = getTypeName(tag);
+
+        if (typeName != nullptr && !visitor->valueType(err, typeName))
+            return false;
+
+        if (tag == TAG_CLASS)
+            return dumpTaggedClass(reader);
+
+        return dumpValue(tag, reader);
     }
 
-    sp->closeClassSchema(schemaReader);
+    bool dumpValue(Tag_t tag, IReader* reader) {
+        switch (tag) {
+            case TAG_VOID:
+                return visitor->voidValue(err);
 
-    offset--;
-    doOffset(offset);
-    printf("}");
+            case TAG_BOOL: {
+                bool value;
+                return Serializer<bool>::deserialize(err, reader, value) && visitor->boolValue(err, value);
+            }
 
-    return true;
-}
+            case TAG_CHAR: {
+                unsigned char value;
+                return Serializer<unsigned char>::deserialize(err, reader, value) && visitor->charValue(err, value);
+            }
+
+            case TAG_SMVINT: {
+                int64_t value;
+                return SmvIntSerializer<int64_t>::deserializeValue(err, reader, value) && visitor->intValue(err, value);
+            }
 
-static bool dumpClassSchema(IReader* reader, int offset = 0) {
-    BufString_t className, str;
-    uint32_t numFields;
+            case TAG_REAL32: {
+                float value;
+                return Serializer<float>::deserialize(err, reader, value) && visitor->floatValue(err, value);
+            }
 
-    if (/*!Serializer<BufString_t>::deserialize(err, reader, className)
-            ||*/ !Serializer<uint32_t>::deserialize(err, reader, numFields))
-        return false;
+            case TAG_REAL64: {
+                double value;
+                return Serializer<double>::deserialize(err, reader, value) && visitor->doubleValue(err, value);
+            }
 
-    printf(/*"`%s` "*/"{\n"/*, className.buf*/);
-    offset++;
+            case TAG_UTF8:
+                return dumpString(reader);
 
-    for (uint32_t i = 0; i < numFields; i++) {
-        doOffset(offset);
+            case TAG_CLASS_SCHEMA:
+                return dumpClassSchema(reader);
 
-        Tag_t tag;
+            default:
+                return err->errorf("UnknownType", "Unrecognized tag %02X.\n", tag), false;
+        }
+    }
+
+    // schema body (after TAG_CLASS_SCHEMA)
+    bool dumpClassSchema(IReader* reader) {
+        ClassSchema_t* schema = readClassSchema(reader, "");
 
-        if (!Serializer<BufString_t>::deserialize(err, reader, className)
-                || !Serializer<BufString_t>::deserialize(err, reader, str)
-                || !reader->read(err, &tag, sizeof(tag)))
+        if (schema == nullptr)
             return false;
 
-        printf("`%s::%s`", className.buf, str.buf);
+        AllocGuard guard(schema);
+
+        if (!visitor->beginSchema(err))
+            return false;
 
-        if (tag == TAG_CLASS) {
-            if (!Serializer<BufString_t>::deserialize(err, reader, className))
+        for (size_t i = 0; i < schema->numFields; i++)
+            if (!visitor->schemaField(err, schema->fields[i]))
                 return false;
 
-            printf("\t=> class `%s`", className.buf);
-        }
-        else {
-            const char* typeName = getTypeName(tag);
+        return visitor->endSchema(err);
+    }
+
+private:
+    bool dumpFields(IReader* reader, const ClassSchema_t* schema) {
+        if (schema == nullptr)
+            return visitor->schemaUnavailable(err, true), false;
 
-            if (typeName != nullptr)
-                printf("\t=> %s", typeName);
+        if (!visitor->beginFields(err))
+            return false;
+
+        for (size_t i = 0; i < schema->numFields; i++) {
+            const SchemaField_t& field = schema->fields[i];
+
+            if (!visitor->field(err, i, field.className, field.name))
+                return false;
+
+            if (field.classId != nullptr) {
+                if (!visitor->beginClass(err, field.classId))
+                    return false;
+
+                const ClassSchema_t* fieldSchema = (field.schema != nullptr) ? field.schema : nestedSchemaFor(field);
+
+                if (!dumpFields(reader, fieldSchema))
+                    return false;
+            }
+            else if (!dumpValue(field.tag, reader))
+                return false;
+
+            if (!visitor->endField(err))
+                return false;
         }
 
-        printf("\n");
+        return visitor->endClass(err);
     }
 
-    offset--;
-    doOffset(offset);
-    printf("}");
+    bool dumpString(IReader* reader) {
+        uint64_t length;
 
-    return true;
-}
+        if (!SmvIntSerializer<uint64_t>::deserializeValue(err, reader, length))
+            return false;
 
-static bool dumpTaggedValue(IReader* reader, ISeekBack* sb, ISchemaProvider* sp, int offset) {
-    Tag_t tag;
+        if (length > SIZE_MAX / 2)
+            return err->error("LengthOverflow", "String length is too large."), false;
 
-    if (!reader->read(err, &tag, sizeof(tag)))
-        return false;
+        if (!ensureSize(err, scratch.buf, scratch.bufSize, (size_t) length + 1))
+            return false;
 
-    const char* typeName = getTypeName(tag);
+        if (length > 0 && !reader->read(err, scratch.buf, (size_t) length))
+            return false;
 
-    if (typeName != nullptr)
-        printf("%s\t", typeName);
+        return visitor->stringValue(err, scratch.buf, (size_t) length);
+    }
 
-    switch (tag) {
-        case TAG_VOID: printf("\"void\""); return true;
-        case TAG_BOOL: sb->seekBack(1); return dumpDeserialized<bool>(reader);
-        case TAG_CHAR: sb->seekBack(1); return dumpDeserialized<unsigned char>(reader);
-        case TAG_SMVINT: sb->seekBack(1); return dumpDeserialized<int64_t>(reader);
+    const ClassSchema_t* schemaFor(const char* classId) {
+        // the provider might print something
+        if (!cache->isCached(classId))
+            visitor->flush(err);
 
-        case TAG_UTF8: sb->seekBack(1); return dumpString(reader);
+        return cache->get(classId);
+    }
 
-        case TAG_CLASS: return dumpTaggedClass(reader, sb, sp, offset);
-        case TAG_CLASS_SCHEMA: return dumpClassSchema(reader, offset);
+    const ClassSchema_t* nestedSchemaFor(const SchemaField_t& field) {
+        if (!cache->isCached(field.classId))
+            visitor->flush(err);
 
-        default: err->errorf("UnknownType", "Unrecognized tag %02X.\n", tag); return false;
+        return cache->nested(field);
     }
 
-    return false;
+    IDumpVisitor* visitor;
+
+    SchemaCache ownCache;
+    SchemaCache* cache;
+
+    BufString_t scratch;
+};
+
+// ====================================================================== //
+//  convenience functions (pretty format on stdout)
+// ====================================================================== //
+
+enum { DUMP_BUFFER_SIZE = 16 * 1024 };
+
+template <typename Func>
+bool dumpToStdout(int offset, Func func) {
+    char storage[DUMP_BUFFER_SIZE];
+    FileTextSink sink(stdout);
+    StringBuilder_t out(storage, sizeof(storage), &sink);
+
+    PrettyDumpVisitor visitor(out, offset);
+    const bool result = func(&visitor);
+
+    return stringBuilderFlush(err, out) && result;
 }
 
-static bool dumpValue(Tag_t tag, IReader* reader, ISeekBack* sb, ISchemaProvider* sp, int offset) {
-    switch (tag) {
-        case TAG_VOID: printf("\"void\""); return true;
-        case TAG_BOOL: return dumpDeserialized<bool>(reader);
-        case TAG_CHAR: return dumpDeserialized<unsigned char>(reader);
-        case TAG_SMVINT: return dumpDeserialized<int64_t>(reader);
+template <typename T>
+bool dumpDeserialized(IReader* reader) {
+    T value;
+
+    if (!reflectDeserialize(value, reader))
+        return false;
 
-        case TAG_UTF8: return dumpString(reader);
+    std::string s = reflectToString(value);
+    printf("\"%s\"", s.c_str());
 
-        case TAG_CLASS_SCHEMA: return dumpClassSchema(reader, offset);
+    return true;
+}
 
-        default: err->errorf("UnknownType", "Unrecognized tag %02X.\n", tag); return false;
-    }
+inline bool dumpTaggedClass(IReader* reader, ISeekBack* sb, ISchemaProvider* sp = nullptr, int offset = 0) {
+    return dumpToStdout(offset, [&](IDumpVisitor* visitor) { return Dumper(visitor, sp).dumpTaggedClass(reader); });
+}
+
+inline bool dumpClass(IReader* reader, ISeekBack* sb, const char* className, ISchemaProvider* sp, int offset = 0) {
+    return dumpToStdout(offset, [&](IDumpVisitor* visitor) { return Dumper(visitor, sp).dumpClass(reader, className); });
+}
+
+inline bool dumpClassSchema(IReader* reader, int offset = 0) {
+    return dumpToStdout(offset, [&](IDumpVisitor* visitor) { return Dumper(visitor, (ISchemaProvider*) nullptr).dumpClassSchema(reader); });
+}
+
+inline bool dumpTaggedValue(IReader* reader, ISeekBack* sb, ISchemaProvider* sp = nullptr, int offset = 0) {
+    return dumpToStdout(offset, [&](IDumpVisitor* visitor) { return Dumper(visitor, sp).dumpTaggedValue(reader); });
+}
 
-    return false;
+inline bool dumpValue(Tag_t tag, IReader* reader, ISeekBack* sb, ISchemaProvider* sp = nullptr, int offset = 0) {
+    return dumpToStdout(offset, [&](IDumpVisitor* visitor) { return Dumper(visitor, sp).dumpValue(tag, reader); });
 }
 }
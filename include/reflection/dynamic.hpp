@@ -0,0 +1,291 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "arena.hpp"
+#include "schema.hpp"
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+// Dynamically typed values decoded from a serialized stream by means of class schemas,
+// for code that handles messages without having their types compiled in.
+
+enum DynamicType_t : uint8_t {
+    DYN_VOID,
+    DYN_BOOL,
+    DYN_CHAR,
+    DYN_INT,
+    DYN_FLOAT,
+    DYN_DOUBLE,
+    DYN_STRING,
+    DYN_OBJECT,
+};
+
+struct DynamicObject_t;
+
+struct DynamicValue_t {
+    DynamicType_t type;
+    uint32_t length;                        // DYN_STRING: length in bytes
+    union {
+        bool boolValue;
+        unsigned char charValue;
+        int64_t intValue;
+        float floatValue;
+        double doubleValue;
+        const char* stringValue;            // nul-terminated
+        DynamicObject_t* objectValue;
+    };
+};
+
+struct DynamicObject_t {
+    const char* classId;
+    const ClassSchema_t* schema;            // names and tags of the fields; nullptr if not available
+    DynamicValue_t* fields;                 // in schema order
+    size_t numFields;
+
+    const DynamicValue_t& field(size_t index) const { return fields[index]; }
+    DynamicValue_t& field(size_t index) { return fields[index]; }
+
+    const char* fieldName(size_t index) const {
+        return (schema != nullptr && index < schema->numFields) ? schema->fields[index].name : nullptr;
+    }
+
+    // linear in the number of fields; resolve names once and keep the index
+    bool findField(const char* name, size_t& index_out) const {
+        if (schema == nullptr)
+            return false;
+
+        for (size_t i = 0; i < schema->numFields && i < numFields; i++) {
+            if (strcmp(schema->fields[i].name, name) == 0)
+                return index_out = i, true;
+        }
+
+        return false;
+    }
+};
+
+// Decodes serialized values into DynamicValue_t trees. Nodes and strings are allocated from the arena
+// passed in; class ids and schemas are borrowed from the schema cache, which must outlive the trees.
+class DynamicDecoder {
+public:
+    DynamicDecoder(ISchemaProvider* sp) : ownCache(sp), cache(&ownCache) {}
+    DynamicDecoder(SchemaCache* cache) : ownCache(nullptr), cache(cache) {}
+
+    DynamicDecoder(const DynamicDecoder& other) = delete;
+    DynamicDecoder& operator =(const DynamicDecoder& other) = delete;
+
+    // untagged instance of classId, as written by reflectSerialize
+    bool decodeClass(IReader* reader, const char* classId, Arena& arena, DynamicValue_t& value_out) {
+        const ClassSchema_t* schema = cache->get(classId);
+
+        if (schema == nullptr)
+            return err->errorf("SchemaUnavailable", "Schema for class `%s` is not available.", classId), false;
+
+        return decodeFields(reader, schema, arena, value_out);
+    }
+
+    // class name and field count, followed by tagged field values; the schema is optional here
+    bool decodeTaggedClass(IReader* reader, Arena& arena, DynamicValue_t& value_out) {
+        uint32_t numFields;
+
+        if (!Serializer<BufString_t>::deserialize(err, reader, scratch)
+                || !Serializer<uint32_t>::deserialize(err, reader, numFields))
+            return false;
+
+        const ClassSchema_t* schema = cache->get(scratch.buf);
+        const char* classId = (schema != nullptr) ? schema->classId : arena.copyString(scratch.buf, strlen(scratch.buf));
+        DynamicObject_t* object = (classId != nullptr) ? newObject(arena, classId, schema, numFields) : nullptr;
+
+        if (object == nullptr)
+            return false;
+
+        for (uint32_t i = 0; i < numFields; i++)
+            if (!decodeTaggedValue(reader, arena, object->fields[i]))
+                return false;
+
+        value_out.type = DYN_OBJECT;
+        value_out.objectValue = object;
+        return true;
+    }
+
+    bool decodeTaggedValue(IReader* reader, Arena& arena, DynamicValue_t& value_out) {
+        Tag_t tag;
+
+        if (!reader->read(err, &tag, sizeof(tag)))
+            return false;
+
+        if (tag == TAG_CLASS)
+            return decodeTaggedClass(reader, arena, value_out);
+
+        return decodeValue(tag, reader, arena, value_out);
+    }
+
+    bool decodeValue(Tag_t tag, IReader* reader, Arena& arena, DynamicValue_t& value_out) {
+        switch (tag) {
+            case TAG_VOID:
+                value_out.type = DYN_VOID;
+                return true;
+
+            case TAG_BOOL:
+                value_out.type = DYN_BOOL;
+                return Serializer<bool>::deserialize(err, reader, value_out.boolValue);
+
+            case TAG_CHAR:
+                value_out.type = DYN_CHAR;
+                return Serializer<unsigned char>::deserialize(err, reader, value_out.charValue);
+
+            case TAG_SMVINT:
+                value_out.type = DYN_INT;
+                return SmvIntSerializer<int64_t>::deserializeValue(err, reader, value_out.intValue);
+
+            case TAG_REAL32:
+                value_out.type = DYN_FLOAT;
+                return Serializer<float>::deserialize(err, reader, value_out.floatValue);
+
+            case TAG_REAL64:
+                value_out.type = DYN_DOUBLE;
+                return Serializer<double>::deserialize(err, reader, value_out.doubleValue);
+
+            case TAG_UTF8:
+                return decodeString(reader, arena, value_out);
+
+            default:
+                return err->errorf("UnknownType", "Cannot decode tag %02X.", tag), false;
+        }
+    }
+
+    SchemaCache* schemaCache() { return cache; }
+
+private:
+    bool decodeFields(IReader* reader, const ClassSchema_t* schema, Arena& arena, DynamicValue_t& value_out) {
+        DynamicObject_t* object = newObject(arena, schema->classId, schema, schema->numFields);
+
+        if (object == nullptr)
+            return false;
+
+        for (size_t i = 0; i < schema->numFields; i++) {
+            const SchemaField_t& field = schema->fields[i];
+
+            if (field.classId != nullptr) {
+                const ClassSchema_t* fieldSchema = cache->nested(field);
+
+                if (fieldSchema == nullptr)
+                    return err->errorf("SchemaUnavailable", "Schema for class `%s` is not available.",
+                            field.classId), false;
+
+                if (!decodeFields(reader, fieldSchema, arena, object->fields[i]))
+                    return false;
+            }
+            else if (!decodeValue(field.tag, reader, arena, object->fields[i]))
+                return false;
+        }
+
+        value_out.type = DYN_OBJECT;
+        value_out.objectValue = object;
+        return true;
+    }
+
+    bool decodeString(IReader* reader, Arena& arena, DynamicValue_t& value_out) {
+        uint64_t length;
+
+        if (!SmvIntSerializer<uint64_t>::deserializeValue(err, reader, length))
+            return false;
+
+        if (length >= UINT32_MAX)
+            return err->error("LengthOverflow", "String length is too large."), false;
+
+        // read straight into the tree
+        char* str = (char*) arena.alloc((size_t) length + 1, 1);
+
+        if (str == nullptr || (length > 0 && !reader->read(err, str, (size_t) length)))
+            return false;
+
+        str[length] = 0;
+
+        value_out.type = DYN_STRING;
+        value_out.length = (uint32_t) length;
+        value_out.stringValue = str;
+        return true;
+    }
+
+    // object and its fields in one allocation
+    static DynamicObject_t* newObject(Arena& arena, const char* classId, const ClassSchema_t* schema, size_t numFields) {
+        if (numFields > (SIZE_MAX - sizeof(DynamicObject_t)) / sizeof(DynamicValue_t))
+            return err->error("LengthOverflow", "Too many fields."), nullptr;
+
+        auto object = (DynamicObject_t*) arena.alloc(sizeof(DynamicObject_t) + numFields * sizeof(DynamicValue_t),
+                alignof(DynamicObject_t));
+
+        if (object == nullptr)
+            return nullptr;
+
+        object->classId = classId;
+        object->schema = schema;
+        object->fields = reinterpret_cast<DynamicValue_t*>(object + 1);
+        object->numFields = numFields;
+        return object;
+    }
+
+    SchemaCache ownCache;
+    SchemaCache* cache;
+
+    BufString_t scratch;
+};
+
+// writes a single value the way decodeValue reads it
+static bool encodeDynamicValue(IWriter* writer, const DynamicValue_t& value);
+
+// writes an object field by field, untagged, as read back by DynamicDecoder::decodeClass
+static bool encodeDynamicClass(IWriter* writer, const DynamicObject_t& object) {
+    for (size_t i = 0; i < object.numFields; i++)
+        if (!encodeDynamicValue(writer, object.fields[i]))
+            return false;
+
+    return true;
+}
+
+static bool encodeDynamicValue(IWriter* writer, const DynamicValue_t& value) {
+    switch (value.type) {
+        case DYN_VOID:      return true;
+        case DYN_BOOL:      return Serializer<bool>::serialize(err, writer, value.boolValue);
+        case DYN_CHAR:      return Serializer<unsigned char>::serialize(err, writer, value.charValue);
+        case DYN_INT:       return SmvIntSerializer<int64_t>::serializeValue(err, writer, value.intValue);
+        case DYN_FLOAT:     return Serializer<float>::serialize(err, writer, value.floatValue);
+        case DYN_DOUBLE:    return Serializer<double>::serialize(err, writer, value.doubleValue);
+
+        case DYN_STRING: {
+            const uint64_t length = value.length;
+
+            return SmvIntSerializer<uint64_t>::serializeValue(err, writer, length)
+                    && (length == 0 || writer->write(err, value.stringValue, value.length));
+        }
+
+        case DYN_OBJECT:    return encodeDynamicClass(writer, *value.objectValue);
+    }
+
+    return err->errorf("UnknownType", "Unrecognized dynamic type %d.", (int) value.type), false;
+}
+}
@@ -1,14 +1,16 @@
 #pragma once
 
-// Generated by gen_reflection_header.py
+// Generated by gen_magic_header.py
 
 namespace reflection {
 #define REFL_BEGIN(className_, version_) \
 public:\
     static const char* reflection_s_classId(REFL_MATCH_0) { return className_ "," #version_; }\
+    static constexpr ::reflection::ClassIdHash_t reflection_s_classIdHash(REFL_MATCH_0) { return ::reflection::hashClassId(className_ "," #version_); }\
     static const char* reflection_s_className(REFL_MATCH_0) { return className_; }\
     static bool reflection_s_isPolymorphic(REFL_MATCH_0) { return false; }\
     const char* reflection_classId(REFL_MATCH_0) const { return className_ "," #version_; }\
+    ::reflection::ClassIdHash_t reflection_classIdHash(REFL_MATCH_0) const { return ::reflection::hashClassId(className_ "," #version_); }\
     const char* reflection_className(REFL_MATCH_0) const { return className_; }\
     const ::reflection::UUID_t* reflection_uuidOrNull(REFL_MATCH_1) const { return nullptr; }\
     ::reflection::FieldSet_t const* reflection_getFields(REFL_MATCH_0) const {\
@@ -18,18 +20,38 @@ public:\
     template <class ThisClass>\
     static ::reflection::FieldSet_t const* reflection_s_getFields(REFL_MATCH_0) {\
         const char* thisClassName = className_;\
-        thisClassName = thisClassName;\
         ::reflection::FieldSet_t const* baseClassFields = nullptr;\
         void* (*derivedPtrToBasePtr)(void*) = nullptr;\
-        static ::reflection::Field_t const fields[] = {\
+        static ::reflection::FieldSet_t const fieldSet = ::reflection::makeFieldSet<ThisClass>(thisClassName, baseClassFields, derivedPtrToBasePtr);\
+        return &fieldSet;\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) {\
+        typedef std::remove_reference<decltype(*this)>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) const {\
+        typedef std::remove_const<std::remove_reference<decltype(*this)>::type>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class ThisClass, class Inst, class Visitor>\
+    static void reflection_s_visit(Inst& inst, Visitor& visitor) {\
+        ::reflection::InstanceFieldVisitor<Inst, Visitor> instanceVisitor(inst, visitor);\
+        reflection_s_forEachField<ThisClass>(instanceVisitor);\
+    }\
+    template <class ThisClass, class Visitor>\
+    static void reflection_s_forEachField(Visitor& reflection_v) {\
 
 
 #define REFL_BEGIN_EXTENDS(className_, version_, baseClass_) \
 public:\
     static const char* reflection_s_classId(REFL_MATCH_0) { return className_ "," #version_; }\
+    static constexpr ::reflection::ClassIdHash_t reflection_s_classIdHash(REFL_MATCH_0) { return ::reflection::hashClassId(className_ "," #version_); }\
     static const char* reflection_s_className(REFL_MATCH_0) { return className_; }\
     static bool reflection_s_isPolymorphic(REFL_MATCH_0) { return false; }\
     const char* reflection_classId(REFL_MATCH_0) const { return className_ "," #version_; }\
+    ::reflection::ClassIdHash_t reflection_classIdHash(REFL_MATCH_0) const { return ::reflection::hashClassId(className_ "," #version_); }\
     const char* reflection_className(REFL_MATCH_0) const { return className_; }\
     const ::reflection::UUID_t* reflection_uuidOrNull(REFL_MATCH_1) const { return nullptr; }\
     ::reflection::FieldSet_t const* reflection_getFields(REFL_MATCH_0) const {\
@@ -39,18 +61,40 @@ public:\
     template <class ThisClass>\
     static ::reflection::FieldSet_t const* reflection_s_getFields(REFL_MATCH_0) {\
         const char* thisClassName = className_;\
-        thisClassName = thisClassName;\
         ::reflection::FieldSet_t const* baseClassFields = baseClass_::reflection_s_getFields<baseClass_>(REFL_MATCH);\
         void* (*derivedPtrToBasePtr)(void*) = &::reflection::derivedPtrToBasePtr<ThisClass, baseClass_>;\
-        static ::reflection::Field_t const fields[] = {\
+        static ::reflection::FieldSet_t const fieldSet = ::reflection::makeFieldSet<ThisClass>(thisClassName, baseClassFields, derivedPtrToBasePtr);\
+        return &fieldSet;\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) {\
+        typedef std::remove_reference<decltype(*this)>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) const {\
+        typedef std::remove_const<std::remove_reference<decltype(*this)>::type>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class ThisClass, class Inst, class Visitor>\
+    static void reflection_s_visit(Inst& inst, Visitor& visitor) {\
+        ::reflection::InstanceFieldVisitor<Inst, Visitor> instanceVisitor(inst, visitor);\
+        reflection_s_forEachField<ThisClass>(instanceVisitor);\
+        typedef typename std::conditional<std::is_const<Inst>::value, const baseClass_, baseClass_>::type Base;\
+        baseClass_::template reflection_s_visit<baseClass_>(static_cast<Base&>(inst), visitor);\
+    }\
+    template <class ThisClass, class Visitor>\
+    static void reflection_s_forEachField(Visitor& reflection_v) {\
 
 
 #define REFL_BEGIN_VIRTUAL(className_, version_) \
 public:\
     static const char* reflection_s_classId(REFL_MATCH_0) { return className_ "," #version_; }\
+    static constexpr ::reflection::ClassIdHash_t reflection_s_classIdHash(REFL_MATCH_0) { return ::reflection::hashClassId(className_ "," #version_); }\
     static const char* reflection_s_className(REFL_MATCH_0) { return className_; }\
     static bool reflection_s_isPolymorphic(REFL_MATCH_0) { return true; }\
     virtual const char* reflection_classId(REFL_MATCH_0) const { return className_ "," #version_; }\
+    virtual ::reflection::ClassIdHash_t reflection_classIdHash(REFL_MATCH_0) const { return ::reflection::hashClassId(className_ "," #version_); }\
     virtual const char* reflection_className(REFL_MATCH_0) const { return className_; }\
     virtual const ::reflection::UUID_t* reflection_uuidOrNull(REFL_MATCH_1) const { return nullptr; }\
     virtual ::reflection::FieldSet_t const* reflection_getFields(REFL_MATCH_0) const {\
@@ -60,18 +104,38 @@ public:\
     template <class ThisClass>\
     static ::reflection::FieldSet_t const* reflection_s_getFields(REFL_MATCH_0) {\
         const char* thisClassName = className_;\
-        thisClassName = thisClassName;\
         ::reflection::FieldSet_t const* baseClassFields = nullptr;\
         void* (*derivedPtrToBasePtr)(void*) = nullptr;\
-        static ::reflection::Field_t const fields[] = {\
+        static ::reflection::FieldSet_t const fieldSet = ::reflection::makeFieldSet<ThisClass>(thisClassName, baseClassFields, derivedPtrToBasePtr);\
+        return &fieldSet;\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) {\
+        typedef std::remove_reference<decltype(*this)>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) const {\
+        typedef std::remove_const<std::remove_reference<decltype(*this)>::type>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class ThisClass, class Inst, class Visitor>\
+    static void reflection_s_visit(Inst& inst, Visitor& visitor) {\
+        ::reflection::InstanceFieldVisitor<Inst, Visitor> instanceVisitor(inst, visitor);\
+        reflection_s_forEachField<ThisClass>(instanceVisitor);\
+    }\
+    template <class ThisClass, class Visitor>\
+    static void reflection_s_forEachField(Visitor& reflection_v) {\
 
 
 #define REFL_BEGIN_VIRTUAL_EXTENDS(className_, version_, baseClass_) \
 public:\
     static const char* reflection_s_classId(REFL_MATCH_0) { return className_ "," #version_; }\
+    static constexpr ::reflection::ClassIdHash_t reflection_s_classIdHash(REFL_MATCH_0) { return ::reflection::hashClassId(className_ "," #version_); }\
     static const char* reflection_s_className(REFL_MATCH_0) { return className_; }\
     static bool reflection_s_isPolymorphic(REFL_MATCH_0) { return true; }\
     virtual const char* reflection_classId(REFL_MATCH_0) const { return className_ "," #version_; }\
+    virtual ::reflection::ClassIdHash_t reflection_classIdHash(REFL_MATCH_0) const { return ::reflection::hashClassId(className_ "," #version_); }\
     virtual const char* reflection_className(REFL_MATCH_0) const { return className_; }\
     virtual const ::reflection::UUID_t* reflection_uuidOrNull(REFL_MATCH_1) const { return nullptr; }\
     virtual ::reflection::FieldSet_t const* reflection_getFields(REFL_MATCH_0) const {\
@@ -81,10 +145,30 @@ public:\
     template <class ThisClass>\
     static ::reflection::FieldSet_t const* reflection_s_getFields(REFL_MATCH_0) {\
         const char* thisClassName = className_;\
-        thisClassName = thisClassName;\
         ::reflection::FieldSet_t const* baseClassFields = baseClass_::reflection_s_getFields<baseClass_>(REFL_MATCH);\
         void* (*derivedPtrToBasePtr)(void*) = &::reflection::derivedPtrToBasePtr<ThisClass, baseClass_>;\
-        static ::reflection::Field_t const fields[] = {\
+        static ::reflection::FieldSet_t const fieldSet = ::reflection::makeFieldSet<ThisClass>(thisClassName, baseClassFields, derivedPtrToBasePtr);\
+        return &fieldSet;\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) {\
+        typedef std::remove_reference<decltype(*this)>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class Visitor>\
+    void reflection_visit(Visitor& visitor) const {\
+        typedef std::remove_const<std::remove_reference<decltype(*this)>::type>::type ThisClass;\
+        reflection_s_visit<ThisClass>(*this, visitor);\
+    }\
+    template <class ThisClass, class Inst, class Visitor>\
+    static void reflection_s_visit(Inst& inst, Visitor& visitor) {\
+        ::reflection::InstanceFieldVisitor<Inst, Visitor> instanceVisitor(inst, visitor);\
+        reflection_s_forEachField<ThisClass>(instanceVisitor);\
+        typedef typename std::conditional<std::is_const<Inst>::value, const baseClass_, baseClass_>::type Base;\
+        baseClass_::template reflection_s_visit<baseClass_>(static_cast<Base&>(inst), visitor);\
+    }\
+    template <class ThisClass, class Visitor>\
+    static void reflection_s_forEachField(Visitor& reflection_v) {\
 
 
 }
@@ -19,13 +19,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return>
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
 Return rpcSerializedCall(
         ) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(invokeRPC());
 
@@ -36,6 +36,24 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
+Return rpcChannelCall(
+        IRpcChannel& channel) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, Return (*function)()>
 bool rpcExecute(Handler& handler) {
     assert(handler.begin());
@@ -71,9 +89,19 @@ struct MakeFunctionPointer0 {
     typedef Return (*type)();
 };
 
-template <const char* functionName, typename Return>
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer0<Return>::type getRpcSerializedCall(Return (*functionNull)()) {
-    return &rpcSerializedCall<functionName, Return>;
+    return &rpcSerializedCall<functionName, methodId, Return>;
+}
+
+template <typename Return>
+struct MakeChannelFunctionPointer0 {
+    typedef Return (*type)(IRpcChannel&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer0<Return>::type getRpcChannelCall(Return (*functionNull)()) {
+    return &rpcChannelCall<functionName, methodId, Return>;
 }
 
 template <typename Function, Function func, class Handler, typename Return>
@@ -99,19 +127,33 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName>
+template <const char* functionName, RpcMethodId_t methodId>
 void rpcSerializedCallVoid(
         ) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(invokeRPC());
 
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId>
+void rpcChannelCallVoid(
+        IRpcChannel& channel) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, void (*function)()>
 bool rpcExecute(Handler& handler) {
     assert(handler.begin());
@@ -144,9 +186,18 @@ struct MakeFunctionPointerVoid0 {
     typedef void (*type)();
 };
 
-template <const char* functionName>
+template <const char* functionName, RpcMethodId_t methodId>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid0::type getRpcSerializedCall(void (*functionNull)()) {
-    return &rpcSerializedCallVoid<functionName>;
+    return &rpcSerializedCallVoid<functionName, methodId>;
+}
+
+struct MakeChannelFunctionPointerVoid0 {
+    typedef void (*type)(IRpcChannel&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid0::type getRpcChannelCall(void (*functionNull)()) {
+    return &rpcChannelCallVoid<functionName, methodId>;
 }
 
 template <typename Function, Function func, class Handler>
@@ -176,13 +227,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
 Return rpcSerializedCall(
         Arg0 const& arg0) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
 
@@ -195,6 +246,26 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, Return (*function)(Arg0)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -238,9 +309,19 @@ struct MakeFunctionPointer1 {
     typedef Return (*type)(Arg0 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer1<Return, Arg0>::type getRpcSerializedCall(Return (*functionNull)(Arg0)) {
-    return &rpcSerializedCall<functionName, Return, Arg0>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0>;
+}
+
+template <typename Return, typename Arg0>
+struct MakeChannelFunctionPointer1 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer1<Return, Arg0>::type getRpcChannelCall(Return (*functionNull)(Arg0)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0>
@@ -268,13 +349,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0>
 void rpcSerializedCallVoid(
         Arg0 const& arg0) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
 
@@ -283,6 +364,22 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, void (*function)(Arg0)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -324,9 +421,19 @@ struct MakeFunctionPointerVoid1 {
     typedef void (*type)(Arg0 const&);
 };
 
-template <const char* functionName, typename Arg0>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid1<Arg0>::type getRpcSerializedCall(void (*functionNull)(Arg0)) {
-    return &rpcSerializedCallVoid<functionName, Arg0>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0>;
+}
+
+template <typename Arg0>
+struct MakeChannelFunctionPointerVoid1 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid1<Arg0>::type getRpcChannelCall(void (*functionNull)(Arg0)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0>
@@ -357,13 +464,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -377,6 +484,27 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, Return (*function)(Arg0, Arg1)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -424,9 +552,19 @@ struct MakeFunctionPointer2 {
     typedef Return (*type)(Arg0 const&, Arg1 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer2<Return, Arg0, Arg1>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1>;
+}
+
+template <typename Return, typename Arg0, typename Arg1>
+struct MakeChannelFunctionPointer2 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer2<Return, Arg0, Arg1>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1>
@@ -455,13 +593,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -471,6 +609,23 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, void (*function)(Arg0, Arg1)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -516,9 +671,19 @@ struct MakeFunctionPointerVoid2 {
     typedef void (*type)(Arg0 const&, Arg1 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid2<Arg0, Arg1>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1>;
+}
+
+template <typename Arg0, typename Arg1>
+struct MakeChannelFunctionPointerVoid2 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid2<Arg0, Arg1>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1>
@@ -550,13 +715,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -571,6 +736,28 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, Return (*function)(Arg0, Arg1, Arg2)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -622,9 +809,19 @@ struct MakeFunctionPointer3 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer3<Return, Arg0, Arg1, Arg2>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2>
+struct MakeChannelFunctionPointer3 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer3<Return, Arg0, Arg1, Arg2>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2>
@@ -654,13 +851,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -671,6 +868,24 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, void (*function)(Arg0, Arg1, Arg2)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -720,9 +935,19 @@ struct MakeFunctionPointerVoid3 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid3<Arg0, Arg1, Arg2>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2>
+struct MakeChannelFunctionPointerVoid3 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid3<Arg0, Arg1, Arg2>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2>
@@ -755,13 +980,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -777,6 +1002,29 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, Return (*function)(Arg0, Arg1, Arg2, Arg3)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -832,9 +1080,19 @@ struct MakeFunctionPointer4 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer4<Return, Arg0, Arg1, Arg2, Arg3>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+struct MakeChannelFunctionPointer4 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer4<Return, Arg0, Arg1, Arg2, Arg3>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
@@ -865,13 +1123,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -883,6 +1141,25 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, void (*function)(Arg0, Arg1, Arg2, Arg3)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -936,9 +1213,19 @@ struct MakeFunctionPointerVoid4 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid4<Arg0, Arg1, Arg2, Arg3>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+struct MakeChannelFunctionPointerVoid4 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid4<Arg0, Arg1, Arg2, Arg3>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
@@ -972,13 +1259,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -995,6 +1282,30 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, Return (*function)(Arg0, Arg1, Arg2, Arg3, Arg4)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1054,9 +1365,19 @@ struct MakeFunctionPointer5 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer5<Return, Arg0, Arg1, Arg2, Arg3, Arg4>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3, Arg4>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+struct MakeChannelFunctionPointer5 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer5<Return, Arg0, Arg1, Arg2, Arg3, Arg4>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
@@ -1088,13 +1409,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1107,6 +1428,26 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, void (*function)(Arg0, Arg1, Arg2, Arg3, Arg4)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1164,9 +1505,19 @@ struct MakeFunctionPointerVoid5 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid5<Arg0, Arg1, Arg2, Arg3, Arg4>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3, Arg4>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+struct MakeChannelFunctionPointerVoid5 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid5<Arg0, Arg1, Arg2, Arg3, Arg4>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
@@ -1201,13 +1552,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1225,6 +1576,31 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, Return (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1288,9 +1664,19 @@ struct MakeFunctionPointer6 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer6<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+struct MakeChannelFunctionPointer6 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer6<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
@@ -1323,13 +1709,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1343,6 +1729,27 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, void (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1404,9 +1811,19 @@ struct MakeFunctionPointerVoid6 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid6<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+struct MakeChannelFunctionPointerVoid6 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid6<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
@@ -1442,13 +1859,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1467,6 +1884,32 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, Return (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1534,9 +1977,19 @@ struct MakeFunctionPointer7 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer7<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+struct MakeChannelFunctionPointer7 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer7<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
@@ -1570,13 +2023,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1591,6 +2044,28 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, void (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1656,9 +2131,19 @@ struct MakeFunctionPointerVoid7 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid7<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+struct MakeChannelFunctionPointerVoid7 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid7<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
@@ -1695,13 +2180,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1721,6 +2206,33 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg7, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, Return (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1792,9 +2304,19 @@ struct MakeFunctionPointer8 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer8<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+struct MakeChannelFunctionPointer8 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer8<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
@@ -1829,13 +2351,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1851,6 +2373,29 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg7, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, void (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -1920,9 +2465,19 @@ struct MakeFunctionPointerVoid8 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid8<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+struct MakeChannelFunctionPointerVoid8 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid8<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
@@ -1960,13 +2515,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -1987,6 +2542,34 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg7, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg8, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, Return (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -2062,9 +2645,19 @@ struct MakeFunctionPointer9 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer9<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+struct MakeChannelFunctionPointer9 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer9<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
@@ -2100,13 +2693,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -2123,6 +2716,30 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg7, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg8, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, void (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -2196,9 +2813,19 @@ struct MakeFunctionPointerVoid9 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid9<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+struct MakeChannelFunctionPointerVoid9 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid9<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
@@ -2237,13 +2864,13 @@ Return rpcCall(
     return result;
 }
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
 Return rpcSerializedCall(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8, Arg9 const& arg9) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, true, writer, reader));
+    assert(beginRPC(functionName, methodId, true, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -2265,6 +2892,35 @@ Return rpcSerializedCall(
     return result;
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+Return rpcChannelCall(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8, Arg9 const& arg9) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, true, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg7, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg8, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg9, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    Return result;
+    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);
+
+    channel.endCall();
+    return result;
+}
+
 template <class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9, Return (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -2344,9 +3000,19 @@ struct MakeFunctionPointer10 {
     typedef Return (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&, Arg9 const&);
 };
 
-template <const char* functionName, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointer10<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>::type getRpcSerializedCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)) {
-    return &rpcSerializedCall<functionName, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
+    return &rpcSerializedCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+struct MakeChannelFunctionPointer10 {
+    typedef Return (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&, Arg9 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointer10<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>::type getRpcChannelCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)) {
+    return &rpcChannelCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
 }
 
 template <typename Function, Function func, class Handler, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
@@ -2383,13 +3049,13 @@ void rpcCallVoid(
     assert(handler.end());
 }
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
 void rpcSerializedCallVoid(
         Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8, Arg9 const& arg9) {
     IWriter* writer;
     IReader* reader;
 
-    assert(beginRPC(functionName, false, writer, reader));
+    assert(beginRPC(functionName, methodId, false, writer, reader));
 
     assert(reflectSerialize(arg0, writer));
     assert(reflectSerialize(arg1, writer));
@@ -2407,6 +3073,31 @@ void rpcSerializedCallVoid(
     endRPC();
 }
 
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+void rpcChannelCallVoid(
+        IRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8, Arg9 const& arg9) {
+    IWriter* writer;
+    IReader* reader;
+
+    if (!channel.beginCall(functionName, methodId, false, writer, reader))
+        throw RpcCallFailed();
+
+    if (!reflectSerialize(arg0, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg1, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg2, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg3, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg4, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg5, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg6, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg7, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg8, writer)) failRpcChannelCall(channel);
+    if (!reflectSerialize(arg9, writer)) failRpcChannelCall(channel);
+
+    if (!channel.invokeCall()) failRpcChannelCall(channel);
+
+    channel.endCall();
+}
+
 template <class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9, void (*function)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)>
 bool rpcExecute(Handler& handler) {
     typename std::remove_cv<typename std::remove_reference<Arg0>::type>::type arg0;
@@ -2484,9 +3175,19 @@ struct MakeFunctionPointerVoid10 {
     typedef void (*type)(Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&, Arg9 const&);
 };
 
-template <const char* functionName, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
 RPC_CONSTEXPR_FUNC typename MakeFunctionPointerVoid10<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>::type getRpcSerializedCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)) {
-    return &rpcSerializedCallVoid<functionName, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
+    return &rpcSerializedCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
+}
+
+template <typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+struct MakeChannelFunctionPointerVoid10 {
+    typedef void (*type)(IRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&, Arg9 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+RPC_CONSTEXPR_FUNC typename MakeChannelFunctionPointerVoid10<Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>::type getRpcChannelCall(void (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)) {
+    return &rpcChannelCallVoid<functionName, methodId, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
 }
 
 template <typename Function, Function func, class Handler, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
@@ -0,0 +1,575 @@
+#pragma once
+
+// Generated by gen_rpc_header.py --async
+
+namespace rpc {
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return>(channel, completion))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return>
+struct MakeAsyncFunctionPointer0 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer0<Return>::type getRpcAsyncCall(Return (*functionNull)()) {
+    return &rpcAsyncCall<functionName, methodId, Return>;
+}
+
+template <typename Return>
+struct MakeFutureFunctionPointer0 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer0<Return>::type getRpcFutureCall(Return (*functionNull)()) {
+    return &rpcFutureCall<functionName, methodId, Return>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0>(channel, completion, arg0))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0>
+struct MakeAsyncFunctionPointer1 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer1<Return, Arg0>::type getRpcAsyncCall(Return (*functionNull)(Arg0)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0>;
+}
+
+template <typename Return, typename Arg0>
+struct MakeFutureFunctionPointer1 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer1<Return, Arg0>::type getRpcFutureCall(Return (*functionNull)(Arg0)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1>(channel, completion, arg0, arg1))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1>
+struct MakeAsyncFunctionPointer2 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer2<Return, Arg0, Arg1>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1>;
+}
+
+template <typename Return, typename Arg0, typename Arg1>
+struct MakeFutureFunctionPointer2 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer2<Return, Arg0, Arg1>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2>(channel, completion, arg0, arg1, arg2))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2>
+struct MakeAsyncFunctionPointer3 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer3<Return, Arg0, Arg1, Arg2>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2>
+struct MakeFutureFunctionPointer3 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer3<Return, Arg0, Arg1, Arg2>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3>(channel, completion, arg0, arg1, arg2, arg3))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+struct MakeAsyncFunctionPointer4 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer4<Return, Arg0, Arg1, Arg2, Arg3>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+struct MakeFutureFunctionPointer4 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer4<Return, Arg0, Arg1, Arg2, Arg3>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)
+            || !reflectSerialize(arg4, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4>(channel, completion, arg0, arg1, arg2, arg3, arg4))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+struct MakeAsyncFunctionPointer5 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer5<Return, Arg0, Arg1, Arg2, Arg3, Arg4>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+struct MakeFutureFunctionPointer5 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer5<Return, Arg0, Arg1, Arg2, Arg3, Arg4>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)
+            || !reflectSerialize(arg4, writer)
+            || !reflectSerialize(arg5, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>(channel, completion, arg0, arg1, arg2, arg3, arg4, arg5))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+struct MakeAsyncFunctionPointer6 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer6<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+struct MakeFutureFunctionPointer6 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer6<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)
+            || !reflectSerialize(arg4, writer)
+            || !reflectSerialize(arg5, writer)
+            || !reflectSerialize(arg6, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>(channel, completion, arg0, arg1, arg2, arg3, arg4, arg5, arg6))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+struct MakeAsyncFunctionPointer7 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer7<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+struct MakeFutureFunctionPointer7 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer7<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)
+            || !reflectSerialize(arg4, writer)
+            || !reflectSerialize(arg5, writer)
+            || !reflectSerialize(arg6, writer)
+            || !reflectSerialize(arg7, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>(channel, completion, arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+struct MakeAsyncFunctionPointer8 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer8<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+struct MakeFutureFunctionPointer8 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer8<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)
+            || !reflectSerialize(arg4, writer)
+            || !reflectSerialize(arg5, writer)
+            || !reflectSerialize(arg6, writer)
+            || !reflectSerialize(arg7, writer)
+            || !reflectSerialize(arg8, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>(channel, completion, arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+struct MakeAsyncFunctionPointer9 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer9<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+struct MakeFutureFunctionPointer9 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer9<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8>;
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+bool rpcAsyncCall(
+        IAsyncRpcChannel& channel, IRpcCompletion* completion, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8, Arg9 const& arg9) {
+    IWriter* writer;
+
+    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))
+        return false;
+
+    if (!reflectSerialize(arg0, writer)
+            || !reflectSerialize(arg1, writer)
+            || !reflectSerialize(arg2, writer)
+            || !reflectSerialize(arg3, writer)
+            || !reflectSerialize(arg4, writer)
+            || !reflectSerialize(arg5, writer)
+            || !reflectSerialize(arg6, writer)
+            || !reflectSerialize(arg7, writer)
+            || !reflectSerialize(arg8, writer)
+            || !reflectSerialize(arg9, writer)) {
+        channel.cancelAsyncCall();
+        return false;
+    }
+
+    return channel.submitAsyncCall(completion);
+}
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+std::future<Return> rpcFutureCall(
+        IAsyncRpcChannel& channel, Arg0 const& arg0, Arg1 const& arg1, Arg2 const& arg2, Arg3 const& arg3, Arg4 const& arg4, Arg5 const& arg5, Arg6 const& arg6, Arg7 const& arg7, Arg8 const& arg8, Arg9 const& arg9) {
+    auto completion = new FutureCompletion_<Return>();
+    std::future<Return> future = completion->promise.get_future();
+
+    if (!rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>(channel, completion, arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9))
+        completion->complete(err, nullptr);
+
+    return future;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+struct MakeAsyncFunctionPointer10 {
+    typedef bool (*type)(IAsyncRpcChannel&, IRpcCompletion*, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&, Arg9 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+RPC_CONSTEXPR_FUNC typename MakeAsyncFunctionPointer10<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>::type getRpcAsyncCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)) {
+    return &rpcAsyncCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
+}
+
+template <typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+struct MakeFutureFunctionPointer10 {
+    typedef std::future<Return> (*type)(IAsyncRpcChannel&, Arg0 const&, Arg1 const&, Arg2 const&, Arg3 const&, Arg4 const&, Arg5 const&, Arg6 const&, Arg7 const&, Arg8 const&, Arg9 const&);
+};
+
+template <const char* functionName, RpcMethodId_t methodId, typename Return, typename Arg0, typename Arg1, typename Arg2, typename Arg3, typename Arg4, typename Arg5, typename Arg6, typename Arg7, typename Arg8, typename Arg9>
+RPC_CONSTEXPR_FUNC typename MakeFutureFunctionPointer10<Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>::type getRpcFutureCall(Return (*functionNull)(Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9)) {
+    return &rpcFutureCall<functionName, methodId, Return, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7, Arg8, Arg9>;
+}
+
+}
@@ -29,38 +29,37 @@
 #include "base.hpp"
 #include "generated_magic.hpp"
 
+#include <type_traits>
+
+// Field declarations expand to calls on the visitor passed to reflection_s_forEachField,
+// so that the same list builds the type-erased Field_t table and drives reflectVisit.
+
 #define REFL_FIELD(field_, ...) \
-            ::reflection::makeField(#field_, &::reflection::fieldGetter<ThisClass, decltype(field_), &ThisClass::field_>,\
-            ::reflection::reflectionForType2<decltype(field_)>(),\
+            reflection_v.template field<ThisClass, decltype(field_), &ThisClass::field_>(#field_,\
             ::reflection::FIELD_STATE, ##__VA_ARGS__),\
 
 #define REFL_DEPENDENCY(field_, ...) \
-            ::reflection::makeDependency(#field_, &::reflection::fieldGetter<ThisClass, decltype(field_), &ThisClass::field_>,\
-            &::reflection::remove_all_pointers<decltype(field_)>::type::reflection_s_uuid(REFL_MATCH),\
+            reflection_v.template dependency<ThisClass, decltype(field_), &ThisClass::field_>(#field_,\
             ::reflection::FIELD_DEPENDENCY, ##__VA_ARGS__),\
 
 #define REFL_CONFIG(field_, ...) \
-            ::reflection::makeConfig(#field_, &::reflection::fieldGetter<ThisClass, decltype(field_), &ThisClass::field_>,\
-            ::reflection::reflectionForType2<decltype(field_)>(),\
+            reflection_v.template field<ThisClass, decltype(field_), &ThisClass::field_>(#field_,\
             ::reflection::FIELD_CONFIG, ##__VA_ARGS__),\
 
 #define REFL_MUST_CONFIG(field_, ...) \
-            ::reflection::makeConfig(#field_, &::reflection::fieldGetter<ThisClass, decltype(field_), &ThisClass::field_>,\
-            ::reflection::reflectionForType2<decltype(field_)>(),\
+            reflection_v.template field<ThisClass, decltype(field_), &ThisClass::field_>(#field_,\
             ::reflection::FIELD_CONFIG | ::reflection::FIELD_MANDATORY, ##__VA_ARGS__),\
 
 #define REFL_END \
-            ::reflection::makeField()\
-        };\
-\
-        static ::reflection::FieldSet_t const fieldSet = { thisClassName, fields, sizeof(fields) / sizeof(::reflection::Field_t) - 1, baseClassFields, derivedPtrToBasePtr };\
-        return &fieldSet;\
+            reflection_v.end();\
     }\
 
 #define REFL_CLASS_NAME(className_, version_)\
     static const char* reflection_s_classId(REFL_MATCH_0) { return className_ "," #version_; }\
+    static constexpr ::reflection::ClassIdHash_t reflection_s_classIdHash(REFL_MATCH_0) { return ::reflection::hashClassId(className_ "," #version_); }\
     static const char* reflection_s_className(REFL_MATCH_0) { return className_; }\
     const char* reflection_classId(REFL_MATCH_0) const { return className_ "," #version_; }\
+    ::reflection::ClassIdHash_t reflection_classIdHash(REFL_MATCH_0) const { return ::reflection::hashClassId(className_ "," #version_); }\
     const char* reflection_className(REFL_MATCH_0) const { return className_; }\
 
 #define REFL_UUID(_0, _1, _2, _3) public:\
@@ -104,13 +103,6 @@ inline Field_t makeDependency(const char* name, void* (*fieldGetter)(const void*
     return field;
 }
 
-inline Field_t makeConfig(const char* name, void* (*fieldGetter)(const void*),
-        ITypeReflection* refl, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
-    Field_t field = {name, fieldGetter, systemFlags, flags, params};
-    field.refl = refl;
-    return field;
-}
-
 template <class C, typename T, T C::*field>
 static void* fieldGetter(const void* instance) {
     return (void*) &(reinterpret_cast<const C*>(instance)->*field);
@@ -120,4 +112,194 @@ template <class Derived, class Base>
 static void* derivedPtrToBasePtr(void* derived) {
     return (void*) static_cast<const Base*>(reinterpret_cast<Derived*>(derived));
 }
+
+// arithmetic fields of standard-layout classes have a well-defined offset and may be copied as raw bytes
+// (bool is excluded, as not every byte value is a valid bool)
+template <class C, typename T>
+struct IsFixedSizeField {
+    enum { value = std::is_standard_layout<C>::value && std::is_arithmetic<T>::value && !std::is_same<T, bool>::value };
+};
+
+template <class C, typename T, T C::*member>
+size_t fieldOffset() {
+    // any suitably aligned non-null address will do, fieldGetter never dereferences it
+    char* const inst = reinterpret_cast<char*>(0x10000);
+    return (size_t) (reinterpret_cast<char*>(fieldGetter<C, T, member>(inst)) - inst);
+}
+
+// field list visitors (see REFL_FIELD)
+
+class FieldCounter {
+public:
+    FieldCounter() : numFields(0) {}
+
+    template <class C, typename T, T C::*member>
+    void field(const char* name, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
+        numFields++;
+    }
+
+    template <class C, typename T, T C::*member>
+    void dependency(const char* name, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
+        numFields++;
+    }
+
+    void end() {}
+
+    size_t numFields;
+};
+
+class FieldTableBuilder {
+public:
+    FieldTableBuilder(Field_t* fields) : fields(fields), numFields(0) {}
+
+    template <class C, typename T, T C::*member>
+    void field(const char* name, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
+        Field_t& field = fields[numFields++];
+        field = makeField(name, &fieldGetter<C, T, member>, reflectionForType2<T>(), systemFlags, flags, params);
+
+        if (IsFixedSizeField<C, T>::value) {
+            field.offset = fieldOffset<C, T, member>();
+            field.fixedSize = sizeof(T);
+        }
+    }
+
+    template <class C, typename T, T C::*member>
+    void dependency(const char* name, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
+        fields[numFields++] = makeDependency(name, &fieldGetter<C, T, member>,
+                &remove_all_pointers<T>::type::reflection_s_uuid(REFL_MATCH), systemFlags, flags, params);
+    }
+
+    void end() {}
+
+    Field_t* fields;
+    size_t numFields;
+};
+
+// passes each field of an instance to visitor(value, name, systemFlags, flags) with its actual type
+template <class Inst, class Visitor>
+class InstanceFieldVisitor {
+public:
+    InstanceFieldVisitor(Inst& inst, Visitor& visitor) : inst(inst), visitor(visitor) {}
+
+    template <class C, typename T, T C::*member>
+    void field(const char* name, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
+        visitor(inst.*member, name, systemFlags, flags);
+    }
+
+    template <class C, typename T, T C::*member>
+    void dependency(const char* name, uint32_t systemFlags, uint32_t flags = 0, const char* params = nullptr) {
+        visitor(inst.*member, name, systemFlags, flags);
+    }
+
+    void end() {}
+
+    Inst& inst;
+    Visitor& visitor;
+};
+
+// Builds the flattened field table for a class; base classes must be complete already.
+// Base pointer adjustments are computed once, so only non-virtual inheritance is supported
+// (which is all REFL_BEGIN_EXTENDS can express). Returns nullptr if the table can't be allocated.
+inline FlatFieldTable_t const* buildFlatFieldTable(FieldSet_t const* fieldSet) {
+    size_t numFields = 0;
+
+    for (FieldSet_t const* p_fieldSet = fieldSet; p_fieldSet != nullptr; p_fieldSet = p_fieldSet->baseClassFields)
+        numFields += p_fieldSet->numFields;
+
+    // header, entries, runs and name index in one block; the table is never freed
+    auto table = (FlatFieldTable_t*) malloc(sizeof(FlatFieldTable_t) + numFields * sizeof(FlatField_t)
+            + numFields * sizeof(FixedRun_t) + numFields * sizeof(uint32_t));
+
+    if (table == nullptr)
+        return nullptr;
+
+    auto fields = reinterpret_cast<FlatField_t*>(table + 1);
+    auto fixedRuns = reinterpret_cast<FixedRun_t*>(fields + numFields);
+    auto byName = reinterpret_cast<uint32_t*>(fixedRuns + numFields);
+
+    // any suitably aligned non-null address will do, derivedPtrToBasePtr never dereferences it
+    char* const derived = reinterpret_cast<char*>(0x10000);
+    char* base = derived;
+    size_t index = 0;
+
+    for (FieldSet_t const* p_fieldSet = fieldSet; p_fieldSet != nullptr; p_fieldSet = p_fieldSet->baseClassFields) {
+        for (size_t i = 0; i < p_fieldSet->numFields; i++) {
+            fields[index].field = &p_fieldSet->fields[i];
+            fields[index].className = p_fieldSet->className;
+            fields[index].baseOffset = base - derived;
+            index++;
+        }
+
+        if (p_fieldSet->baseClassFields != nullptr)
+            base = reinterpret_cast<char*>(p_fieldSet->derivedPtrToBasePtr(base));
+    }
+
+    // merge fixed-size fields which directly follow each other both in memory and in serialization order
+    size_t numFixedRuns = 0;
+
+    for (size_t i = 0; i < numFields; i++) {
+        const Field_t& field = *fields[i].field;
+
+        if (field.fixedSize != 0) {
+            size_t offset = fields[i].baseOffset + field.offset;
+            FixedRun_t* last = (numFixedRuns > 0) ? &fixedRuns[numFixedRuns - 1] : nullptr;
+
+            if (last != nullptr && last->size != 0 && last->offset + last->size == offset) {
+                last->size += field.fixedSize;
+                last->numFields++;
+                continue;
+            }
+
+            fixedRuns[numFixedRuns++] = FixedRun_t {offset, field.fixedSize, (uint32_t) i, 1};
+        }
+        else
+            fixedRuns[numFixedRuns++] = FixedRun_t {0, 0, (uint32_t) i, 1};
+    }
+
+    // insertion sort: stable, and classes rarely have more than a few dozen fields
+    for (size_t i = 0; i < numFields; i++) {
+        size_t j = i;
+
+        for (; j > 0 && strcmp(fields[byName[j - 1]].field->name, fields[i].field->name) > 0; j--)
+            byName[j] = byName[j - 1];
+
+        byName[j] = (uint32_t) i;
+    }
+
+    table->fields = fields;
+    table->numFields = numFields;
+    table->byName = byName;
+    table->fixedRuns = fixedRuns;
+    table->numFixedRuns = numFixedRuns;
+    return table;
+}
+
+template <class C>
+FieldSet_t makeFieldSet(const char* className, FieldSet_t const* baseClassFields, void* (*derivedPtrToBasePtr)(void*)) {
+    FieldCounter counter;
+    C::template reflection_s_forEachField<C>(counter);
+
+    // allocated once per class and never freed, like the FieldSet_t itself
+    auto fields = (Field_t*) malloc((counter.numFields + 1) * sizeof(Field_t));
+
+    if (fields == nullptr) {
+        // the class is left without fields rather than without a field set
+        static const Field_t noFields[] = { makeField() };
+
+        err->allocationError("reflection::makeFieldSet");
+        FieldSet_t fieldSet = { className, noFields, 0, baseClassFields, derivedPtrToBasePtr, nullptr };
+        return fieldSet;
+    }
+
+    FieldTableBuilder builder(fields);
+    C::template reflection_s_forEachField<C>(builder);
+    fields[builder.numFields] = makeField();
+
+    FieldSet_t fieldSet = { className, fields, builder.numFields, baseClassFields, derivedPtrToBasePtr, nullptr };
+
+    // built here, while the function-local static holding the set is being initialized, so that threads
+    // reflecting the class for the first time at once don't race on it
+    fieldSet.flatFields = buildFlatFieldTable(&fieldSet);
+    return fieldSet;
+}
 }
@@ -0,0 +1,866 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+
+// buffer sizes that always suffice for formatInteger/formatFloat (no terminator is written)
+enum {
+    MAX_INTEGER_CHARS = 20,     // "-9223372036854775808", "18446744073709551615"
+    MAX_FLOAT_CHARS = 32,
+};
+
+namespace numeric {
+static const char DIGIT_PAIRS[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+inline unsigned countDigits(uint64_t value) {
+    unsigned digits = 1;
+
+    for (;;) {
+        if (value < 10) return digits;
+        if (value < 100) return digits + 1;
+        if (value < 1000) return digits + 2;
+        if (value < 10000) return digits + 3;
+
+        value /= 10000;
+        digits += 4;
+    }
+}
+
+// writes exactly `digits` characters, two at a time from the end
+inline void writeDigits(char* buf, uint64_t value, unsigned digits) {
+    char* p = buf + digits;
+
+    while (value >= 100) {
+        unsigned pair = (unsigned) (value % 100) * 2;
+        value /= 100;
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+    }
+
+    if (value >= 10) {
+        *--p = DIGIT_PAIRS[value * 2 + 1];
+        *--p = DIGIT_PAIRS[value * 2];
+    }
+    else
+        *--p = (char) ('0' + value);
+}
+
+// Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+// Always round-trips; the result is the shortest representation in all but a handful of cases.
+struct DiyFp_t {
+    uint64_t f;
+    int e;
+};
+
+struct CachedPower_t {
+    uint64_t f;
+    int e;
+    int k;
+};
+
+// normalized 10^k for k = -300, -292, ..., 324
+static const CachedPower_t CACHED_POWERS[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+    { 0xD3515C2831559A83ULL,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+    { 0xEA9C227723EE8BCBULL,  -901, -252 },
+    { 0xAECC49914078536DULL,  -874, -244 },
+    { 0x823C12795DB6CE57ULL,  -847, -236 },
+    { 0xC21094364DFB5637ULL,  -821, -228 },
+    { 0x9096EA6F3848984FULL,  -794, -220 },
+    { 0xD77485CB25823AC7ULL,  -768, -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+    { 0xEF340A98172AACE5ULL,  -715, -196 },
+    { 0xB23867FB2A35B28EULL,  -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+    { 0x936B9FCEBB25C996ULL,  -608, -164 },
+    { 0xDBAC6C247D62A584ULL,  -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+    { 0x87625F056C7C4A8BULL,  -475, -124 },
+    { 0xC9BCFF6034C13053ULL,  -449, -116 },
+    { 0x964E858C91BA2655ULL,  -422, -108 },
+    { 0xDFF9772470297EBDULL,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+    { 0xB94470938FA89BCFULL,  -316,  -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+    { 0xCDB02555653131B6ULL,  -263,  -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+    { 0xAA242499697392D3ULL,  -183,  -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+    { 0xBCE5086492111AEBULL,  -130,  -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+    { 0xD1B71758E219652CULL,   -77,   -4 },
+    { 0x9C40000000000000ULL,   -50,    4 },
+    { 0xE8D4A51000000000ULL,   -24,   12 },
+    { 0xAD78EBC5AC620000ULL,     3,   20 },
+    { 0x813F3978F8940984ULL,    30,   28 },
+    { 0xC097CE7BC90715B3ULL,    56,   36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+    { 0xD5D238A4ABE98068ULL,   109,   52 },
+    { 0x9F4F2726179A2245ULL,   136,   60 },
+    { 0xED63A231D4C4FB27ULL,   162,   68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+    { 0x83C7088E1AAB65DBULL,   216,   84 },
+    { 0xC45D1DF942711D9AULL,   242,   92 },
+    { 0x924D692CA61BE758ULL,   269,  100 },
+    { 0xDA01EE641A708DEAULL,   295,  108 },
+    { 0xA26DA3999AEF774AULL,   322,  116 },
+    { 0xF209787BB47D6B85ULL,   348,  124 },
+    { 0xB454E4A179DD1877ULL,   375,  132 },
+    { 0x865B86925B9BC5C2ULL,   402,  140 },
+    { 0xC83553C5C8965D3DULL,   428,  148 },
+    { 0x952AB45CFA97A0B3ULL,   455,  156 },
+    { 0xDE469FBD99A05FE3ULL,   481,  164 },
+    { 0xA59BC234DB398C25ULL,   508,  172 },
+    { 0xF6C69A72A3989F5CULL,   534,  180 },
+    { 0xB7DCBF5354E9BECEULL,   561,  188 },
+    { 0x88FCF317F22241E2ULL,   588,  196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+    { 0x98165AF37B2153DFULL,   641,  212 },
+    { 0xE2A0B5DC971F303AULL,   667,  220 },
+    { 0xA8D9D1535CE3B396ULL,   694,  228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+    { 0xBB764C4CA7A44410ULL,   747,  244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+    { 0xD01FEF10A657842CULL,   800,  260 },
+    { 0x9B10A4E5E9913129ULL,   827,  268 },
+    { 0xE7109BFBA19C0C9DULL,   853,  276 },
+    { 0xAC2820D9623BF429ULL,   880,  284 },
+    { 0x80444B5E7AA7CF85ULL,   907,  292 },
+    { 0xBF21E44003ACDD2DULL,   933,  300 },
+    { 0x8E679C2F5E44FF8FULL,   960,  308 },
+    { 0xD433179D9C8CB841ULL,   986,  316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+};
+
+enum {
+    CACHED_POWERS_MIN_DEC_EXP = -300,
+    CACHED_POWERS_DEC_STEP = 8,
+    GRISU_ALPHA = -60,
+    GRISU_GAMMA = -32,
+};
+
+inline DiyFp_t diyFpSub(DiyFp_t x, DiyFp_t y) {
+    return DiyFp_t { x.f - y.f, x.e };
+}
+
+// upper half of the 128-bit product, rounded
+inline DiyFp_t diyFpMul(DiyFp_t x, DiyFp_t y) {
+    const uint64_t xLo = x.f & 0xFFFFFFFFu, xHi = x.f >> 32;
+    const uint64_t yLo = y.f & 0xFFFFFFFFu, yHi = y.f >> 32;
+
+    const uint64_t p0 = xLo * yLo;
+    const uint64_t p1 = xLo * yHi;
+    const uint64_t p2 = xHi * yLo;
+    const uint64_t p3 = xHi * yHi;
+
+    uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    q += uint64_t(1) << 31;
+
+    return DiyFp_t { p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64 };
+}
+
+inline DiyFp_t diyFpNormalize(DiyFp_t x) {
+    while ((x.f >> 63) == 0) {
+        x.f <<= 1;
+        x.e--;
+    }
+
+    return x;
+}
+
+inline DiyFp_t diyFpNormalizeTo(DiyFp_t x, int e) {
+    return DiyFp_t { x.f << (x.e - e), e };
+}
+
+template <typename Float_t> struct FloatBits;
+template <> struct FloatBits<float> { typedef uint32_t type; };
+template <> struct FloatBits<double> { typedef uint64_t type; };
+
+// v = m_plus/m_minus midpoints to the neighbouring representable values, all sharing m_plus's exponent
+template <typename Float_t>
+void computeBoundaries(Float_t value, DiyFp_t& v, DiyFp_t& m_minus, DiyFp_t& m_plus) {
+    typedef typename FloatBits<Float_t>::type Bits_t;
+
+    const int precision = std::numeric_limits<Float_t>::digits;
+    const int bias = std::numeric_limits<Float_t>::max_exponent - 1 + (precision - 1);
+    const int minExp = 1 - bias;
+    const uint64_t hiddenBit = uint64_t(1) << (precision - 1);
+
+    Bits_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint64_t E = bits >> (precision - 1);
+    const uint64_t F = bits & (hiddenBit - 1);
+
+    v = (E == 0) ? DiyFp_t { F, minExp } : DiyFp_t { F + hiddenBit, (int) E - bias };
+
+    const bool lowerBoundaryIsCloser = (F == 0 && E > 1);
+    const DiyFp_t plus = { 2 * v.f + 1, v.e - 1 };
+    const DiyFp_t minus = lowerBoundaryIsCloser ? DiyFp_t { 4 * v.f - 1, v.e - 2 } : DiyFp_t { 2 * v.f - 1, v.e - 1 };
+
+    m_plus = diyFpNormalize(plus);
+    m_minus = diyFpNormalizeTo(minus, m_plus.e);
+    v = diyFpNormalize(v);
+}
+
+// c = 10^-k such that alpha <= e + c.e <= gamma
+inline const CachedPower_t& cachedPowerForBinaryExponent(int e) {
+    const int f = GRISU_ALPHA - e - 1;
+    const int k = (f * 78913) / (1 << 18) + (f > 0);
+    const int index = (-CACHED_POWERS_MIN_DEC_EXP + k + (CACHED_POWERS_DEC_STEP - 1)) / CACHED_POWERS_DEC_STEP;
+
+    return CACHED_POWERS[index];
+}
+
+// returns number of digits of n and sets pow10 to 10^(digits - 1)
+inline int largestPow10(uint32_t n, uint32_t& pow10) {
+    if (n >= 1000000000) { pow10 = 1000000000; return 10; }
+    if (n >= 100000000) { pow10 = 100000000; return 9; }
+    if (n >= 10000000) { pow10 = 10000000; return 8; }
+    if (n >= 1000000) { pow10 = 1000000; return 7; }
+    if (n >= 100000) { pow10 = 100000; return 6; }
+    if (n >= 10000) { pow10 = 10000; return 5; }
+    if (n >= 1000) { pow10 = 1000; return 4; }
+    if (n >= 100) { pow10 = 100; return 3; }
+    if (n >= 10) { pow10 = 10; return 2; }
+
+    pow10 = 1;
+    return 1;
+}
+
+inline void grisuRound(char* buf, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t tenK) {
+    while (rest < dist && delta - rest >= tenK
+            && (rest + tenK < dist || dist - rest > rest + tenK - dist)) {
+        buf[length - 1]--;
+        rest += tenK;
+    }
+}
+
+inline void grisuDigitGen(char* buf, int& length, int& decimalExponent, DiyFp_t M_minus, DiyFp_t w, DiyFp_t M_plus) {
+    uint64_t delta = diyFpSub(M_plus, M_minus).f;
+    uint64_t dist = diyFpSub(M_plus, w).f;
+
+    const DiyFp_t one = { uint64_t(1) << -M_plus.e, M_plus.e };
+
+    uint32_t p1 = (uint32_t) (M_plus.f >> -one.e);
+    uint64_t p2 = M_plus.f & (one.f - 1);
+
+    // integral part
+    uint32_t pow10;
+    int n = largestPow10(p1, pow10);
+
+    while (n > 0) {
+        const uint32_t d = p1 / pow10;
+        p1 %= pow10;
+        buf[length++] = (char) ('0' + d);
+        n--;
+
+        const uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+
+        if (rest <= delta) {
+            decimalExponent += n;
+            grisuRound(buf, length, dist, delta, rest, uint64_t(pow10) << -one.e);
+            return;
+        }
+
+        pow10 /= 10;
+    }
+
+    // fractional part
+    int m = 0;
+
+    for (;;) {
+        p2 *= 10;
+        const uint64_t d = p2 >> -one.e;
+        p2 &= one.f - 1;
+        buf[length++] = (char) ('0' + d);
+        m++;
+
+        delta *= 10;
+        dist *= 10;
+
+        if (p2 <= delta)
+            break;
+    }
+
+    decimalExponent -= m;
+    grisuRound(buf, length, dist, delta, p2, one.f);
+}
+
+// value must be finite and positive; produces digits d1..dn with value ~= d1..dn * 10^decimalExponent
+template <typename Float_t>
+void grisu2(char* buf, int& length, int& decimalExponent, Float_t value) {
+    DiyFp_t v, m_minus, m_plus;
+    computeBoundaries(value, v, m_minus, m_plus);
+
+    const CachedPower_t& cached = cachedPowerForBinaryExponent(m_plus.e);
+    const DiyFp_t c_minus_k = { cached.f, cached.e };
+
+    const DiyFp_t w = diyFpMul(v, c_minus_k);
+    const DiyFp_t w_minus = diyFpMul(m_minus, c_minus_k);
+    const DiyFp_t w_plus = diyFpMul(m_plus, c_minus_k);
+
+    // shrink the interval by one unit on both sides to stay safely inside the rounding range
+    const DiyFp_t M_minus = { w_minus.f + 1, w_minus.e };
+    const DiyFp_t M_plus = { w_plus.f - 1, w_plus.e };
+
+    length = 0;
+    decimalExponent = -cached.k;
+    grisuDigitGen(buf, length, decimalExponent, M_minus, w, M_plus);
+}
+
+// lays out `length` digits (already at buf) the way "%g" would, minus the trailing zero padding
+inline size_t formatDecimal(char* buf, int length, int decimalExponent, int maxExp) {
+    const int n = length + decimalExponent;     // position of the decimal point
+
+    if (length <= n && n <= maxExp) {
+        // 1234e5 -> 123400000
+        memset(buf + length, '0', n - length);
+        return n;
+    }
+
+    if (0 < n && n <= maxExp) {
+        // 1234e-2 -> 12.34
+        memmove(buf + n + 1, buf + n, length - n);
+        buf[n] = '.';
+        return length + 1;
+    }
+
+    if (-4 < n && n <= 0) {
+        // 1234e-6 -> 0.001234
+        memmove(buf + 2 - n, buf, length);
+        buf[0] = '0';
+        buf[1] = '.';
+        memset(buf + 2, '0', -n);
+        return 2 - n + length;
+    }
+
+    // 1234e30 -> 1.234e+33
+    size_t pos = 1;
+
+    if (length > 1) {
+        memmove(buf + 2, buf + 1, length - 1);
+        buf[1] = '.';
+        pos = length + 1;
+    }
+
+    int exp = n - 1;
+    buf[pos++] = 'e';
+    buf[pos++] = (exp < 0) ? '-' : '+';
+
+    if (exp < 0)
+        exp = -exp;
+
+    if (exp < 10) {
+        buf[pos++] = '0';
+        buf[pos++] = (char) ('0' + exp);
+        return pos;
+    }
+
+    const unsigned expDigits = countDigits(exp);
+    writeDigits(buf + pos, exp, expDigits);
+    return pos + expDigits;
+}
+}
+
+// decimal representation of an integer; returns number of characters written
+template <typename Int_t>
+size_t formatInteger(char* buf, Int_t value) {
+    uint64_t magnitude = (uint64_t) value;
+    size_t sign = 0;
+
+    if (std::numeric_limits<Int_t>::is_signed && value < 0) {
+        magnitude = 0 - magnitude;
+        *buf = '-';
+        sign = 1;
+    }
+
+    const unsigned digits = numeric::countDigits(magnitude);
+    numeric::writeDigits(buf + sign, magnitude, digits);
+    return sign + digits;
+}
+
+// shortest decimal representation that reads back as the same value; returns number of characters written
+template <typename Float_t>
+size_t formatFloat(char* buf, Float_t value) {
+    typedef typename numeric::FloatBits<Float_t>::type Bits_t;
+
+    Bits_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const bool negative = (bits >> (sizeof(bits) * 8 - 1)) != 0;
+
+    if (value != value)
+        return memcpy(buf, "nan", 3), 3;
+
+    size_t sign = 0;
+
+    if (negative) {
+        *buf = '-';
+        sign = 1;
+        value = -value;
+    }
+
+    if (value == std::numeric_limits<Float_t>::infinity())
+        return memcpy(buf + sign, "inf", 3), sign + 3;
+
+    if (value == 0)
+        return buf[sign] = '0', sign + 1;
+
+    int length, decimalExponent;
+    numeric::grisu2(buf + sign, length, decimalExponent, value);
+
+    return sign + numeric::formatDecimal(buf + sign, length, decimalExponent,
+            std::numeric_limits<Float_t>::max_digits10);
+}
+
+enum ParseResult_t {
+    PARSE_OK,
+    PARSE_INVALID,      // not a number, or trailing garbage
+    PARSE_OVERFLOW,     // well-formed, but doesn't fit the destination type
+};
+
+namespace numeric {
+inline bool equalsIgnoreCase(const char* str, size_t strLen, const char* lowercase, size_t length) {
+    if (strLen != length)
+        return false;
+
+    for (size_t i = 0; i < length; i++) {
+        char c = str[i];
+
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+
+        if (c != lowercase[i])
+            return false;
+    }
+
+    return true;
+}
+
+inline int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 99;
+}
+
+inline bool isDigit(char c) {
+    return (unsigned char) (c - '0') < 10;
+}
+
+// magnitude in [0, limit], with the base picked like strtol(..., 0) does
+inline ParseResult_t parseMagnitude(const char* p, const char* end, uint64_t limit, uint64_t& value_out) {
+    unsigned base = 10;
+
+    if (end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        base = 16;
+        p += 2;
+    }
+    else if (end - p >= 2 && p[0] == '0')
+        base = 8;
+
+    if (p == end)
+        return PARSE_INVALID;
+
+    const uint64_t cutoff = limit / base;
+    const unsigned cutlim = (unsigned) (limit % base);
+    uint64_t value = 0;
+
+    for (; p < end; p++) {
+        const unsigned d = (unsigned) digitValue(*p);
+
+        if (d >= base)
+            return PARSE_INVALID;
+
+        if (value > cutoff || (value == cutoff && d > cutlim)) {
+            // keep validating so that "12x..." isn't reported as an overflow
+            for (p++; p < end; p++)
+                if ((unsigned) digitValue(*p) >= base)
+                    return PARSE_INVALID;
+
+            return PARSE_OVERFLOW;
+        }
+
+        value = value * base + d;
+    }
+
+    value_out = value;
+    return PARSE_OK;
+}
+
+template <typename Float_t> struct FloatParseTraits;
+
+template <> struct FloatParseTraits<float> {
+    enum { MAX_EXACT_POW10 = 10 };
+    static uint64_t maxExactMantissa() { return uint64_t(1) << 24; }
+    static float convert(const char* str) { return strtof(str, nullptr); }
+};
+
+template <> struct FloatParseTraits<double> {
+    enum { MAX_EXACT_POW10 = 22 };
+    static uint64_t maxExactMantissa() { return uint64_t(1) << 53; }
+    static double convert(const char* str) { return strtod(str, nullptr); }
+};
+
+template <typename Float_t>
+Float_t exactPow10(int exp) {
+    static const Float_t POWERS[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    return POWERS[exp];
+}
+
+// builds a Float_t from f * 2^e, where f has at most `digits` significant bits; rounds to zero/inf out of range
+template <typename Float_t>
+Float_t diyFpToFloat(DiyFp_t x) {
+    typedef typename FloatBits<Float_t>::type Bits_t;
+
+    const int precision = std::numeric_limits<Float_t>::digits;
+    const int bias = std::numeric_limits<Float_t>::max_exponent - 1 + (precision - 1);
+    const int denormalExp = 1 - bias;
+    const int maxExp = 2 * std::numeric_limits<Float_t>::max_exponent - 1 - bias;
+    const uint64_t hiddenBit = uint64_t(1) << (precision - 1);
+    const uint64_t significandMask = hiddenBit - 1;
+
+    uint64_t f = x.f;
+    int e = x.e;
+
+    while (f > hiddenBit + significandMask) {
+        f >>= 1;
+        e++;
+    }
+
+    if (e >= maxExp)
+        return std::numeric_limits<Float_t>::infinity();
+
+    if (e < denormalExp)
+        return 0;
+
+    while (e > denormalExp && (f & hiddenBit) == 0) {
+        f <<= 1;
+        e--;
+    }
+
+    const uint64_t biasedExp = (e == denormalExp && (f & hiddenBit) == 0) ? 0 : (uint64_t) (e + bias);
+    const Bits_t bits = (Bits_t) ((f & significandMask) | (biasedExp << (precision - 1)));
+
+    Float_t value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Approximates mantissa * 10^exp10 with 64-bit arithmetic and tracks the error bound
+// (the same scheme as double-conversion's DiyFpStrtod). Returns false if the result
+// is too close to a rounding boundary to be decided this way.
+template <typename Float_t>
+bool diyFpStrtod(uint64_t mantissa, bool inexact, int exp10, Float_t& value_out) {
+    const int DENOMINATOR_LOG = 3;
+    const int DENOMINATOR = 1 << DENOMINATOR_LOG;
+
+    const int precision = std::numeric_limits<Float_t>::digits;
+    const int bias = std::numeric_limits<Float_t>::max_exponent - 1 + (precision - 1);
+    const int denormalExp = 1 - bias;
+
+    if (exp10 < CACHED_POWERS_MIN_DEC_EXP
+            || exp10 >= CACHED_POWERS_MIN_DEC_EXP + (int) (sizeof(CACHED_POWERS) / sizeof(*CACHED_POWERS)) * CACHED_POWERS_DEC_STEP)
+        return false;
+
+    DiyFp_t input = diyFpNormalize(DiyFp_t { mantissa, 0 });
+    uint64_t error = inexact ? (uint64_t(DENOMINATOR / 2) << -input.e) : 0;
+
+    const CachedPower_t& cached = CACHED_POWERS[(exp10 - CACHED_POWERS_MIN_DEC_EXP) / CACHED_POWERS_DEC_STEP];
+
+    if (cached.k != exp10) {
+        // 10^1 .. 10^7 are exact in 64 bits
+        uint64_t adjustment = 10;
+
+        for (int i = 1; i < exp10 - cached.k; i++)
+            adjustment *= 10;
+
+        input = diyFpMul(input, diyFpNormalize(DiyFp_t { adjustment, 0 }));
+
+        if (countDigits(mantissa) + (exp10 - cached.k) > 19)
+            error += DENOMINATOR / 2;
+    }
+
+    input = diyFpMul(input, DiyFp_t { cached.f, cached.e });
+    error += DENOMINATOR / 2 + (error == 0 ? 0 : 1) + DENOMINATOR / 2;
+
+    const int oldE = input.e;
+    input = diyFpNormalize(input);
+    error <<= oldE - input.e;
+
+    // how many of the 64 bits survive in the target type (fewer for denormals)
+    const int magnitude = 64 + input.e;
+    int significandSize = (magnitude >= denormalExp + precision) ? precision
+            : (magnitude <= denormalExp) ? 0 : magnitude - denormalExp;
+    int precisionBitsCount = 64 - significandSize;
+
+    if (precisionBitsCount + DENOMINATOR_LOG >= 64) {
+        const int shift = precisionBitsCount + DENOMINATOR_LOG - 64 + 1;
+        input.f >>= shift;
+        input.e += shift;
+        error = (error >> shift) + 1 + DENOMINATOR;
+        precisionBitsCount -= shift;
+    }
+
+    const uint64_t precisionBits = (input.f & ((uint64_t(1) << precisionBitsCount) - 1)) * DENOMINATOR;
+    const uint64_t halfWay = (uint64_t(1) << (precisionBitsCount - 1)) * DENOMINATOR;
+
+    DiyFp_t rounded = { input.f >> precisionBitsCount, input.e + precisionBitsCount };
+
+    if (precisionBits >= halfWay + error)
+        rounded.f++;
+
+    if (halfWay - error < precisionBits && precisionBits < halfWay + error)
+        return false;
+
+    value_out = diyFpToFloat<Float_t>(rounded);
+    return true;
+}
+}
+
+// Parses a decimal (or 0x/0 prefixed hex/octal) integer from exactly `strLen` characters;
+// leading whitespace is skipped, anything else not part of the number is an error.
+template <typename Int_t>
+ParseResult_t parseInteger(const char* str, size_t strLen, Int_t& value_out) {
+    typedef std::numeric_limits<Int_t> Limits;
+
+    const char* p = str;
+    const char* end = str + strLen;
+
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+
+    bool negative = false;
+
+    if (p < end && (*p == '+' || *p == '-'))
+        negative = (*p++ == '-');
+
+    // "-0" is fine for unsigned types, anything more negative overflows
+    const uint64_t limit = !negative ? (uint64_t) Limits::max()
+            : Limits::is_signed ? (uint64_t) Limits::max() + 1 : 0;
+
+    uint64_t magnitude;
+    const ParseResult_t result = numeric::parseMagnitude(p, end, limit, magnitude);
+
+    if (result != PARSE_OK)
+        return result;
+
+    value_out = negative ? (Int_t) (0 - magnitude) : (Int_t) magnitude;
+    return PARSE_OK;
+}
+
+// Parses a decimal floating-point number (or inf/infinity/nan) from exactly `strLen` characters.
+// Independent of the C locale; correctly rounded.
+template <typename Float_t>
+ParseResult_t parseFloat(const char* str, size_t strLen, Float_t& value_out) {
+    typedef numeric::FloatParseTraits<Float_t> Traits;
+
+    const char* p = str;
+    const char* end = str + strLen;
+
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+
+    bool negative = false;
+
+    if (p < end && (*p == '+' || *p == '-'))
+        negative = (*p++ == '-');
+
+    if (numeric::equalsIgnoreCase(p, end - p, "inf", 3) || numeric::equalsIgnoreCase(p, end - p, "infinity", 8)) {
+        value_out = negative ? -std::numeric_limits<Float_t>::infinity() : std::numeric_limits<Float_t>::infinity();
+        return PARSE_OK;
+    }
+
+    if (numeric::equalsIgnoreCase(p, end - p, "nan", 3)) {
+        value_out = std::numeric_limits<Float_t>::quiet_NaN();
+        return PARSE_OK;
+    }
+
+    // split into significant digits and a decimal exponent
+    const char* intDigits = p;
+
+    while (p < end && numeric::isDigit(*p))
+        p++;
+
+    const char* intEnd = p;
+    const char* fracDigits = p;
+
+    if (p < end && *p == '.') {
+        fracDigits = ++p;
+
+        while (p < end && numeric::isDigit(*p))
+            p++;
+    }
+
+    const char* fracEnd = p;
+
+    if (intEnd == intDigits && fracEnd == fracDigits)
+        return PARSE_INVALID;
+
+    long exp10 = 0;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExp = false;
+
+        if (p < end && (*p == '+' || *p == '-'))
+            negativeExp = (*p++ == '-');
+
+        if (p == end)
+            return PARSE_INVALID;
+
+        for (; p < end && numeric::isDigit(*p); p++) {
+            if (exp10 < 100000)     // way past any representable value; stop counting
+                exp10 = exp10 * 10 + (*p - '0');
+        }
+
+        if (negativeExp)
+            exp10 = -exp10;
+    }
+
+    if (p != end)
+        return PARSE_INVALID;
+
+    exp10 -= (long) (fracEnd - fracDigits);
+
+    // first 19 significant digits, rounded
+    uint64_t mantissa = 0;
+    size_t numDigits = 0, trailingZeros = 0;
+
+    for (const char* q = intDigits; q < fracEnd; q++) {
+        if (q == intEnd)
+            q = fracDigits;
+
+        if (q == fracEnd)
+            break;
+
+        if (numDigits == 0 && *q == '0')
+            continue;
+
+        const unsigned d = *q - '0';
+        numDigits++;
+
+        if (numDigits <= 19)
+            mantissa = mantissa * 10 + d;
+        else if (numDigits == 20 && d >= 5)
+            mantissa++;
+
+        trailingZeros = (d == 0) ? trailingZeros + 1 : 0;
+    }
+
+    if (mantissa == 0) {
+        value_out = negative ? -Float_t(0) : Float_t(0);
+        return PARSE_OK;
+    }
+
+    const bool inexact = (numDigits - trailingZeros > 19);
+    const long mantissaExp10 = exp10 + (numDigits > 19 ? (long) (numDigits - 19) : 0);
+
+    // mantissa and power of ten are both exact, so a single rounding gives the right answer
+    if (!inexact && mantissa <= Traits::maxExactMantissa()
+            && mantissaExp10 >= -Traits::MAX_EXACT_POW10 && mantissaExp10 <= Traits::MAX_EXACT_POW10) {
+        Float_t value = (Float_t) mantissa;
+
+        if (mantissaExp10 < 0)
+            value /= numeric::exactPow10<Float_t>((int) -mantissaExp10);
+        else
+            value *= numeric::exactPow10<Float_t>((int) mantissaExp10);
+
+        value_out = negative ? -value : value;
+        return PARSE_OK;
+    }
+
+    Float_t value;
+
+    if (mantissaExp10 > -100000 && mantissaExp10 < 100000
+            && numeric::diyFpStrtod(mantissa, inexact, (int) mantissaExp10, value)) {
+        if (value == std::numeric_limits<Float_t>::infinity())
+            return PARSE_OVERFLOW;
+
+        value_out = negative ? -value : value;
+        return PARSE_OK;
+    }
+
+    // too close to call: hand strto* a "<digits>e<exp>" string, which contains no locale-dependent characters
+    const size_t maxLength = (intEnd - intDigits) + (fracEnd - fracDigits) + 2 + MAX_INTEGER_CHARS;
+    char stackBuf[128];
+    char* buf = (maxLength <= sizeof(stackBuf)) ? stackBuf : (char*) malloc(maxLength);
+
+    if (buf == nullptr)
+        return PARSE_INVALID;
+
+    char* out = buf;
+    memcpy(out, intDigits, intEnd - intDigits);
+    out += intEnd - intDigits;
+    memcpy(out, fracDigits, fracEnd - fracDigits);
+    out += fracEnd - fracDigits;
+    *out++ = 'e';
+    out += formatInteger(out, exp10);
+    *out = 0;
+
+    value = Traits::convert(buf);
+
+    if (buf != stackBuf)
+        free(buf);
+
+    if (value == std::numeric_limits<Float_t>::infinity())
+        return PARSE_OVERFLOW;
+
+    value_out = negative ? -value : value;
+    return PARSE_OK;
+}
+}
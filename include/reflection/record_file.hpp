@@ -0,0 +1,177 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "api.hpp"
+#include "serializer.hpp"
+
+#include <utility/memory_reader_writer.hpp>
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+using namespace serialization;
+
+// A record file holds many instances of one class, for archives and bulk processing:
+//
+//   "RFLRECS\0", class id (utf8), layout fingerprint (8 bytes, little-endian; 0 if not recorded)
+//   blocks:    RecordBlockHeader_t, then numRecords x (SmvInt length, untagged instance)
+//
+// Blocks let readers split a file between threads by hopping from block header to block header.
+
+static const char RECORD_FILE_MAGIC[8] = {'R', 'F', 'L', 'R', 'E', 'C', 'S', '\0'};
+enum { RECORD_BLOCK_SIZE = 64 * 1024 };
+
+struct RecordBlockHeader_t {
+    uint32_t size;                          // bytes following the header
+    uint32_t numRecords;
+};
+
+class RecordFileWriter {
+public:
+    RecordFileWriter(IWriter* writer, size_t blockSize = RECORD_BLOCK_SIZE)
+            : writer(writer), blockSize(blockSize), numRecords(0) {}
+
+    RecordFileWriter(const RecordFileWriter& other) = delete;
+    RecordFileWriter& operator =(const RecordFileWriter& other) = delete;
+
+    // pass reflectFingerprint<T>() to let readers check the layout before decoding anything
+    bool begin(const char* classId, Fingerprint_t fingerprint = 0) {
+        const uint64_t length = strlen(classId);
+
+        return writer->write(err, RECORD_FILE_MAGIC, sizeof(RECORD_FILE_MAGIC))
+                && SmvIntSerializer<uint64_t>::serializeValue(err, writer, length)
+                && writer->write(err, classId, (size_t) length)
+                && writeFingerprint(err, writer, fingerprint);
+    }
+
+    template <typename T>
+    bool write(const T& instance) {
+        record.reset();
+
+        if (!reflectSerialize(instance, &record))
+            return false;
+
+        return append(record.storage.buf, record.writePos);
+    }
+
+    // an already serialized instance
+    bool append(const void* instance, size_t size) {
+        const uint64_t length = size;
+
+        if (!SmvIntSerializer<uint64_t>::serializeValue(err, &block, length)
+                || !block.write(err, instance, size))
+            return false;
+
+        numRecords++;
+
+        if (block.writePos >= blockSize || numRecords == UINT32_MAX)
+            return flushBlock();
+
+        return true;
+    }
+
+    // writes out the last block; call once all records have been added
+    bool finish() {
+        return flushBlock();
+    }
+
+private:
+    bool flushBlock() {
+        if (numRecords == 0)
+            return true;
+
+        if (block.writePos > UINT32_MAX)
+            return err->error("RecordTooLarge", "Record block exceeds 4 GiB."), false;
+
+        const RecordBlockHeader_t header = { (uint32_t) block.writePos, numRecords };
+
+        if (!writer->write(err, &header, sizeof(header)) || !writer->write(err, block.storage.buf, block.writePos))
+            return false;
+
+        block.reset();
+        numRecords = 0;
+        return true;
+    }
+
+    IWriter* writer;
+    size_t blockSize;
+
+    utility::MemoryReaderWriter block, record;
+    uint32_t numRecords;
+};
+
+// checks the header of a mapped record file; the first block starts at recordsOffset_out
+static bool readRecordFileHeader(const uint8_t* data, size_t size, BufString_t& classId_out,
+        Fingerprint_t& fingerprint_out, size_t& recordsOffset_out) {
+    if (size < sizeof(RECORD_FILE_MAGIC) || memcmp(data, RECORD_FILE_MAGIC, sizeof(RECORD_FILE_MAGIC)) != 0)
+        return err->error("RecordFileFormatError", "Not a record file."), false;
+
+    const uint8_t* p = data + sizeof(RECORD_FILE_MAGIC);
+    const uint8_t* end = data + size;
+    uint64_t length;
+
+    if (!SmvIntSerializer<uint64_t>::decodeValue(p, end, length) || length + 8 > (uint64_t) (end - p))
+        return err->error("RecordFileFormatError", "Record file header is truncated."), false;
+
+    // not nul-terminated in the file
+    if (!ensureSize(err, classId_out.buf, classId_out.bufSize, (size_t) length + 1))
+        return false;
+
+    memcpy(classId_out.buf, p, (size_t) length);
+    classId_out.buf[length] = 0;
+    p += length;
+
+    fingerprint_out = 0;
+
+    for (size_t i = 0; i < 8; i++)
+        fingerprint_out |= (Fingerprint_t) p[i] << (i * 8);
+
+    recordsOffset_out = (p + 8) - data;
+    return true;
+}
+
+// reads the block header at offset; false if the block is truncated
+static bool readRecordBlock(const uint8_t* data, size_t size, size_t offset, RecordBlockHeader_t& header_out) {
+    if (size - offset < sizeof(RecordBlockHeader_t))
+        return false;
+
+    memcpy(&header_out, data + offset, sizeof(header_out));
+    return header_out.size <= size - offset - sizeof(RecordBlockHeader_t);
+}
+
+// steps over one framed record inside a block
+static bool nextRecord(const uint8_t*& p, const uint8_t* end, const uint8_t*& record_out, size_t& size_out) {
+    uint64_t length;
+
+    if (!SmvIntSerializer<uint64_t>::decodeValue(p, end, length) || length > (uint64_t) (end - p))
+        return false;
+
+    record_out = p;
+    size_out = (size_t) length;
+    p += length;
+    return true;
+}
+}
@@ -27,6 +27,9 @@
 #pragma once
 
 #include "base.hpp"
+#include "serializer.hpp"
+
+#include <stdexcept>
 
 #ifndef _MSC_VER
 #define RPC_CONSTEXPR constexpr
@@ -49,8 +52,14 @@ RPC_CONSTEXPR auto wrapperName_ = GET_RPC_EXECUTE(handlerClass_, functionName_);
 
 #define RPC_SERIALIZED(localName_, functionName_)\
 namespace { char localName_##_rpcFunctionName_[] = #functionName_; }\
-RPC_CONSTEXPR auto localName_ = ::rpc::getRpcSerializedCall<\
-        localName_##_rpcFunctionName_>(decltype(&functionName_)(nullptr));\
+RPC_CONSTEXPR auto localName_ = ::rpc::getRpcSerializedCall<localName_##_rpcFunctionName_,\
+        ::rpc::rpcMethodId(#functionName_, decltype(&functionName_)(nullptr))>(decltype(&functionName_)(nullptr));\
+
+// localName_(channel, args...) calls functionName_ through an IRpcChannel; throws rpc::RpcCallFailed on failure
+#define RPC_CHANNEL(localName_, functionName_)\
+namespace { char localName_##_rpcFunctionName_[] = #functionName_; }\
+RPC_CONSTEXPR auto localName_ = ::rpc::getRpcChannelCall<localName_##_rpcFunctionName_,\
+        ::rpc::rpcMethodId(#functionName_, decltype(&functionName_)(nullptr))>(decltype(&functionName_)(nullptr));\
 
 #define DEFINE_RPC_SERIALIZED(wrapperName_, functionName_)\
 RPC_CONSTEXPR auto wrapperName_ = ::rpc::getRpcSerializedExecute<decltype(&functionName_), &functionName_>(&functionName_);\
@@ -59,9 +68,85 @@ namespace rpc {
     using namespace reflection;
     using namespace serialization;
 
-    bool beginRPC(const char* functionName, bool returnsValue, IWriter*& writer_out, IReader*& reader_out);
+    // Stable 32-bit method ID: FNV-1a over the function name and the wire tags of its return and argument
+    // types, folded to 32 bits. Lets transports send a fixed 4-byte ID instead of the name; 0 is never
+    // produced and stands for "no ID, resolve by name".
+    typedef uint32_t RpcMethodId_t;
+
+    // wire tag of a parameter type; types without a Serializer go through class reflection
+    template <typename T, typename = void>
+    struct RpcTypeTag_ {
+        enum { value = TAG_CLASS };
+    };
+
+    template <typename T>
+    struct RpcTypeTag_<T, decltype((void) Serializer<T>::TAG)> {
+        enum { value = Serializer<T>::TAG };
+    };
+
+    template <>
+    struct RpcTypeTag_<void, void> {
+        enum { value = TAG_VOID };
+    };
+
+    constexpr uint64_t rpcSignatureMix(uint64_t hash, uint8_t byte) {
+        return (hash ^ byte) * 0x100000001b3ULL;
+    }
+
+    template <typename... Args>
+    struct RpcSignature_ {
+        static constexpr uint64_t mix(uint64_t hash) { return hash; }
+    };
+
+    template <typename Arg, typename... Args>
+    struct RpcSignature_<Arg, Args...> {
+        static constexpr uint64_t mix(uint64_t hash) {
+            return RpcSignature_<Args...>::mix(rpcSignatureMix(hash,
+                    RpcTypeTag_<typename std::remove_cv<typename std::remove_reference<Arg>::type>::type>::value));
+        }
+    };
+
+    constexpr RpcMethodId_t rpcFoldMethodId(uint64_t hash) {
+        return ((uint32_t) (hash ^ (hash >> 32)) != 0) ? (uint32_t) (hash ^ (hash >> 32)) : 1;
+    }
+
+    // name '(' argument tags ')' return tag
+    template <typename Return, typename... Args>
+    constexpr RpcMethodId_t rpcMethodId(const char* functionName, Return (*)(Args...)) {
+        return rpcFoldMethodId(RpcSignature_<Return>::mix(rpcSignatureMix(RpcSignature_<Args...>::mix(
+                rpcSignatureMix(hashClassId(functionName), '(')), ')')));
+    }
+
+    // Process-wide transport used by RPC_SERIALIZED calls; one call at a time
+    bool beginRPC(const char* functionName, RpcMethodId_t methodId, bool returnsValue,
+            IWriter*& writer_out, IReader*& reader_out);
     bool invokeRPC();
     void endRPC();
+
+    // Transport used by RPC_CHANNEL calls, with the same protocol as beginRPC/invokeRPC/endRPC.
+    // A channel carries one call at a time; channels share no state, so threads using separate
+    // channels need no locking.
+    class IRpcChannel {
+    public:
+        virtual ~IRpcChannel() {}
+
+        virtual bool beginCall(const char* functionName, RpcMethodId_t methodId, bool returnsValue,
+                IWriter*& writer_out, IReader*& reader_out) = 0;
+        virtual bool invokeCall() = 0;
+        virtual void endCall() = 0;
+    };
+
+    // thrown by RPC_CHANNEL calls that fail; stored in the future of RPC_ASYNC calls that fail
+    class RpcCallFailed : public std::runtime_error {
+    public:
+        RpcCallFailed() : std::runtime_error("RPC call failed") {}
+    };
+
+    // ends a call that began successfully, then fails it
+    [[noreturn]] inline void failRpcChannelCall(IRpcChannel& channel) {
+        channel.endCall();
+        throw RpcCallFailed();
+    }
 }
 
 #include "generated_rpc.hpp"
@@ -0,0 +1,144 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "rpc.hpp"
+
+#include <functional>
+#include <future>
+
+// localName_(channel, args...) starts functionName_ on an IAsyncRpcChannel and returns a std::future
+#define RPC_ASYNC(localName_, functionName_)\
+namespace { char localName_##_rpcFunctionName_[] = #functionName_; }\
+RPC_CONSTEXPR auto localName_ = ::rpc::getRpcFutureCall<localName_##_rpcFunctionName_,\
+        ::rpc::rpcMethodId(#functionName_, decltype(&functionName_)(nullptr))>(decltype(&functionName_)(nullptr));\
+
+// localName_(channel, completion, args...) starts functionName_ and reports the response to completion
+#define RPC_ASYNC_CALLBACK(localName_, functionName_)\
+namespace { char localName_##_rpcFunctionName_[] = #functionName_; }\
+RPC_CONSTEXPR auto localName_ = ::rpc::getRpcAsyncCall<localName_##_rpcFunctionName_,\
+        ::rpc::rpcMethodId(#functionName_, decltype(&functionName_)(nullptr))>(decltype(&functionName_)(nullptr));\
+
+namespace rpc {
+    // Receives the response of one asynchronous call, possibly on a transport thread.
+    // response is nullptr if the call failed (remote error, lost connection).
+    class IRpcCompletion {
+    public:
+        virtual ~IRpcCompletion() {}
+
+        virtual void complete(IErrorHandler* err, IReader* response) = 0;
+    };
+
+    // Transport for asynchronous calls. Any number of submitted calls may be outstanding on a channel;
+    // responses are delivered to their completions in whatever order they arrive.
+    //
+    // A call is written between beginAsyncCall and either submitAsyncCall or cancelAsyncCall; channels
+    // serialize this between threads, so it should not block. If submitAsyncCall returns true,
+    // completion->complete() is called exactly once, possibly before submitAsyncCall returns;
+    // otherwise it is not called at all.
+    class IAsyncRpcChannel {
+    public:
+        virtual ~IAsyncRpcChannel() {}
+
+        virtual bool beginAsyncCall(const char* functionName, RpcMethodId_t methodId, bool returnsValue,
+                IWriter*& writer_out) = 0;
+        virtual bool submitAsyncCall(IRpcCompletion* completion) = 0;
+        virtual void cancelAsyncCall() = 0;
+    };
+
+    template <typename Return>
+    class FutureCompletion_ : public IRpcCompletion {
+    public:
+        virtual void complete(IErrorHandler* err, IReader* response) override {
+            Return result;
+
+            if (response != nullptr && reflectDeserialize(result, response))
+                promise.set_value(std::move(result));
+            else
+                promise.set_exception(std::make_exception_ptr(RpcCallFailed()));
+
+            delete this;
+        }
+
+        std::promise<Return> promise;
+    };
+
+    template <>
+    class FutureCompletion_<void> : public IRpcCompletion {
+    public:
+        virtual void complete(IErrorHandler* err, IReader* response) override {
+            if (response != nullptr)
+                promise.set_value();
+            else
+                promise.set_exception(std::make_exception_ptr(RpcCallFailed()));
+
+            delete this;
+        }
+
+        std::promise<void> promise;
+    };
+
+    template <typename Return>
+    class CallbackCompletion_ : public IRpcCompletion {
+    public:
+        explicit CallbackCompletion_(std::function<void(bool ok, Return&& result)> callback) : callback(callback) {}
+
+        virtual void complete(IErrorHandler* err, IReader* response) override {
+            Return result = Return();
+            const bool ok = (response != nullptr && reflectDeserialize(result, response));
+
+            callback(ok, std::move(result));
+            delete this;
+        }
+
+    private:
+        std::function<void(bool ok, Return&& result)> callback;
+    };
+
+    template <>
+    class CallbackCompletion_<void> : public IRpcCompletion {
+    public:
+        explicit CallbackCompletion_(std::function<void(bool ok)> callback) : callback(callback) {}
+
+        virtual void complete(IErrorHandler* err, IReader* response) override {
+            callback(response != nullptr);
+            delete this;
+        }
+
+    private:
+        std::function<void(bool ok)> callback;
+    };
+
+    // Completion for RPC_ASYNC_CALLBACK calls that invokes callback and deletes itself.
+    // If the call cannot be submitted, the completion must be deleted by the caller.
+    template <typename Return, typename Callback>
+    IRpcCompletion* makeRpcCompletion(Callback callback) {
+        return new CallbackCompletion_<Return>(callback);
+    }
+}
+
+#include "generated_rpc_async.hpp"
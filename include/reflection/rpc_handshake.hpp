@@ -0,0 +1,101 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "class.hpp"
+#include "rpc.hpp"
+
+namespace rpc {
+// Type handshake for RPC connections: each side sends the class id hashes and layout fingerprints of
+// the classes it passes in calls, so that layouts are compared once per connection rather than per
+// message. Only classes whose fingerprints differ need the schema-based path.
+//
+//   SmvInt count, count x (classId hash, fingerprint), 8 bytes each, little-endian
+
+struct TypeFingerprint_t {
+    ClassIdHash_t classIdHash;
+    Fingerprint_t fingerprint;
+};
+
+static bool writeHandshake(IErrorHandler* err, IWriter* writer, const TypeFingerprint_t* types, size_t count) {
+    const uint64_t count64 = count;
+
+    if (!SmvIntSerializer<uint64_t>::serializeValue(err, writer, count64))
+        return false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!writeClassIdHash(err, writer, types[i].classIdHash) || !writeFingerprint(err, writer, types[i].fingerprint))
+            return false;
+    }
+
+    return true;
+}
+
+template <class... Classes>
+bool writeHandshake(IErrorHandler* err, IWriter* writer) {
+    const TypeFingerprint_t types[] = {
+        {Classes::reflection_s_classIdHash(REFL_MATCH), reflectFingerprint<Classes>()}...
+    };
+
+    return writeHandshake(err, writer, types, sizeof...(Classes));
+}
+
+// Reads the peer's handshake and compares it with the local types; classes only one side knows about
+// are ignored. incompatible_out[i] is set for each local type whose layout differs on the peer.
+static bool readHandshake(IErrorHandler* err, IReader* reader, const TypeFingerprint_t* local, size_t numLocal,
+        bool* incompatible_out, size_t& numIncompatible_out) {
+    uint64_t count;
+
+    if (!SmvIntSerializer<uint64_t>::deserializeValue(err, reader, count))
+        return false;
+
+    for (size_t i = 0; i < numLocal; i++)
+        incompatible_out[i] = false;
+
+    numIncompatible_out = 0;
+
+    for (uint64_t j = 0; j < count; j++) {
+        TypeFingerprint_t remote;
+
+        if (!readClassIdHash(err, reader, remote.classIdHash) || !readFingerprint(err, reader, remote.fingerprint))
+            return false;
+
+        for (size_t i = 0; i < numLocal; i++) {
+            if (local[i].classIdHash == remote.classIdHash) {
+                if (local[i].fingerprint != remote.fingerprint && !incompatible_out[i]) {
+                    incompatible_out[i] = true;
+                    numIncompatible_out++;
+                }
+
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+}
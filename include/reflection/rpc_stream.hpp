@@ -0,0 +1,498 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "rpc_async.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+// Server-streaming calls. The remote function takes a stream writer before its arguments and writes any
+// number of items to it:
+//
+//   void listUsers(rpc::RpcStreamWriter<User>& out, const UserQuery& query);
+//
+// Servers register it with RPC_STREAM_TABLE_ENTRY (see basic_rpc_dispatcher.hpp); clients consume the items
+// as they arrive, while the server is still producing them. The channel grants the server a window of
+// bytes and hands bytes back as items are consumed, so a slow consumer holds up the producer instead of
+// piling up items in memory.
+
+// localName_(channel, args...) starts functionName_ on an IStreamRpcChannel and returns an
+// RpcStreamReader to iterate over
+#define RPC_STREAM(localName_, functionName_)\
+namespace { char localName_##_rpcFunctionName_[] = #functionName_; }\
+RPC_CONSTEXPR auto localName_ = ::rpc::getRpcStreamCall<localName_##_rpcFunctionName_,\
+        ::rpc::rpcStreamMethodId(#functionName_, decltype(&functionName_)(nullptr))>(decltype(&functionName_)(nullptr));\
+
+// localName_(channel, onItem, onDone, args...) starts functionName_ and passes each item to onItem, on the
+// thread receiving the responses
+#define RPC_STREAM_CALLBACK(localName_, functionName_)\
+namespace { char localName_##_rpcFunctionName_[] = #functionName_; }\
+RPC_CONSTEXPR auto localName_ = ::rpc::getRpcStreamCallbackCall<localName_##_rpcFunctionName_,\
+        ::rpc::rpcStreamMethodId(#functionName_, decltype(&functionName_)(nullptr))>(decltype(&functionName_)(nullptr));\
+
+namespace rpc {
+    typedef uint32_t RpcStreamId_t;
+
+    // Server side of one stream, provided by the server transport
+    class IRpcStreamSink {
+    public:
+        virtual ~IRpcStreamSink() {}
+
+        // starts an item; false once the client has cancelled the stream or gone away
+        virtual bool beginItem(IWriter*& writer_out) = 0;
+
+        // sends the item, first waiting until the client has credit for it
+        virtual bool endItem() = 0;
+
+        // ends the stream with an error instead of a normal end once the function returns
+        virtual void fail() = 0;
+    };
+
+    template <typename Item>
+    class RpcStreamWriter {
+    public:
+        explicit RpcStreamWriter(IRpcStreamSink& sink) : sink(sink) {}
+
+        RpcStreamWriter(const RpcStreamWriter&) = delete;
+
+        // Blocks while the client is a full window behind. false: stop producing, the items would be dropped
+        bool write(const Item& item) {
+            IWriter* writer;
+
+            if (!sink.beginItem(writer))
+                return false;
+
+            if (!reflectSerialize(item, writer)) {
+                sink.fail();
+                return false;
+            }
+
+            return sink.endItem();
+        }
+
+        void fail() {
+            sink.fail();
+        }
+
+    private:
+        IRpcStreamSink& sink;
+    };
+
+    class IStreamRpcChannel;
+
+    // Receives the items of a streaming call, followed by complete() as for any other call; a stream that
+    // ended normally completes with an empty response.
+    class IRpcStreamCompletion : public IRpcCompletion {
+    public:
+        // called by submitStreamCall before the request goes out
+        virtual void attach(IStreamRpcChannel* channel, RpcStreamId_t stream, size_t window) = 0;
+
+        // An item that took size bytes of the window. Once it has been consumed, the completion gives the
+        // bytes back with grantCredit, or the stream stalls.
+        virtual void item(IErrorHandler* err, IReader* item, size_t size) = 0;
+    };
+
+    // Asynchronous channel that also carries streaming calls. A streaming call is written between
+    // beginAsyncCall and submitStreamCall (or cancelAsyncCall); the same rules apply as for
+    // submitAsyncCall. Items and the completion are delivered on the receiving thread, in order.
+    class IStreamRpcChannel : public IAsyncRpcChannel {
+    public:
+        virtual bool submitStreamCall(IRpcStreamCompletion* completion) = 0;
+
+        // lets the server send another `bytes` of items
+        virtual void grantCredit(RpcStreamId_t stream, size_t bytes) = 0;
+
+        // Asks the server to stop; items already on their way still arrive, then the completion.
+        virtual void cancelStream(RpcStreamId_t stream) = 0;
+    };
+
+    // name '(' argument tags ')' '*' item tag
+    template <typename Item, typename... Args>
+    constexpr RpcMethodId_t rpcStreamMethodId(const char* functionName, void (*)(RpcStreamWriter<Item>&, Args...)) {
+        return rpcFoldMethodId(RpcSignature_<Item>::mix(rpcSignatureMix(rpcSignatureMix(RpcSignature_<Args...>::mix(
+                rpcSignatureMix(hashClassId(functionName), '(')), ')'), '*')));
+    }
+
+    // credit goes back in chunks of a quarter window rather than per item
+    inline bool rpcStreamCreditDue(size_t unacknowledged, size_t window) {
+        return unacknowledged > 0 && unacknowledged >= window / 4;
+    }
+
+    template <typename Item>
+    class StreamState_ : public IRpcStreamCompletion {
+    public:
+        StreamState_() : channel(nullptr), stream(0), window(0), unacknowledged(0), refs(2), done(false),
+                succeeded(false), closed(false), corrupt(false) {}
+
+        virtual void attach(IStreamRpcChannel* channel, RpcStreamId_t stream, size_t window) override {
+            this->channel = channel;
+            this->stream = stream;
+            this->window = window;
+        }
+
+        virtual void item(IErrorHandler* err, IReader* item, size_t size) override {
+            Item value;
+            const bool decoded = reflectDeserialize(value, item);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (closed || corrupt)
+                    return;
+
+                if (decoded) {
+                    items.emplace_back(std::move(value), size);
+                    ready.notify_one();
+                    return;
+                }
+
+                corrupt = true;
+            }
+
+            channel->cancelStream(stream);
+        }
+
+        virtual void complete(IErrorHandler* err, IReader* response) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done = true;
+                succeeded = (response != nullptr && !corrupt);
+                ready.notify_all();
+            }
+
+            release();
+        }
+
+        bool next(Item& item_out) {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (items.empty() && !done) {
+                // nothing left to consume, so anything not acknowledged yet only holds up the server
+                if (unacknowledged > 0)
+                    grant(lock);
+                else
+                    ready.wait(lock);
+            }
+
+            if (items.empty())
+                return false;
+
+            item_out = std::move(items.front().first);
+            unacknowledged += items.front().second;
+            items.pop_front();
+
+            if (!done && rpcStreamCreditDue(unacknowledged, window))
+                grant(lock);
+
+            return true;
+        }
+
+        bool ok() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return done && succeeded;
+        }
+
+        // by the reader; cancels the stream if it is still running
+        void close() {
+            bool cancel;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancel = !done;
+                closed = true;
+                items.clear();
+            }
+
+            if (cancel)
+                channel->cancelStream(stream);
+
+            release();
+        }
+
+    private:
+        void grant(std::unique_lock<std::mutex>& lock) {
+            const size_t bytes = unacknowledged;
+            unacknowledged = 0;
+
+            lock.unlock();
+            channel->grantCredit(stream, bytes);
+            lock.lock();
+        }
+
+        // one reference for the reader, one for the channel until complete()
+        void release() {
+            if (--refs == 0)
+                delete this;
+        }
+
+        IStreamRpcChannel* channel;
+        RpcStreamId_t stream;
+        size_t window, unacknowledged;
+        std::atomic<int> refs;
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<std::pair<Item, size_t>> items;
+        bool done, succeeded, closed, corrupt;
+    };
+
+    // Client end of a stream started with an RPC_STREAM stub. Reads block until the next item arrives;
+    // at most a window of items is buffered. A reader must be closed or destroyed before its channel.
+    template <typename Item>
+    class RpcStreamReader {
+    public:
+        class Iterator {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef Item value_type;
+            typedef ptrdiff_t difference_type;
+            typedef Item* pointer;
+            typedef Item& reference;
+
+            Iterator() : reader(nullptr) {}
+
+            explicit Iterator(RpcStreamReader* reader) : reader(reader) {
+                ++*this;
+            }
+
+            Item& operator*() { return item; }
+            Item* operator->() { return &item; }
+
+            Iterator& operator++() {
+                if (!reader->next(item))
+                    reader = nullptr;
+
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const { return reader == other.reader; }
+            bool operator!=(const Iterator& other) const { return reader != other.reader; }
+
+        private:
+            RpcStreamReader* reader;
+            Item item;
+        };
+
+        explicit RpcStreamReader(StreamState_<Item>* state) : state(state) {}
+
+        RpcStreamReader(RpcStreamReader&& other) : state(other.state) {
+            other.state = nullptr;
+        }
+
+        ~RpcStreamReader() {
+            close();
+        }
+
+        RpcStreamReader(const RpcStreamReader&) = delete;
+
+        // false at the end of the stream, see ok()
+        bool next(Item& item_out) {
+            return state != nullptr && state->next(item_out);
+        }
+
+        // whether the stream has ended normally, rather than failed or been cut short
+        bool ok() {
+            return state != nullptr && state->ok();
+        }
+
+        // stops the stream if it is still running
+        void close() {
+            if (state != nullptr)
+                state->close();
+
+            state = nullptr;
+        }
+
+        // single pass: begin() resumes where reading left off
+        Iterator begin() { return Iterator(this); }
+        Iterator end() { return Iterator(); }
+
+    private:
+        StreamState_<Item>* state;
+    };
+
+    template <typename Item>
+    class CallbackStreamCompletion_ : public IRpcStreamCompletion {
+    public:
+        CallbackStreamCompletion_(std::function<bool(Item&& item)> onItem, std::function<void(bool ok)> onDone)
+                : onItem(onItem), onDone(onDone), channel(nullptr), stream(0), window(0), unacknowledged(0),
+                stopped(false) {}
+
+        virtual void attach(IStreamRpcChannel* channel, RpcStreamId_t stream, size_t window) override {
+            this->channel = channel;
+            this->stream = stream;
+            this->window = window;
+        }
+
+        virtual void item(IErrorHandler* err, IReader* item, size_t size) override {
+            if (stopped)
+                return;
+
+            Item value;
+
+            if (!reflectDeserialize(value, item) || !onItem(std::move(value))) {
+                stopped = true;
+                channel->cancelStream(stream);
+                return;
+            }
+
+            unacknowledged += size;
+
+            if (rpcStreamCreditDue(unacknowledged, window)) {
+                channel->grantCredit(stream, unacknowledged);
+                unacknowledged = 0;
+            }
+        }
+
+        virtual void complete(IErrorHandler* err, IReader* response) override {
+            onDone(response != nullptr && !stopped);
+            delete this;
+        }
+
+    private:
+        std::function<bool(Item&& item)> onItem;
+        std::function<void(bool ok)> onDone;
+
+        IStreamRpcChannel* channel;
+        RpcStreamId_t stream;
+        size_t window, unacknowledged;
+        bool stopped;
+    };
+
+    inline bool serializeRpcArguments_(IWriter* writer) {
+        return true;
+    }
+
+    template <typename Arg, typename... Args>
+    bool serializeRpcArguments_(IWriter* writer, const Arg& arg, const Args&... args) {
+        return reflectSerialize(arg, writer) && serializeRpcArguments_(writer, args...);
+    }
+
+    inline bool deserializeRpcArguments_(IReader* reader) {
+        return true;
+    }
+
+    template <typename Arg, typename... Args>
+    bool deserializeRpcArguments_(IReader* reader, Arg& arg, Args&... args) {
+        return reflectDeserialize(arg, reader) && deserializeRpcArguments_(reader, args...);
+    }
+
+    template <size_t... Indices>
+    struct RpcIndices_ {};
+
+    template <size_t count, size_t... Indices>
+    struct MakeRpcIndices_ : MakeRpcIndices_<count - 1, count - 1, Indices...> {};
+
+    template <size_t... Indices>
+    struct MakeRpcIndices_<0, Indices...> {
+        typedef RpcIndices_<Indices...> type;
+    };
+
+    template <const char* functionName, RpcMethodId_t methodId, typename... Args>
+    bool rpcStreamSubmit(IStreamRpcChannel& channel, IRpcStreamCompletion* completion, Args const&... args) {
+        IWriter* writer;
+
+        if (!channel.beginAsyncCall(functionName, methodId, false, writer))
+            return false;
+
+        if (!serializeRpcArguments_(writer, args...)) {
+            channel.cancelAsyncCall();
+            return false;
+        }
+
+        return channel.submitStreamCall(completion);
+    }
+
+    template <const char* functionName, RpcMethodId_t methodId, typename Item, typename... Args>
+    RpcStreamReader<Item> rpcStreamCall(IStreamRpcChannel& channel, Args const&... args) {
+        auto state = new StreamState_<Item>();
+
+        if (!rpcStreamSubmit<functionName, methodId, Args...>(channel, state, args...))
+            state->complete(err, nullptr);
+
+        return RpcStreamReader<Item>(state);
+    }
+
+    // onItem returns false to cancel the stream; onDone(ok) follows the last item
+    template <const char* functionName, RpcMethodId_t methodId, typename Item, typename... Args>
+    void rpcStreamCallbackCall(IStreamRpcChannel& channel, std::function<bool(Item&& item)> onItem,
+            std::function<void(bool ok)> onDone, Args const&... args) {
+        auto completion = new CallbackStreamCompletion_<Item>(onItem, onDone);
+
+        if (!rpcStreamSubmit<functionName, methodId, Args...>(channel, completion, args...))
+            completion->complete(err, nullptr);
+    }
+
+    template <typename Item, typename... Args>
+    struct MakeStreamFunctionPointer_ {
+        typedef RpcStreamReader<Item> (*type)(IStreamRpcChannel&, Args const&...);
+        typedef void (*callbackType)(IStreamRpcChannel&, std::function<bool(Item&& item)>, std::function<void(bool ok)>,
+                Args const&...);
+    };
+
+    template <const char* functionName, RpcMethodId_t methodId, typename Item, typename... Args>
+    RPC_CONSTEXPR_FUNC typename MakeStreamFunctionPointer_<Item, Args...>::type getRpcStreamCall(
+            void (*functionNull)(RpcStreamWriter<Item>&, Args...)) {
+        return &rpcStreamCall<functionName, methodId, Item, Args...>;
+    }
+
+    template <const char* functionName, RpcMethodId_t methodId, typename Item, typename... Args>
+    RPC_CONSTEXPR_FUNC typename MakeStreamFunctionPointer_<Item, Args...>::callbackType getRpcStreamCallbackCall(
+            void (*functionNull)(RpcStreamWriter<Item>&, Args...)) {
+        return &rpcStreamCallbackCall<functionName, methodId, Item, Args...>;
+    }
+
+    template <typename Function, Function function, typename Item, typename Arguments, size_t... Indices>
+    bool rpcStreamInvoke_(IReader* reader, IRpcStreamSink& sink, Arguments& arguments, RpcIndices_<Indices...>) {
+        if (!deserializeRpcArguments_(reader, std::get<Indices>(arguments)...))
+            return false;
+
+        RpcStreamWriter<Item> writer(sink);
+        function(writer, std::get<Indices>(arguments)...);
+        return true;
+    }
+
+    // Server side: reads the arguments and runs the function, which writes its items to sink
+    template <typename Function, Function function, typename Item, typename... Args>
+    bool rpcStreamExecute(IErrorHandler* err, IReader* reader, IRpcStreamSink& sink) {
+        std::tuple<typename std::remove_cv<typename std::remove_reference<Args>::type>::type...> arguments;
+
+        return rpcStreamInvoke_<Function, function, Item>(reader, sink, arguments,
+                typename MakeRpcIndices_<sizeof...(Args)>::type());
+    }
+
+    template <typename Function, Function function, typename Item, typename... Args>
+    RPC_CONSTEXPR_FUNC bool (*getRpcStreamExecute(void (*functionNull)(RpcStreamWriter<Item>&, Args...)))(
+            IErrorHandler* err, IReader* reader, IRpcStreamSink& sink) {
+        return &rpcStreamExecute<Function, function, Item, Args...>;
+    }
+}
@@ -0,0 +1,367 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "api.hpp"
+#include "class_registry.hpp"
+#include "serializer.hpp"
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+using namespace serialization;
+
+class ISchemaProvider {
+public:
+    virtual IReader* openClassSchemaOrNull(const char* className) = 0;
+    virtual void closeClassSchema(IReader* reader) = 0;
+};
+
+struct ClassSchema_t;
+
+// one field of a parsed class schema
+struct SchemaField_t {
+    const char* className;      // class declaring the field
+    const char* name;
+    Tag_t tag;
+    const char* classId;        // TAG_CLASS/TAG_CLASS_HASH fields: the field's class, otherwise nullptr
+    mutable ClassSchema_t const* schema;    // schema for classId, filled in by SchemaCache::nested
+};
+
+// parsed contents of a .class_schema, held in a single allocation (release with free())
+struct ClassSchema_t {
+    const char* classId;
+    SchemaField_t const* fields;
+    size_t numFields;
+    mutable Fingerprint_t fingerprint;      // 0 until computed by SchemaCache::fingerprint
+};
+
+// reads the class reference following a TAG_CLASS or TAG_CLASS_HASH schema entry
+static bool readSchemaClassId(Tag_t tag, IReader* reader, BufString_t& classId_out) {
+    if (tag == TAG_CLASS)
+        return Serializer<BufString_t>::deserialize(err, reader, classId_out);
+
+    ClassIdHash_t hash;
+
+    if (!readClassIdHash(err, reader, hash))
+        return false;
+
+    const char* classId = classIdForHashOrNull(hash);
+
+    if (classId != nullptr)
+        return bufStringSet(err, classId_out.buf, classId_out.bufSize, classId, strlen(classId));
+
+    // class not compiled into this program; let the schema provider resolve it by hash
+    return bufStringPrintf(err, classId_out.buf, classId_out.bufSize, "#%016llx", (unsigned long long) hash);
+}
+
+// appends a length-prefixed string to the pool with a single read; returns its offset
+static bool readSchemaString(IReader* reader, char*& pool, size_t& poolSize, size_t& poolUsed, size_t& offset_out) {
+    uint64_t length;
+
+    if (!SmvIntSerializer<uint64_t>::deserializeValue(err, reader, length))
+        return false;
+
+    if (length > SIZE_MAX / 2)
+        return err->error("LengthOverflow", "String length is too large."), false;
+
+    if (!ensureSize(err, pool, poolSize, poolUsed + (size_t) length + 1))
+        return false;
+
+    if (length > 0 && !reader->read(err, pool + poolUsed, (size_t) length))
+        return false;
+
+    offset_out = poolUsed;
+    pool[poolUsed + length] = 0;
+    poolUsed += (size_t) length + 1;
+    return true;
+}
+
+// Parses a class schema body (everything after TAG_CLASS_SCHEMA). Returns nullptr on failure.
+static ClassSchema_t* readClassSchema(IReader* reader, const char* classId) {
+    struct Offsets_t {
+        size_t className, name, classId;
+        Tag_t tag;
+    };
+
+    uint32_t numFields;
+
+    if (!Serializer<uint32_t>::deserialize(err, reader, numFields))
+        return nullptr;
+
+    char* pool = nullptr;
+    size_t poolSize = 0, poolUsed = 0;
+    AllocGuard poolGuard(pool);
+
+    Offsets_t* offsets = nullptr;
+    size_t offsetsSize = 0;
+    AllocGuard offsetsGuard(offsets);
+
+    BufString_t fieldClassId;
+
+    for (uint32_t i = 0; i < numFields; i++) {
+        // grow as we go rather than trusting numFields up front
+        if (!ensureSize(err, (char*&) offsets, offsetsSize, (i + 1) * sizeof(Offsets_t)))
+            return nullptr;
+
+        Offsets_t& field = offsets[i];
+
+        if (!readSchemaString(reader, pool, poolSize, poolUsed, field.className)
+                || !readSchemaString(reader, pool, poolSize, poolUsed, field.name)
+                || !reader->read(err, &field.tag, sizeof(field.tag)))
+            return nullptr;
+
+        field.classId = SIZE_MAX;
+
+        if (field.tag == TAG_CLASS || field.tag == TAG_CLASS_HASH) {
+            if (!readSchemaClassId(field.tag, reader, fieldClassId))
+                return nullptr;
+
+            field.classId = poolUsed;
+
+            const size_t length = strlen(fieldClassId.buf);
+
+            if (!ensureSize(err, pool, poolSize, poolUsed + length + 1))
+                return nullptr;
+
+            memcpy(pool + poolUsed, fieldClassId.buf, length + 1);
+            poolUsed += length + 1;
+        }
+    }
+
+    const size_t classIdLength = strlen(classId);
+    const size_t blockSize = sizeof(ClassSchema_t) + numFields * sizeof(SchemaField_t) + poolUsed + classIdLength + 1;
+    ClassSchema_t* schema = (ClassSchema_t*) malloc(blockSize);
+
+    if (schema == nullptr)
+        return err->allocationError("reflection::readClassSchema"), nullptr;
+
+    SchemaField_t* fields = reinterpret_cast<SchemaField_t*>(schema + 1);
+    char* strings = reinterpret_cast<char*>(fields + numFields);
+
+    if (poolUsed > 0)
+        memcpy(strings, pool, poolUsed);
+
+    memcpy(strings + poolUsed, classId, classIdLength + 1);
+
+    for (uint32_t i = 0; i < numFields; i++) {
+        fields[i].className = strings + offsets[i].className;
+        fields[i].name = strings + offsets[i].name;
+        fields[i].tag = offsets[i].tag;
+        fields[i].classId = (offsets[i].classId != SIZE_MAX) ? strings + offsets[i].classId : nullptr;
+        fields[i].schema = nullptr;
+    }
+
+    schema->classId = strings + poolUsed;
+    schema->fields = fields;
+    schema->numFields = numFields;
+    schema->fingerprint = 0;
+    return schema;
+}
+
+// opens, parses and closes the schema for classId; nullptr if the provider doesn't have it or it's malformed
+static ClassSchema_t* loadClassSchema(ISchemaProvider* sp, const char* classId) {
+    IReader* reader = sp->openClassSchemaOrNull(classId);
+
+    if (reader == nullptr)
+        return nullptr;
+
+    // schema files hold the bare body, as written by InstanceSerializer::serializeSchema
+    ClassSchema_t* schema = readClassSchema(reader, classId);
+    sp->closeClassSchema(reader);
+    return schema;
+}
+
+// Parses each class schema once and keeps it in memory, so that consumers pay for a provider
+// round-trip only on the first use of a class. Unavailable schemas are remembered as well.
+class SchemaCache {
+public:
+    SchemaCache(ISchemaProvider* sp) : sp(sp), entries(nullptr), capacity(0), count(0) {}
+
+    ~SchemaCache() { clear(); }
+
+    SchemaCache(const SchemaCache& other) = delete;
+    SchemaCache& operator =(const SchemaCache& other) = delete;
+
+    // nullptr if the provider doesn't have it
+    const ClassSchema_t* get(const char* classId) {
+        const ClassIdHash_t hash = hashClassId(classId);
+        Entry_t* entry = find(classId, hash);
+
+        if (entry != nullptr)
+            return entry->schema;
+
+        ClassSchema_t* schema = (sp != nullptr) ? loadClassSchema(sp, classId) : nullptr;
+
+        if (!insert(classId, hash, schema)) {
+            free(schema);
+            return nullptr;
+        }
+
+        return schema;
+    }
+
+    // schema of a class-typed field; resolved through get() once, then read straight off the field
+    const ClassSchema_t* nested(const SchemaField_t& field) {
+        if (field.schema == nullptr && field.classId != nullptr)
+            field.schema = get(field.classId);
+
+        return field.schema;
+    }
+
+    // layout fingerprint of a schema, comparable with reflectFingerprint<C>(); needs the schemas of nested classes
+    bool fingerprint(const ClassSchema_t* schema, Fingerprint_t& fingerprint_out) {
+        if (schema->fingerprint == 0) {
+            Fingerprint_t hash = fingerprintClassBegin(schema->numFields);
+
+            for (size_t i = 0; i < schema->numFields; i++) {
+                const SchemaField_t& field = schema->fields[i];
+                Fingerprint_t fieldFingerprint;
+
+                if (field.classId != nullptr) {
+                    const ClassSchema_t* fieldSchema = nested(field);
+
+                    if (fieldSchema == nullptr)
+                        return err->errorf("SchemaUnavailable", "Schema for class `%s` is not available.",
+                                field.classId), false;
+
+                    if (!fingerprint(fieldSchema, fieldFingerprint))
+                        return false;
+                }
+                else
+                    fieldFingerprint = fingerprintOfTag(field.tag);
+
+                hash = fingerprintClassField(hash, field.name, fieldFingerprint);
+            }
+
+            schema->fingerprint = fingerprintClassEnd(hash);
+        }
+
+        fingerprint_out = schema->fingerprint;
+        return true;
+    }
+
+    // true if get(classId) won't have to go to the provider
+    bool isCached(const char* classId) {
+        return find(classId, hashClassId(classId)) != nullptr;
+    }
+
+    // takes ownership of an already parsed schema (e.g. from a bundle); false if the class is already known
+    bool add(ClassSchema_t* schema) {
+        const ClassIdHash_t hash = hashClassId(schema->classId);
+
+        if (find(schema->classId, hash) != nullptr)
+            return false;
+
+        return insert(schema->classId, hash, schema);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < capacity; i++) {
+            if (entries[i].classId != nullptr) {
+                free(entries[i].classId);
+                free(entries[i].schema);
+            }
+        }
+
+        free(entries);
+        entries = nullptr;
+        capacity = 0;
+        count = 0;
+    }
+
+private:
+    struct Entry_t {
+        ClassIdHash_t hash;
+        char* classId;              // nullptr: empty slot
+        ClassSchema_t* schema;      // nullptr: not available
+    };
+
+    Entry_t* find(const char* classId, ClassIdHash_t hash) {
+        if (capacity == 0)
+            return nullptr;
+
+        for (size_t i = (size_t) hash & (capacity - 1); entries[i].classId != nullptr; i = (i + 1) & (capacity - 1)) {
+            if (entries[i].hash == hash && strcmp(entries[i].classId, classId) == 0)
+                return &entries[i];
+        }
+
+        return nullptr;
+    }
+
+    bool insert(const char* classId, ClassIdHash_t hash, ClassSchema_t* schema) {
+        // keep the load factor under 3/4
+        if ((count + 1) * 4 > capacity * 3 && !grow())
+            return false;
+
+        const size_t length = strlen(classId);
+        char* classIdCopy = (char*) malloc(length + 1);
+
+        if (classIdCopy == nullptr)
+            return err->allocationError("reflection::SchemaCache::insert"), false;
+
+        memcpy(classIdCopy, classId, length + 1);
+
+        size_t i = (size_t) hash & (capacity - 1);
+
+        while (entries[i].classId != nullptr)
+            i = (i + 1) & (capacity - 1);
+
+        entries[i] = Entry_t { hash, classIdCopy, schema };
+        count++;
+        return true;
+    }
+
+    bool grow() {
+        const size_t newCapacity = (capacity == 0) ? 16 : capacity * 2;
+        Entry_t* newEntries = (Entry_t*) calloc(newCapacity, sizeof(Entry_t));
+
+        if (newEntries == nullptr)
+            return err->allocationError("reflection::SchemaCache::grow"), false;
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (entries[i].classId == nullptr)
+                continue;
+
+            size_t j = (size_t) entries[i].hash & (newCapacity - 1);
+
+            while (newEntries[j].classId != nullptr)
+                j = (j + 1) & (newCapacity - 1);
+
+            newEntries[j] = entries[i];
+        }
+
+        free(entries);
+        entries = newEntries;
+        capacity = newCapacity;
+        return true;
+    }
+
+    ISchemaProvider* sp;
+
+    Entry_t* entries;
+    size_t capacity, count;
+};
+}
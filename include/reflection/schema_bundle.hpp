@@ -0,0 +1,494 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "schema.hpp"
+
+#include <utility/mapped_file.hpp>
+#include <utility/span_reader.hpp>
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+// A schema bundle holds the schemas of many classes in one file that can be mapped and queried in place.
+// Layout (native byte order):
+//
+//   SchemaBundleHeader_t
+//   SchemaBundleSlot_t[indexCapacity]      open addressing on hashClassId, linear probing, load <= 1/2
+//   entries                                classId '\0' followed by the schema body, as in a .class_schema
+//
+// All offsets are from the start of the bundle.
+
+static const char SCHEMA_BUNDLE_MAGIC[8] = {'R', 'F', 'L', 'S', 'C', 'H', 'B', '\0'};
+enum { SCHEMA_BUNDLE_VERSION = 1 };
+
+struct SchemaBundleHeader_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t numClasses;
+    uint32_t indexCapacity;                 // power of two
+    uint32_t reserved;
+    uint64_t bundleSize;
+};
+
+struct SchemaBundleSlot_t {
+    ClassIdHash_t hash;
+    uint32_t classIdOffset;                 // 0: empty slot
+    uint32_t classIdLength;
+    uint32_t schemaOffset;
+    uint32_t schemaSize;
+};
+
+// Collects class schemas and writes them out as a bundle.
+class SchemaBundleBuilder {
+public:
+    SchemaBundleBuilder() : records(nullptr), recordsSize(0), numRecords(0), lookup(nullptr), lookupCapacity(0),
+            blobs(nullptr), blobsSize(0), blobsUsed(0) {}
+
+    ~SchemaBundleBuilder() {
+        free(records);
+        free(lookup);
+        free(blobs);
+    }
+
+    SchemaBundleBuilder(const SchemaBundleBuilder& other) = delete;
+    SchemaBundleBuilder& operator =(const SchemaBundleBuilder& other) = delete;
+
+    // adds a serialized schema body; classes may only be added once
+    bool add(const char* classId, const void* schema, size_t schemaSize) {
+        if (!beginRecord(classId))
+            return false;
+
+        BlobWriter_t writer(this);
+
+        if (!writer.write(err, schema, schemaSize))
+            return false;
+
+        return endRecord();
+    }
+
+    // adds a class through the schema writer it was registered with
+    bool addClass(const char* classId, ClassSchemaWriter_t writeSchema) {
+        if (!beginRecord(classId))
+            return false;
+
+        BlobWriter_t writer(this);
+
+        if (!writeSchema(err, &writer))
+            return false;
+
+        return endRecord();
+    }
+
+    // adds every class registered so far (see registerClass); a class is registered once its reflection is used
+    bool addRegisteredClasses() {
+        // writing a schema registers the classes of its fields, so repeat until a pass adds nothing
+        for (;;) {
+            bool added = false;
+
+            for (const ClassIdEntry_t& entry : registeredClassIds()) {
+                if (entry.writeSchema == nullptr || contains(entry.classId))
+                    continue;
+
+                if (!addClass(entry.classId, entry.writeSchema))
+                    return false;
+
+                added = true;
+            }
+
+            if (!added)
+                return true;
+        }
+    }
+
+    bool contains(const char* classId) const {
+        if (lookupCapacity == 0)
+            return false;
+
+        const ClassIdHash_t hash = hashClassId(classId);
+
+        size_t slot = (size_t) hash & (lookupCapacity - 1);
+
+        while (lookup[slot] != 0) {
+            const Record_t& record = records[lookup[slot] - 1];
+
+            if (record.hash == hash && strcmp(blobs + record.classIdOffset, classId) == 0)
+                return true;
+
+            slot = (slot + 1) & (lookupCapacity - 1);
+        }
+
+        return false;
+    }
+
+    size_t numClasses() const { return numRecords; }
+
+    bool write(IWriter* writer) const {
+        size_t capacity = 8;
+
+        while (capacity < numRecords * 2)
+            capacity *= 2;
+
+        const size_t indexSize = capacity * sizeof(SchemaBundleSlot_t);
+        const size_t entriesOffset = sizeof(SchemaBundleHeader_t) + indexSize;
+
+        if (entriesOffset + blobsUsed > UINT32_MAX)
+            return err->error("SchemaBundleTooLarge", "Schema bundles are limited to 4 GiB."), false;
+
+        SchemaBundleHeader_t header;
+        memcpy(header.magic, SCHEMA_BUNDLE_MAGIC, sizeof(header.magic));
+        header.version = SCHEMA_BUNDLE_VERSION;
+        header.numClasses = (uint32_t) numRecords;
+        header.indexCapacity = (uint32_t) capacity;
+        header.reserved = 0;
+        header.bundleSize = entriesOffset + blobsUsed;
+
+        SchemaBundleSlot_t* index = (SchemaBundleSlot_t*) calloc(capacity, sizeof(SchemaBundleSlot_t));
+
+        if (index == nullptr)
+            return err->allocationError("reflection::SchemaBundleBuilder::write"), false;
+
+        AllocGuard indexGuard(index);
+
+        for (size_t i = 0; i < numRecords; i++) {
+            const Record_t& record = records[i];
+            size_t slot = (size_t) record.hash & (capacity - 1);
+
+            while (index[slot].classIdOffset != 0)
+                slot = (slot + 1) & (capacity - 1);
+
+            index[slot].hash = record.hash;
+            index[slot].classIdOffset = (uint32_t) (entriesOffset + record.classIdOffset);
+            index[slot].classIdLength = (uint32_t) record.classIdLength;
+            index[slot].schemaOffset = (uint32_t) (entriesOffset + record.schemaOffset);
+            index[slot].schemaSize = (uint32_t) record.schemaSize;
+        }
+
+        return writer->write(err, &header, sizeof(header))
+                && writer->write(err, index, indexSize)
+                && (blobsUsed == 0 || writer->write(err, blobs, blobsUsed));
+    }
+
+private:
+    struct Record_t {
+        ClassIdHash_t hash;
+        size_t classIdOffset, classIdLength;
+        size_t schemaOffset, schemaSize;
+    };
+
+    // appends to the blob area of the builder
+    class BlobWriter_t : public IWriter {
+    public:
+        BlobWriter_t(SchemaBundleBuilder* builder) : builder(builder) {}
+
+        virtual bool write(IErrorHandler* err, const void* buffer, size_t count) override {
+            if (!ensureSize(err, builder->blobs, builder->blobsSize, builder->blobsUsed + count))
+                return false;
+
+            if (count > 0)
+                memcpy(builder->blobs + builder->blobsUsed, buffer, count);
+
+            builder->blobsUsed += count;
+            return true;
+        }
+
+    private:
+        SchemaBundleBuilder* builder;
+    };
+
+    bool beginRecord(const char* classId) {
+        if (contains(classId))
+            return err->errorf("DuplicateClassId", "Class `%s` is already in the schema bundle.", classId), false;
+
+        if (!ensureSize(err, (char*&) records, recordsSize, (numRecords + 1) * sizeof(Record_t))
+                || !reserveLookup(numRecords + 1))
+            return false;
+
+        const size_t length = strlen(classId);
+        BlobWriter_t writer(this);
+
+        Record_t& record = records[numRecords];
+        record.hash = hashClassId(classId);
+        record.classIdOffset = blobsUsed;
+        record.classIdLength = length;
+
+        if (!writer.write(err, classId, length + 1))
+            return false;
+
+        record.schemaOffset = blobsUsed;
+        return true;
+    }
+
+    bool endRecord() {
+        Record_t& record = records[numRecords];
+        record.schemaSize = blobsUsed - record.schemaOffset;
+        numRecords++;
+        insertLookup(numRecords - 1);
+        return true;
+    }
+
+    // keeps the lookup at most half full for numEntries records
+    bool reserveLookup(size_t numEntries) {
+        if (numEntries * 2 <= lookupCapacity)
+            return true;
+
+        size_t newCapacity = (lookupCapacity > 0) ? lookupCapacity * 2 : 64;
+        size_t* newLookup = (size_t*) calloc(newCapacity, sizeof(size_t));
+
+        if (newLookup == nullptr)
+            return err->allocationError("reflection::SchemaBundleBuilder::reserveLookup"), false;
+
+        free(lookup);
+        lookup = newLookup;
+        lookupCapacity = newCapacity;
+
+        for (size_t i = 0; i < numRecords; i++)
+            insertLookup(i);
+
+        return true;
+    }
+
+    void insertLookup(size_t recordIndex) {
+        size_t slot = (size_t) records[recordIndex].hash & (lookupCapacity - 1);
+
+        while (lookup[slot] != 0)
+            slot = (slot + 1) & (lookupCapacity - 1);
+
+        lookup[slot] = recordIndex + 1;
+    }
+
+    Record_t* records;
+    size_t recordsSize, numRecords;
+
+    size_t* lookup;                 // open addressing on the class id hash: record index + 1, 0 if empty
+    size_t lookupCapacity;
+
+    char* blobs;
+    size_t blobsSize, blobsUsed;
+};
+
+// writes the schemas of all registered classes as a bundle
+inline bool writeSchemaBundle(IWriter* writer) {
+    SchemaBundleBuilder builder;
+    return builder.addRegisteredClasses() && builder.write(writer);
+}
+
+// Read-only view of a schema bundle, either mapped from a file or over caller-owned memory.
+// Lookups hash the class id once and probe the index in place; nothing is parsed until asked for.
+class SchemaBundle : public ISchemaProvider {
+public:
+    SchemaBundle() : data(nullptr), size(0), indexCapacity(0), classCount(0) {}
+
+    SchemaBundle(const SchemaBundle& other) = delete;
+    SchemaBundle& operator =(const SchemaBundle& other) = delete;
+
+    bool open(const char* path) {
+        close();
+
+        if (!file.open(err, path))
+            return false;
+
+        if (!openMemory(file.data, file.size)) {
+            file.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    // the memory must stay valid until close()
+    bool openMemory(const void* bundle, size_t bundleSize) {
+        data = nullptr;
+        size = 0;
+
+        SchemaBundleHeader_t header;
+
+        if (bundleSize < sizeof(header))
+            return err->error("SchemaBundleFormatError", "Schema bundle is truncated."), false;
+
+        memcpy(&header, bundle, sizeof(header));
+
+        if (memcmp(header.magic, SCHEMA_BUNDLE_MAGIC, sizeof(header.magic)) != 0)
+            return err->error("SchemaBundleFormatError", "Not a schema bundle."), false;
+
+        if (header.version != SCHEMA_BUNDLE_VERSION)
+            return err->errorf("SchemaBundleFormatError", "Unsupported schema bundle version %u.", header.version), false;
+
+        if (header.indexCapacity == 0 || (header.indexCapacity & (header.indexCapacity - 1)) != 0
+                || header.numClasses >= header.indexCapacity
+                || header.bundleSize != bundleSize
+                || sizeof(header) + (uint64_t) header.indexCapacity * sizeof(SchemaBundleSlot_t) > bundleSize)
+            return err->error("SchemaBundleFormatError", "Schema bundle header is corrupted."), false;
+
+        const uint8_t* bytes = (const uint8_t*) bundle;
+        uint32_t numUsed = 0;
+
+        // validate the index once so that lookups can trust it
+        for (uint32_t i = 0; i < header.indexCapacity; i++) {
+            SchemaBundleSlot_t slot;
+            memcpy(&slot, bytes + sizeof(header) + i * sizeof(SchemaBundleSlot_t), sizeof(slot));
+
+            if (slot.classIdOffset == 0)
+                continue;
+
+            if ((uint64_t) slot.classIdOffset + slot.classIdLength >= bundleSize
+                    || bytes[slot.classIdOffset + slot.classIdLength] != 0
+                    || (uint64_t) slot.schemaOffset + slot.schemaSize > bundleSize)
+                return err->error("SchemaBundleFormatError", "Schema bundle index is corrupted."), false;
+
+            numUsed++;
+        }
+
+        // at least one empty slot terminates every probe
+        if (numUsed != header.numClasses)
+            return err->error("SchemaBundleFormatError", "Schema bundle index is corrupted."), false;
+
+        data = bytes;
+        size = bundleSize;
+        indexCapacity = header.indexCapacity;
+        classCount = header.numClasses;
+        return true;
+    }
+
+    void close() {
+        file.close();
+        data = nullptr;
+        size = 0;
+        indexCapacity = 0;
+        classCount = 0;
+    }
+
+    size_t numClasses() const { return classCount; }
+
+    // finds the serialized schema body of a class
+    bool find(const char* classId, const uint8_t*& schema_out, size_t& size_out) const {
+        const ClassIdHash_t hash = hashClassId(classId);
+        SchemaBundleSlot_t slot;
+
+        if (indexCapacity == 0)
+            return false;
+
+        for (size_t i = (size_t) hash & (indexCapacity - 1); readSlot(i, slot); i = (i + 1) & (indexCapacity - 1)) {
+            if (slot.hash == hash && strcmp((const char*) data + slot.classIdOffset, classId) == 0)
+                return schema_out = data + slot.schemaOffset, size_out = slot.schemaSize, true;
+        }
+
+        return false;
+    }
+
+    // finds a class by its hash alone (as stored for TAG_CLASS_HASH fields); classId_out points into the bundle
+    bool findByHash(ClassIdHash_t hash, const char*& classId_out, const uint8_t*& schema_out, size_t& size_out) const {
+        SchemaBundleSlot_t slot;
+
+        if (indexCapacity == 0)
+            return false;
+
+        for (size_t i = (size_t) hash & (indexCapacity - 1); readSlot(i, slot); i = (i + 1) & (indexCapacity - 1)) {
+            if (slot.hash == hash) {
+                classId_out = (const char*) data + slot.classIdOffset;
+                schema_out = data + slot.schemaOffset;
+                size_out = slot.schemaSize;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // parses the schema of one class (release with free()); nullptr if missing or malformed
+    ClassSchema_t* parse(const char* classId) const {
+        const uint8_t* schema;
+        size_t schemaSize;
+
+        if (!find(classId, schema, schemaSize))
+            return nullptr;
+
+        utility::SpanReader reader(schema, schemaSize);
+        return readClassSchema(&reader, classId);
+    }
+
+    // parses every class into the cache up front; classes the cache already knows are skipped
+    bool preload(SchemaCache& cache) const {
+        SchemaBundleSlot_t slot;
+
+        for (size_t i = 0; i < indexCapacity; i++) {
+            if (!readSlot(i, slot))
+                continue;
+
+            const char* classId = (const char*) data + slot.classIdOffset;
+
+            if (cache.isCached(classId))
+                continue;
+
+            utility::SpanReader reader(data + slot.schemaOffset, slot.schemaSize);
+            ClassSchema_t* schema = readClassSchema(&reader, classId);
+
+            if (schema == nullptr)
+                return false;
+
+            if (!cache.add(schema)) {
+                free(schema);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    virtual IReader* openClassSchemaOrNull(const char* classId) override {
+        const uint8_t* schema;
+        size_t schemaSize;
+
+        if (classId[0] == '#') {
+            // unresolved TAG_CLASS_HASH reference, see readSchemaClassId
+            const char* resolved;
+
+            if (!findByHash((ClassIdHash_t) strtoull(classId + 1, nullptr, 16), resolved, schema, schemaSize))
+                return nullptr;
+        }
+        else if (!find(classId, schema, schemaSize))
+            return nullptr;
+
+        return new utility::SpanReader(schema, schemaSize);
+    }
+
+    virtual void closeClassSchema(IReader* reader) override {
+        delete static_cast<utility::SpanReader*>(reader);
+    }
+
+private:
+    // false for an empty slot
+    bool readSlot(size_t i, SchemaBundleSlot_t& slot_out) const {
+        memcpy(&slot_out, data + sizeof(SchemaBundleHeader_t) + i * sizeof(SchemaBundleSlot_t), sizeof(slot_out));
+        return slot_out.classIdOffset != 0;
+    }
+
+    utility::MappedFile file;
+
+    const uint8_t* data;
+    size_t size;
+    size_t indexCapacity, classCount;
+};
+}
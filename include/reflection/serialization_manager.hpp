@@ -116,6 +116,14 @@ public:
         return rc != 0;
     }
 
+    static bool serializeFixed(IErrorHandler* err, IWriter* writer, T const& value) {
+        return FixedWidthSerializer<T>::serialize(err, writer, value);
+    }
+
+    static bool deserializeFixed(IErrorHandler* err, IReader* reader, T& value_out) {
+        return FixedWidthSerializer<T>::deserialize(err, reader, value_out);
+    }
+
     static bool serializeTypeInformation(IErrorHandler* err, IWriter* writer, T const& value) {
         return writeTag(err, writer, Serializer<T>::TAG);
     }
@@ -160,18 +168,61 @@ public:
         return rc != 0;
     }
 
+    // with REFLECTOR_COMPACT_CLASS_IDS, classes are identified by their 64-bit classId hash instead of the full string
     static bool serializeInstanceTypeInformation(IErrorHandler* err, IWriter* writer) {
+#ifdef REFLECTOR_COMPACT_CLASS_IDS
+        return writeTag(err, writer, TAG_CLASS_HASH) && writeClassIdHash(err, writer,
+                T::reflection_s_classIdHash(REFL_MATCH));
+#else
         return writeTag(err, writer, TAG_CLASS) && Serializer<BufString_t>::serialize(err, writer,
                 T::reflection_s_classId(REFL_MATCH));
+#endif
     }
 
     static bool serializeInstanceTypeInformation(IErrorHandler* err, IWriter* writer, T const& value) {
+#ifdef REFLECTOR_COMPACT_CLASS_IDS
+        return writeTag(err, writer, TAG_CLASS_HASH) && writeClassIdHash(err, writer,
+                value.reflection_classIdHash(REFL_MATCH));
+#else
         return writeTag(err, writer, TAG_CLASS) && Serializer<BufString_t>::serialize(err, writer,
                 value.reflection_classId(REFL_MATCH));
+#endif
     }
 
+    // accepts both encodings regardless of REFLECTOR_COMPACT_CLASS_IDS
     static bool verifyInstanceTypeInformation(IErrorHandler* err, IReader* reader, T& value_out) {
-        return checkTag(err, reader, TAG_CLASS);
+        Tag_t tag;
+
+        if (!reader->read(err, &tag, sizeof(tag)))
+            return false;
+
+        if (tag == TAG_CLASS_HASH) {
+            reflection::ClassIdHash_t hash;
+
+            if (!readClassIdHash(err, reader, hash))
+                return false;
+
+            if (hash != value_out.reflection_classIdHash(REFL_MATCH))
+                return err->errorf("IncorrectClass", "Unexpected class id hash %016llx, expected `%s`.",
+                        (unsigned long long) hash, value_out.reflection_classId(REFL_MATCH)), false;
+
+            return true;
+        }
+        else if (tag == TAG_CLASS) {
+            BufString_t classId;
+
+            if (!Serializer<BufString_t>::deserialize(err, reader, classId))
+                return false;
+
+            if (strcmp(classId.buf, value_out.reflection_classId(REFL_MATCH)) != 0)
+                return err->errorf("IncorrectClass", "Unexpected class `%s`, expected `%s`.",
+                        classId.buf, value_out.reflection_classId(REFL_MATCH)), false;
+
+            return true;
+        }
+        else
+            return err->errorf("IncorrectType", "Unexpected tag 0x%02X, expected 0x%02X or 0x%02X.",
+                    tag, TAG_CLASS, TAG_CLASS_HASH), false;
     }
 };
 }
@@ -30,6 +30,8 @@
 #include "base.hpp"
 #include "bufstring.hpp"
 
+#include <type_traits>
+
 #ifndef REFLECTOR_AVOID_STL
 #include <string>
 #include <vector>
@@ -55,6 +57,7 @@ enum {
     // complex types
     TAG_CLASS           = 0x0C,
     TAG_CLASS_SCHEMA    = 0x0D,
+    TAG_CLASS_HASH      = 0x0E,     // class identified by 64-bit classId hash (8 bytes, little-endian)
 };
 
 typedef uint8_t Tag_t;
@@ -83,6 +86,42 @@ bool writeTag(IErrorHandler* err, IWriter* writer, Tag_t tag) {
     return writer->write(err, &tag, sizeof(tag));
 }
 
+template <class IErrorHandler>
+bool writeClassIdHash(IErrorHandler* err, IWriter* writer, reflection::ClassIdHash_t hash) {
+    uint8_t bytes[8];
+
+    for (size_t i = 0; i < sizeof(bytes); i++)
+        bytes[i] = (uint8_t)(hash >> (i * 8));
+
+    return writer->write(err, bytes, sizeof(bytes));
+}
+
+// same 8-byte encoding as class id hashes
+template <class IErrorHandler>
+bool writeFingerprint(IErrorHandler* err, IWriter* writer, reflection::Fingerprint_t fingerprint) {
+    return writeClassIdHash(err, writer, fingerprint);
+}
+
+template <class IErrorHandler>
+bool readClassIdHash(IErrorHandler* err, IReader* reader, reflection::ClassIdHash_t& hash_out) {
+    uint8_t bytes[8];
+
+    if (!reader->read(err, bytes, sizeof(bytes)))
+        return false;
+
+    hash_out = 0;
+
+    for (size_t i = 0; i < sizeof(bytes); i++)
+        hash_out |= (reflection::ClassIdHash_t) bytes[i] << (i * 8);
+
+    return true;
+}
+
+template <class IErrorHandler>
+bool readFingerprint(IErrorHandler* err, IReader* reader, reflection::Fingerprint_t& fingerprint_out) {
+    return readClassIdHash(err, reader, fingerprint_out);
+}
+
 template <>
 class Serializer<bool> {
 public:
@@ -125,11 +164,11 @@ public:
     enum { TAG = tag };
 
     static bool serialize(IErrorHandler* err, IWriter* writer, const T& value) {
-        return writer->write(err, &value, 1);
+        return writer->write(err, &value, sizeof(T));
     }
 
     static bool deserialize(IErrorHandler* err, IReader* reader, T& value_out) {
-        return reader->read(err, &value_out, 1);
+        return reader->read(err, &value_out, sizeof(T));
     }
 };
 
@@ -212,6 +251,31 @@ public:
         }
     }
 
+    // same encoding, decoded straight from memory; false if the value runs past end
+    static bool decodeValue(const uint8_t*& p, const uint8_t* end, T& value_out) {
+        uint64_t magnitude = 0;
+        unsigned int shift = 0;
+
+        while (p < end) {
+            const uint8_t byte = *p++;
+
+            if (byte & 0x80) {
+                magnitude |= (uint64_t) (byte & 0x7f) << shift;
+                shift += 7;
+
+                if (shift >= 64)
+                    return false;
+            }
+            else {
+                magnitude |= (uint64_t) (byte & 0x3f) << shift;
+                value_out = (byte & 0x40) ? 1 + (T) ~magnitude : (T) magnitude;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     static bool serialize(IErrorHandler* err, IWriter* writer, const T& value) {
         return serializeValue(err, writer, value);
     }
@@ -347,6 +411,68 @@ public:
 };
 #endif
 
+// fixed-width profile (see reflectSerializeFixed): arithmetic values in host representation,
+// anything else falls back to its regular Serializer
+template <typename T, bool raw = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+class FixedWidthSerializer {
+public:
+    static bool serialize(IErrorHandler* err, IWriter* writer, const T& value) {
+        return Serializer<T>::serialize(err, writer, value);
+    }
+
+    static bool deserialize(IErrorHandler* err, IReader* reader, T& value_out) {
+        return Serializer<T>::deserialize(err, reader, value_out);
+    }
+};
+
+template <typename T>
+class FixedWidthSerializer<T, true> {
+public:
+    static bool serialize(IErrorHandler* err, IWriter* writer, const T& value) {
+        return writer->write(err, &value, sizeof(T));
+    }
+
+    static bool deserialize(IErrorHandler* err, IReader* reader, T& value_out) {
+        return reader->read(err, &value_out, sizeof(T));
+    }
+};
+
+#ifndef REFLECTOR_AVOID_STL
+// vectors of arithmetic values are a single block
+template <typename T>
+class FixedWidthSerializer<std::vector<T>, false> {
+public:
+    enum { RAW = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value };
+
+    static bool serialize(IErrorHandler* err, IWriter* writer, const std::vector<T>& value) {
+        if (!RAW)
+            return Serializer<std::vector<T>>::serialize(err, writer, value);
+
+        size_t length = value.size();
+
+        return SmvIntSerializer<size_t>::serializeValue(err, writer, length)
+                && (length == 0 || writer->write(err, value.data(), length * sizeof(T)));
+    }
+
+    static bool deserialize(IErrorHandler* err, IReader* reader, std::vector<T>& value_out) {
+        if (!RAW)
+            return Serializer<std::vector<T>>::deserialize(err, reader, value_out);
+
+        uint64_t length;
+
+        if (!SmvIntSerializer<uint64_t>::deserializeValue(err, reader, length))
+            return false;
+
+        if (length > SIZE_MAX / sizeof(T))
+            return err->error("LengthOverflow", "Array length is too large."), false;
+
+        value_out.resize((size_t) length);
+
+        return length == 0 || reader->read(err, value_out.data(), (size_t) length * sizeof(T));
+    }
+};
+#endif
+
 template <class C>
 class InstanceSerializer {
 public:
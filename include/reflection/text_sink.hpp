@@ -0,0 +1,111 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "bufstring.hpp"
+#include "base.hpp"
+
+#include <cstdio>
+
+#ifndef REFLECTOR_AVOID_STL
+#include <string>
+#endif
+
+namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
+
+// ITextSink implementations for streaming StringBuilder_t output
+
+class FileTextSink : public ITextSink {
+public:
+    FileTextSink(FILE* file) : file(file) {}
+
+    virtual bool flush(IErrorHandler* err, const char* text, size_t length) override {
+        if (fwrite(text, 1, length, file) != length)
+            return err->error("IOError", "Failed to write to file."), false;
+
+        return true;
+    }
+
+private:
+    FILE* file;
+};
+
+class WriterTextSink : public ITextSink {
+public:
+    WriterTextSink(serialization::IWriter* writer) : writer(writer) {}
+
+    virtual bool flush(IErrorHandler* err, const char* text, size_t length) override {
+        return writer->write(err, text, length);
+    }
+
+private:
+    serialization::IWriter* writer;
+};
+
+// snprintf-like: keeps what fits (always zero-terminated if bufSize > 0) and counts the rest
+class FixedBufferTextSink : public ITextSink {
+public:
+    FixedBufferTextSink(char* buf, size_t bufSize) : buf(buf), bufSize(bufSize), totalLength(0) {
+        if (bufSize > 0)
+            buf[0] = 0;
+    }
+
+    virtual bool flush(IErrorHandler* err, const char* text, size_t length) override {
+        if (totalLength + 1 < bufSize) {
+            const size_t avail = bufSize - 1 - totalLength;
+            const size_t count = (length < avail) ? length : avail;
+
+            memcpy(buf + totalLength, text, count);
+            buf[totalLength + count] = 0;
+        }
+
+        totalLength += length;
+        return true;
+    }
+
+    bool truncated() const { return totalLength + 1 > bufSize; }
+
+    char* buf;
+    size_t bufSize;
+    size_t totalLength;     // length of the untruncated output
+};
+
+#ifndef REFLECTOR_AVOID_STL
+class StdStringTextSink : public ITextSink {
+public:
+    StdStringTextSink(std::string& str) : str(str) {}
+
+    virtual bool flush(IErrorHandler* err, const char* text, size_t length) override {
+        str.append(text, length);
+        return true;
+    }
+
+private:
+    std::string& str;
+};
+#endif
+}
@@ -27,6 +27,7 @@
 #pragma once
 
 #include "magic.hpp"
+#include "numeric.hpp"
 #include "serialization_manager.hpp"
 #include "serializer.hpp"
 
@@ -54,6 +55,14 @@ public:\
         type_& value = *reinterpret_cast<type_*>(p_value);\
         return serialization::SerializationManager<type_>::deserialize(err, reader, value);\
     }\
+    virtual bool serializeFixed(IErrorHandler* err, serialization::IWriter* writer, const void* p_value)  override {\
+        type_ const& value = *reinterpret_cast<type_ const*>(p_value);\
+        return serialization::SerializationManager<type_>::serializeFixed(err, writer, value);\
+    }\
+    virtual bool deserializeFixed(IErrorHandler* err, serialization::IReader* reader, void* p_value) override {\
+        type_& value = *reinterpret_cast<type_*>(p_value);\
+        return serialization::SerializationManager<type_>::deserializeFixed(err, reader, value);\
+    }\
     virtual bool serializeTypeInformation(IErrorHandler* err, serialization::IWriter* writer, const void* p_value)  override {\
         type_ const& value = *reinterpret_cast<type_ const*>(p_value);\
         return serialization::SerializationManager<type_>::serializeTypeInformation(err, writer, value);\
@@ -62,16 +71,19 @@ public:\
         type_& value = *reinterpret_cast<type_*>(p_value);\
         return serialization::SerializationManager<type_>::verifyTypeInformation(err, reader, value);\
     }\
+    virtual Fingerprint_t fingerprint() override {\
+        return fingerprintOfTag(serialization::Serializer<type_>::TAG);\
+    }\
 \
     virtual bool setFromString(IErrorHandler* err, const char* str, size_t strLen,\
             void* p_value) override {\
         type_& value = *reinterpret_cast<type_*>(p_value);\
         return template_::fromString(err, str, strLen, value);\
     }\
-    virtual bool toString(IErrorHandler* err, char*& buf, size_t& bufSize, uint32_t fieldMask,\
+    virtual bool toString(IErrorHandler* err, StringBuilder_t& out, uint32_t fieldMask,\
             const void* p_value) override {\
         type_ const& value = *reinterpret_cast<type_ const*>(p_value);\
-        return template_::toString(err, buf, bufSize, value);\
+        return template_::toString(err, out, value);\
     }\
 };\
 
@@ -112,42 +124,28 @@ namespace reflection {  // UUID('c3549467-1615-4087-9829-176a2dc44b76')
 template <typename Bool_t>
 class BoolReflectionTemplate {
 public:
-    static int strcasecmp(const char* a, const char* b) {
-        int diff = tolower(*a) - tolower(*b);
-
-        while (*a && *b && diff == 0) {
-            diff = tolower(*a) - tolower(*b);
-            a++;
-            b++;
-        }
-
-        return diff;
-    }
-
     static bool fromString(IErrorHandler* err, const char* str, size_t strLen, Bool_t& value_out) {
-        char* end;
-
-        if (strcasecmp(str, "true") == 0) {
+        if (numeric::equalsIgnoreCase(str, strLen, "true", 4)) {
             value_out = true;
             return true;
         }
-        else if (strcasecmp(str, "false") == 0) {
+        else if (numeric::equalsIgnoreCase(str, strLen, "false", 5)) {
             value_out = false;
             return true;
         }
 
-        long asLong = strtol(str, &end, 0);
+        long long asInteger = 1;    // left untouched (non-zero) on overflow
 
-        if (*end != 0)
+        if (parseInteger(str, strLen, asInteger) == PARSE_INVALID)
             return err->error("BooleanFormatError", "Specified value is not a valid boolean."), false;
 
-        value_out = (asLong != 0);
+        value_out = (asInteger != 0);
         return true;
     }
 
-    static bool toString(IErrorHandler* err, char*& buf, size_t& bufSize, const Bool_t& value) {
-        return value ? bufStringSet(err, buf, bufSize, "true", 4)
-                : bufStringSet(err, buf, bufSize, "false", 5);
+    static bool toString(IErrorHandler* err, StringBuilder_t& out, const Bool_t& value) {
+        return value ? stringBuilderAppend(err, out, "true", 4)
+                : stringBuilderAppend(err, out, "false", 5);
     }
 };
 
@@ -157,46 +155,20 @@ public:
     typedef typename std::numeric_limits<Int_t> Limits;
 
     static bool fromString(IErrorHandler* err, const char* str, size_t strLen, Int_t& value_out) {
-        if (Limits::is_signed) {
-            char* end;
-            long asLong = strtol(str, &end, 0); // FIXME: actually check for overflow
-
-            if (*end != 0)
-                return err->error("IntegerFormatError", "Specified value is not a valid integer."), false;
-
-            if (asLong < (long) Limits::min() || asLong > (long) Limits::max())
-                return err->error("IntegerOverflow", "Value is outside the limit for this type."), false;
-
-            value_out = (Int_t) asLong;
-            return true;
-        }
-        else {
-            char* end;
-            unsigned long asULong = strtoul(str, &end, 0);  // FIXME: actually check for overflow
-
-            if (*end != 0)
-                return err->error("IntegerFormatError", "Specified value is not a valid integer."), false;
-
-            if (asULong < (unsigned long) Limits::min() || asULong > (unsigned long) Limits::max())
-                return err->error("IntegerOverflow", "Value is outside the limit for this type."), false;
-
-            value_out = (Int_t) asULong;
-            return true;
+        switch (parseInteger(str, strLen, value_out)) {
+            case PARSE_OK: return true;
+            case PARSE_OVERFLOW: return err->error("IntegerOverflow", "Value is outside the limit for this type."), false;
+            default: return err->error("IntegerFormatError", "Specified value is not a valid integer."), false;
         }
     }
 
-    static bool toString(IErrorHandler* err, char*& buf, size_t& bufSize, const Int_t& value) {
-#ifdef _MSC_VER
-        if (Limits::is_signed)
-            return bufStringPrintf(err, buf, bufSize, "%I64d", (int64_t) value);
-        else
-            return bufStringPrintf(err, buf, bufSize, "%I64u", (uint64_t) value);
-#else
-        if (Limits::is_signed)
-            return bufStringPrintf(err, buf, bufSize, "%lld", (long long) value);
-        else
-            return bufStringPrintf(err, buf, bufSize, "%llu", (unsigned long long) value);
-#endif
+    static bool toString(IErrorHandler* err, StringBuilder_t& out, const Int_t& value) {
+        if (!stringBuilderReserve(err, out, MAX_INTEGER_CHARS))
+            return false;
+
+        out.length += formatInteger(out.buf + out.length, value);
+        out.buf[out.length] = 0;
+        return true;
     }
 };
 
@@ -204,18 +176,20 @@ template <typename Float_t>
 class FloatReflectionTemplate {
 public:
     static bool fromString(IErrorHandler* err, const char* str, size_t strLen, Float_t& value_out) {
-        char* end;
-        double asDouble = strtod(str, &end);
+        switch (parseFloat(str, strLen, value_out)) {
+            case PARSE_OK: return true;
+            case PARSE_OVERFLOW: return err->error("FloatOverflow", "Value is outside the limit for this type."), false;
+            default: return err->error("FloatFormatError", "Specified value is not a valid decimal value."), false;
+        }
+    }
 
-        if (*end != 0)
-            return err->error("FloatFormatError", "Specified value is not a valid decimal value."), false;
+    static bool toString(IErrorHandler* err, StringBuilder_t& out, const Float_t& value) {
+        if (!stringBuilderReserve(err, out, MAX_FLOAT_CHARS))
+            return false;
 
-        value_out = (Float_t) asDouble;
+        out.length += formatFloat(out.buf + out.length, value);
+        out.buf[out.length] = 0;
         return true;
     }
-
-    static bool toString(IErrorHandler* err, char*& buf, size_t& bufSize, const Float_t& value) {
-        return bufStringPrintf(err, buf, bufSize, "%g", (double) value);
-    }
 };
 }
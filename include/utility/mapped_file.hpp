@@ -0,0 +1,131 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <reflection/base.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utility {
+// read-only view of a whole file; the mapping lives until close() or destruction
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), size(0) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator =(const MappedFile& other) = delete;
+
+    bool open(reflection::IErrorHandler* err, const char* path) {
+        close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            return err->errorf("IOError", "Failed to open `%s`.", path), false;
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return err->errorf("IOError", "Failed to stat `%s`.", path), false;
+        }
+
+        if (fileSize.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* view = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+            if (mapping != nullptr)
+                CloseHandle(mapping);
+
+            if (view == nullptr) {
+                CloseHandle(file);
+                return err->errorf("IOError", "Failed to map `%s`.", path), false;
+            }
+
+            data = (const uint8_t*) view;
+        }
+
+        CloseHandle(file);
+        size = (size_t) fileSize.QuadPart;
+#else
+        int fd = ::open(path, O_RDONLY);
+
+        if (fd < 0)
+            return err->errorf("IOError", "Failed to open `%s`.", path), false;
+
+        struct stat st;
+
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return err->errorf("IOError", "Failed to stat `%s`.", path), false;
+        }
+
+        if (st.st_size > 0) {
+            void* view = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+            if (view == MAP_FAILED) {
+                ::close(fd);
+                return err->errorf("IOError", "Failed to map `%s`.", path), false;
+            }
+
+            data = (const uint8_t*) view;
+        }
+
+        // the mapping keeps the file referenced
+        ::close(fd);
+        size = (size_t) st.st_size;
+#endif
+
+        return true;
+    }
+
+    void close() {
+        if (data != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(data);
+#else
+            munmap((void*) data, size);
+#endif
+        }
+
+        data = nullptr;
+        size = 0;
+    }
+
+    const uint8_t* data;
+    size_t size;
+};
+}
@@ -43,6 +43,9 @@ def generate_REFL_BEGIN(virtual, extends):
     # classId: static versioned class name
     s += '    static const char* reflection_s_classId(REFL_MATCH_0) { return className_ "," #version_; }\\\n'
 
+    # s_classIdHash: compile-time hash of the versioned class name (compact class identifier)
+    s += '    static constexpr ::reflection::ClassIdHash_t reflection_s_classIdHash(REFL_MATCH_0) { return ::reflection::hashClassId(className_ "," #version_); }\\\n'
+
     # s_className: static class name (used when we have the type, but not the instance)
     s += '    static const char* reflection_s_className(REFL_MATCH_0) { return className_; }\\\n'
 
@@ -52,6 +55,9 @@ def generate_REFL_BEGIN(virtual, extends):
     # classId: get versioned class name - resolved at runtime
     s += '   %s const char* reflection_classId(REFL_MATCH_0) const { return className_ "," #version_; }\\\n' % virtualPrefix
 
+    # classIdHash: get hash of versioned class name - resolved at runtime
+    s += '   %s ::reflection::ClassIdHash_t reflection_classIdHash(REFL_MATCH_0) const { return ::reflection::hashClassId(className_ "," #version_); }\\\n' % virtualPrefix
+
     # className: get displayable class name - resolved at runtime
     s += '   %s const char* reflection_className(REFL_MATCH_0) const { return className_; }\\\n' % virtualPrefix
 
@@ -71,7 +77,6 @@ def generate_REFL_BEGIN(virtual, extends):
     s += '    template <class ThisClass>\\\n'
     s += '    static ::reflection::FieldSet_t const* reflection_s_getFields(REFL_MATCH_0) {\\\n'
     s += '        const char* thisClassName = className_;\\\n'
-    s += '        thisClassName = thisClassName;\\\n'   # warnings about variable being unused
 
     if not extends:
         s += '        ::reflection::FieldSet_t const* baseClassFields = nullptr;\\\n'
@@ -80,7 +85,37 @@ def generate_REFL_BEGIN(virtual, extends):
         s += '        ::reflection::FieldSet_t const* baseClassFields = baseClass_::reflection_s_getFields<baseClass_>(REFL_MATCH);\\\n'
         s += '        void* (*derivedPtrToBasePtr)(void*) = &::reflection::derivedPtrToBasePtr<ThisClass, baseClass_>;\\\n'
 
-    s += '        static ::reflection::Field_t const fields[] = {\\\n'
+    s += '        static ::reflection::FieldSet_t const fieldSet = ::reflection::makeFieldSet<ThisClass>(thisClassName, baseClassFields, derivedPtrToBasePtr);\\\n'
+    s += '        return &fieldSet;\\\n'
+    s += '    }\\\n'
+
+    # visit: pass every field (including base classes) with its actual type to a visitor
+    s += '    template <class Visitor>\\\n'
+    s += '    void reflection_visit(Visitor& visitor) {\\\n'
+    s += '        typedef std::remove_reference<decltype(*this)>::type ThisClass;\\\n'
+    s += '        reflection_s_visit<ThisClass>(*this, visitor);\\\n'
+    s += '    }\\\n'
+    s += '    template <class Visitor>\\\n'
+    s += '    void reflection_visit(Visitor& visitor) const {\\\n'
+    s += '        typedef std::remove_const<std::remove_reference<decltype(*this)>::type>::type ThisClass;\\\n'
+    s += '        reflection_s_visit<ThisClass>(*this, visitor);\\\n'
+    s += '    }\\\n'
+
+    # s_visit: visit fields of an instance of ThisClass, then those of the base class
+    s += '    template <class ThisClass, class Inst, class Visitor>\\\n'
+    s += '    static void reflection_s_visit(Inst& inst, Visitor& visitor) {\\\n'
+    s += '        ::reflection::InstanceFieldVisitor<Inst, Visitor> instanceVisitor(inst, visitor);\\\n'
+    s += '        reflection_s_forEachField<ThisClass>(instanceVisitor);\\\n'
+
+    if extends:
+        s += '        typedef typename std::conditional<std::is_const<Inst>::value, const baseClass_, baseClass_>::type Base;\\\n'
+        s += '        baseClass_::template reflection_s_visit<baseClass_>(static_cast<Base&>(inst), visitor);\\\n'
+
+    s += '    }\\\n'
+
+    # s_forEachField: the field list itself (REFL_FIELD, ... REFL_END), instantiated for each kind of visitor
+    s += '    template <class ThisClass, class Visitor>\\\n'
+    s += '    static void reflection_s_forEachField(Visitor& reflection_v) {\\\n'
     s += '\n'
     '''
     simpleName = 'REFL_SIMPLE' + nameSuffix
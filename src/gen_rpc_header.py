@@ -24,6 +24,8 @@
     DEALINGS IN THE SOFTWARE.
 '''
 
+import sys
+
 MAX_ARGS = 10
 
 def generate_rpcCall(num_args, void):
@@ -62,7 +64,7 @@ def generate_rpcCall(num_args, void):
     print()
 
 def generate_rpcSerializedCall(num_args, void):
-    template_args = ', '.join(['const char* functionName']
+    template_args = ', '.join(['const char* functionName', 'RpcMethodId_t methodId']
         + (['typename Return'] if not void else [])
         + list('typename Arg%d' % i for i in range(0, num_args)))
 
@@ -77,7 +79,7 @@ def generate_rpcSerializedCall(num_args, void):
     print('    IWriter* writer;')
     print('    IReader* reader;')
     print()
-    print('    assert(beginRPC(functionName, ' + ('true' if not void else 'false') + ', writer, reader));')
+    print('    assert(beginRPC(functionName, methodId, ' + ('true' if not void else 'false') + ', writer, reader));')
     print()
 
     for i in range(0, num_args):
@@ -99,6 +101,46 @@ def generate_rpcSerializedCall(num_args, void):
     print('}')
     print()
 
+def generate_rpcChannelCall(num_args, void):
+    template_args = ', '.join(['const char* functionName', 'RpcMethodId_t methodId']
+        + (['typename Return'] if not void else [])
+        + list('typename Arg%d' % i for i in range(0, num_args)))
+
+    print('template <' + template_args + '>')
+
+    if not void:
+        print('Return rpcChannelCall(')
+    else:
+        print('void rpcChannelCallVoid(')
+
+    print('        ' + ', '.join(['IRpcChannel& channel']
+            + list('Arg%d const& arg%d' % (i, i) for i in range(0, num_args))) + ') {')
+    print('    IWriter* writer;')
+    print('    IReader* reader;')
+    print()
+    print('    if (!channel.beginCall(functionName, methodId, ' + ('true' if not void else 'false') + ', writer, reader))')
+    print('        throw RpcCallFailed();')
+    print()
+
+    for i in range(0, num_args):
+        print('    if (!reflectSerialize(arg%d, writer)) failRpcChannelCall(channel);' % i)
+        if i + 1 == num_args: print()
+
+    print('    if (!channel.invokeCall()) failRpcChannelCall(channel);')
+    print()
+
+    if not void:
+        print('    Return result;')
+        print('    if (!reflectDeserialize(result, reader)) failRpcChannelCall(channel);')
+        print()
+        print('    channel.endCall();')
+        print('    return result;')
+    else:
+        print('    channel.endCall();')
+
+    print('}')
+    print()
+
 def generate_rpcExecute(num_args, void):
     if not void:
         template_args = ['class Handler', 'typename Return']
@@ -239,13 +281,13 @@ def generate_getRpcCall(num_args, void):
 
 def generate_getRpcSerializedCall(num_args, void):
     if not void:
-        template_args = ['const char* functionName', 'typename Return']
-        template_arg_list = ['functionName', 'Return']
+        template_args = ['const char* functionName', 'RpcMethodId_t methodId', 'typename Return']
+        template_arg_list = ['functionName', 'methodId', 'Return']
         returnType = 'Return'
         makeFunctionPointer = "MakeFunctionPointer"
     else:
-        template_args = ['const char* functionName']
-        template_arg_list = ['functionName']
+        template_args = ['const char* functionName', 'RpcMethodId_t methodId']
+        template_arg_list = ['functionName', 'methodId']
         returnType = 'void'
         makeFunctionPointer = "MakeFunctionPointerVoid"
 
@@ -290,6 +332,50 @@ def generate_getRpcSerializedCall(num_args, void):
         print('}')
         print()
 
+def generate_getRpcChannelCall(num_args, void):
+    if not void:
+        template_args = ['const char* functionName', 'RpcMethodId_t methodId', 'typename Return']
+        template_arg_list = ['functionName', 'methodId', 'Return']
+        returnType = 'Return'
+        makeFunctionPointer = "MakeChannelFunctionPointer"
+    else:
+        template_args = ['const char* functionName', 'RpcMethodId_t methodId']
+        template_arg_list = ['functionName', 'methodId']
+        returnType = 'void'
+        makeFunctionPointer = "MakeChannelFunctionPointerVoid"
+
+    template_args = ', '.join(template_args +
+        list('typename Arg%d' % i for i in range(0, num_args)) +
+        [])
+
+    template_arg_list = ', '.join(template_arg_list +
+        list('Arg%d' % i for i in range(0, num_args)) +
+        [])
+
+    arg_types = ', '.join('Arg%d' % i for i in range(0, num_args))
+    func_variable = returnType + ' (*functionNull)(' + arg_types + ')'
+
+    mfp_template_args = (['typename Return'] if not void else []) + list('typename Arg%d' % i for i in range(0, num_args))
+    if mfp_template_args: print('template <' + ', '.join(mfp_template_args) + '>')
+    print('struct ' + makeFunctionPointer + '%d {' % num_args)
+    print('    typedef ' + returnType + ' (*type)(' + ', '.join(['IRpcChannel&'] + ['Arg%d const&' % i for i in range(0, num_args)]) + ');')
+    print('};')
+    print()
+
+    print('template <' + template_args + '>')
+
+    mfp_template_args = (['Return'] if not void else []) + list('Arg%d' % i for i in range(0, num_args))
+    if mfp_template_args:
+        print(('RPC_CONSTEXPR_FUNC typename ' + makeFunctionPointer + '%d<' % num_args) +
+            ', '.join(mfp_template_args) +
+            '>::type getRpcChannelCall(' + func_variable + ') {')
+    else:
+        print(('RPC_CONSTEXPR_FUNC typename ' + makeFunctionPointer + '%d' % num_args) +
+            '::type getRpcChannelCall(' + func_variable + ') {')
+    print('    return &' + ('rpcChannelCall<' if not void else 'rpcChannelCallVoid<') + template_arg_list + '>;')
+    print('}')
+    print()
+
 def generate_getRpcExecute(num_args, void):
     if not void:
         template_args = ['typename Function', 'Function func', 'class Handler', 'typename Return']
@@ -350,6 +436,103 @@ def generate_getRpcSerializedExecute(num_args, void):
     print('}')
     print()
 
+# Return may be void for the asynchronous calls, so they need no separate void variants
+
+def generate_rpcAsyncCall(num_args):
+    template_args = ', '.join(['const char* functionName', 'RpcMethodId_t methodId', 'typename Return']
+        + list('typename Arg%d' % i for i in range(0, num_args)))
+
+    print('template <' + template_args + '>')
+    print('bool rpcAsyncCall(')
+    print('        ' + ', '.join(['IAsyncRpcChannel& channel', 'IRpcCompletion* completion']
+            + list('Arg%d const& arg%d' % (i, i) for i in range(0, num_args))) + ') {')
+    print('    IWriter* writer;')
+    print()
+    print('    if (!channel.beginAsyncCall(functionName, methodId, !std::is_void<Return>::value, writer))')
+    print('        return false;')
+    print()
+
+    if num_args > 0:
+        print('    if (' + '\n            || '.join('!reflectSerialize(arg%d, writer)' % i for i in range(0, num_args)) + ') {')
+        print('        channel.cancelAsyncCall();')
+        print('        return false;')
+        print('    }')
+        print()
+
+    print('    return channel.submitAsyncCall(completion);')
+    print('}')
+    print()
+
+def generate_rpcFutureCall(num_args):
+    template_args = ', '.join(['const char* functionName', 'RpcMethodId_t methodId', 'typename Return']
+        + list('typename Arg%d' % i for i in range(0, num_args)))
+
+    template_arg_list = ', '.join(['functionName', 'methodId', 'Return']
+        + list('Arg%d' % i for i in range(0, num_args)))
+
+    print('template <' + template_args + '>')
+    print('std::future<Return> rpcFutureCall(')
+    print('        ' + ', '.join(['IAsyncRpcChannel& channel']
+            + list('Arg%d const& arg%d' % (i, i) for i in range(0, num_args))) + ') {')
+    print('    auto completion = new FutureCompletion_<Return>();')
+    print('    std::future<Return> future = completion->promise.get_future();')
+    print()
+    print('    if (!rpcAsyncCall<' + template_arg_list + '>(' + ', '.join(['channel', 'completion']
+            + list('arg%d' % i for i in range(0, num_args))) + '))')
+    print('        completion->complete(err, nullptr);')
+    print()
+    print('    return future;')
+    print('}')
+    print()
+
+def generate_getRpcAsyncCall(num_args, future):
+    makeFunctionPointer = 'MakeFutureFunctionPointer' if future else 'MakeAsyncFunctionPointer'
+    getter = 'getRpcFutureCall' if future else 'getRpcAsyncCall'
+    call = 'rpcFutureCall' if future else 'rpcAsyncCall'
+    returnType = 'std::future<Return>' if future else 'bool'
+    params = ['IAsyncRpcChannel&'] + ([] if future else ['IRpcCompletion*'])
+
+    template_args = ', '.join(['const char* functionName', 'RpcMethodId_t methodId', 'typename Return']
+        + list('typename Arg%d' % i for i in range(0, num_args)))
+
+    template_arg_list = ', '.join(['functionName', 'methodId', 'Return']
+        + list('Arg%d' % i for i in range(0, num_args)))
+
+    arg_types = ', '.join('Arg%d' % i for i in range(0, num_args))
+    func_variable = 'Return (*functionNull)(' + arg_types + ')'
+
+    print('template <' + ', '.join(['typename Return'] + list('typename Arg%d' % i for i in range(0, num_args))) + '>')
+    print('struct ' + makeFunctionPointer + '%d {' % num_args)
+    print('    typedef ' + returnType + ' (*type)(' + ', '.join(params + ['Arg%d const&' % i for i in range(0, num_args)]) + ');')
+    print('};')
+    print()
+
+    print('template <' + template_args + '>')
+    print(('RPC_CONSTEXPR_FUNC typename ' + makeFunctionPointer + '%d<' % num_args) +
+        ', '.join(['Return'] + list('Arg%d' % i for i in range(0, num_args))) +
+        '>::type ' + getter + '(' + func_variable + ') {')
+    print('    return &' + call + '<' + template_arg_list + '>;')
+    print('}')
+    print()
+
+if len(sys.argv) > 1 and sys.argv[1] == '--async':
+    print('#pragma once')
+    print()
+    print('// Generated by gen_rpc_header.py --async')
+    print()
+
+    print('namespace rpc {')
+    print()
+
+    for num_args in range(0, MAX_ARGS + 1):
+        generate_rpcAsyncCall(num_args)
+        generate_rpcFutureCall(num_args)
+        generate_getRpcAsyncCall(num_args, False)
+        generate_getRpcAsyncCall(num_args, True)
+
+    print('}')
+    sys.exit(0)
+
 print('#pragma once')
 print()
 print('// Generated by gen_rpc_header.py')
@@ -364,10 +547,12 @@ for num_args in range(0, MAX_ARGS + 1):
     for void in [False, True]:
         generate_rpcCall(num_args, void)
         generate_rpcSerializedCall(num_args, void)
+        generate_rpcChannelCall(num_args, void)
         generate_rpcExecute(num_args, void)
         generate_rpcSerializedExecute(num_args, void)
         generate_getRpcCall(num_args, void)
         generate_getRpcSerializedCall(num_args, void)
+        generate_getRpcChannelCall(num_args, void)
         generate_getRpcExecute(num_args, void)
         generate_getRpcSerializedExecute(num_args, void)
 
@@ -0,0 +1,177 @@
+/*
+    Boost Software License - Version 1.0 - August 17, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <extras/argument_parsing.hpp>
+#include <extras/record_query.hpp>
+
+#include <reflection/basic_types.hpp>
+#include <reflection/schema_bundle.hpp>
+
+#include <utility/file_reader_writer.hpp>
+#include <utility/mapped_file.hpp>
+
+#include <chrono>
+#include <string>
+
+// Filters and projects record files using their class schemas, e.g.
+//
+//   reflector_query packets.records -b schemas.schema_bundle -w "length > 1000" -s name,length
+
+typedef std::string String;
+
+class SchemaFileReader final : public utility::FileReaderWriter {
+public:
+    SchemaFileReader(FILE* file) : utility::FileReaderWriter(file), file(file) {}
+    ~SchemaFileReader() { fclose(file); }
+
+private:
+    FILE* file;
+};
+
+// <directory>/<classId>.class_schema, as written by InstanceSerializer::serializeSchema
+class DirectorySchemaProvider : public reflection::ISchemaProvider {
+public:
+    DirectorySchemaProvider(const String& directory) : directory(directory) {}
+
+    virtual serialization::IReader* openClassSchemaOrNull(const char* classId) override {
+        String path = directory + "/" + classId + ".class_schema";
+        FILE* file = fopen(path.c_str(), "rb");
+
+        if (file == nullptr)
+            return nullptr;
+
+        return new SchemaFileReader(file);
+    }
+
+    virtual void closeClassSchema(serialization::IReader* reader) override {
+        delete static_cast<SchemaFileReader*>(reader);
+    }
+
+private:
+    String directory;
+};
+
+struct QueryCommand {
+    QueryCommand() : schemaDirectory("schemas"), threads(0), count(false), header(false), stats(false) {}
+
+    String fileName;
+    String where;
+    String select;
+    String bundle;
+    String schemaDirectory;
+    int threads;
+    bool count;
+    bool header;
+    bool stats;
+
+    REFL_BEGIN("QueryCommand", 1)
+        ARG_REQUIRED(fileName,      "",     "record file to query")
+        ARG(where,                  "-w",   "filter, e.g. \"length > 1000 && name ~ data\" (operators: == != < <= > >= ~)")
+        ARG(select,                 "-s",   "comma-separated fields to print (all fields if not specified)")
+        ARG(bundle,                 "-b",   "schema bundle to take the schemas from")
+        ARG(schemaDirectory,        "-d",   "directory with .class_schema files, if no bundle is given (default: schemas)")
+        ARG(threads,                "-j",   "number of threads (default: one per core)")
+        ARG(count,                  "-c",   "only print the number of matching records")
+        ARG(header,                 "-H",   "print the names of the selected fields first")
+        ARG(stats,                  "-t",   "print throughput to standard error")
+    REFL_END
+
+    int execute() {
+        utility::MappedFile file;
+        reflection::BufString_t classId;
+        reflection::Fingerprint_t fingerprint;
+        size_t recordsOffset;
+
+        if (!file.open(reflection::err, fileName.c_str())
+                || !reflection::readRecordFileHeader(file.data, file.size, classId, fingerprint, recordsOffset))
+            return -1;
+
+        reflection::SchemaBundle schemaBundle;
+        DirectorySchemaProvider schemaFiles(schemaDirectory);
+        reflection::ISchemaProvider* sp = &schemaFiles;
+
+        if (!bundle.empty()) {
+            if (!schemaBundle.open(bundle.c_str()))
+                return -1;
+
+            sp = &schemaBundle;
+        }
+
+        reflection::SchemaCache cache(sp);
+        record_query::Query query;
+
+        if (!query.compile(cache, classId.buf, where.c_str(), select.c_str()))
+            return -1;
+
+        // a stale schema would decode garbage
+        reflection::Fingerprint_t schemaFingerprint;
+
+        if (fingerprint != 0 && (!cache.fingerprint(cache.get(classId.buf), schemaFingerprint)
+                || schemaFingerprint != fingerprint)) {
+            reflection::err->errorf("LayoutMismatch", "The schema of `%s` doesn't match the layout of the records.",
+                    classId.buf);
+            return -1;
+        }
+
+        reflection::FileTextSink sink(stdout);
+
+        if (header && !count) {
+            char storage[1024];
+            reflection::StringBuilder_t out(storage, sizeof(storage), &sink);
+
+            if (!query.header(out) || !reflection::stringBuilderFlush(reflection::err, out))
+                return -1;
+        }
+
+        const unsigned numThreads = (threads > 0) ? (unsigned) threads : std::thread::hardware_concurrency();
+        record_query::QueryStats_t queryStats;
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (!record_query::runQuery(query, file.data, file.size, recordsOffset, numThreads,
+                count ? nullptr : &sink, queryStats))
+            return -1;
+
+        auto end = std::chrono::steady_clock::now();
+
+        if (count)
+            printf("%llu\n", (unsigned long long) queryStats.matches);
+
+        if (stats) {
+            const double s = std::chrono::duration<double>(end - start).count();
+
+            fprintf(stderr, "%s: %llu of %llu records matched, %.3f GB/s on %u threads\n", classId.buf,
+                    (unsigned long long) queryStats.matches, (unsigned long long) queryStats.records,
+                    queryStats.bytes / s * 1e-9, numThreads);
+        }
+
+        return 0;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    return argument_parsing::singleCommandDispatch<QueryCommand>(argc - 1, argv + 1, "reflector_query");
+}